@@ -0,0 +1,255 @@
+#ifndef SIMPLE_BENCH_H
+#define SIMPLE_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A small benchmark harness in the spirit of test/test.h.
+//
+// Each benchmark is a function that runs `state.iterations` operations. The
+// runner picks an iteration count that makes one repetition last at least
+// --min-time milliseconds, runs --warmup untimed repetitions, then times
+// --reps repetitions and reports ns/op (mean, standard deviation, min, max).
+//
+// Results can be written as JSON with --json and compared against an earlier
+// JSON file with --baseline: any benchmark whose mean is more than
+// --threshold percent slower than the baseline is flagged and makes the run
+// exit non-zero.
+namespace SimpleBench {
+
+struct State {
+    uint64_t iterations;
+};
+
+// keeps the compiler from discarding a result the benchmark never uses
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+};
+
+struct Options {
+    std::string filter;
+    int reps = 10;
+    int warmup = 2;
+    double minTimeMs = 20.0;
+    std::string jsonPath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+};
+
+class BenchRegistry {
+public:
+    static BenchRegistry& instance() {
+        static BenchRegistry reg;
+        return reg;
+    }
+
+    void add(const std::string& name, std::function<void(State&)> func) {
+        benchmarks.push_back({name, func});
+    }
+
+    int run(int argc, char* argv[]) {
+        Options options;
+        if (!parse(argc, argv, options)) {
+            std::cerr << "usage: " << argv[0] << " [--filter text] [--reps n] [--warmup n] [--min-time ms]"
+                      << " [--json out.json] [--baseline base.json] [--threshold percent]" << std::endl;
+            return 2;
+        }
+
+        std::vector<Result> results;
+        std::cout << std::left << std::setw(36) << "benchmark" << std::right << std::setw(12) << "ns/op"
+                  << std::setw(10) << "+/-" << std::setw(12) << "min" << std::setw(12) << "max" << "\n";
+        for (const auto& bench : benchmarks) {
+            if (!options.filter.empty() && bench.first.find(options.filter) == std::string::npos) {
+                continue;
+            }
+            Result result = measure(bench.first, bench.second, options);
+            std::cout << std::left << std::setw(36) << result.name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << result.mean << std::setw(10) << result.stddev << std::setw(12) << result.min
+                      << std::setw(12) << result.max << "\n";
+            results.push_back(result);
+        }
+
+        if (!options.jsonPath.empty()) {
+            writeJson(options.jsonPath, results);
+        }
+        int regressions = 0;
+        if (!options.baselinePath.empty()) {
+            regressions = compare(options.baselinePath, results, options.thresholdPercent);
+        }
+        return regressions == 0 ? 0 : 1;
+    }
+
+private:
+    std::vector<std::pair<std::string, std::function<void(State&)>>> benchmarks;
+
+    static bool parse(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            std::string value = argv[++i];
+            if (argument == "--filter") {
+                options.filter = value;
+            } else if (argument == "--reps") {
+                options.reps = std::max(2, std::stoi(value));
+            } else if (argument == "--warmup") {
+                options.warmup = std::max(0, std::stoi(value));
+            } else if (argument == "--min-time") {
+                options.minTimeMs = std::stod(value);
+            } else if (argument == "--json") {
+                options.jsonPath = value;
+            } else if (argument == "--baseline") {
+                options.baselinePath = value;
+            } else if (argument == "--threshold") {
+                options.thresholdPercent = std::stod(value);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static double timeOnce(const std::function<void(State&)>& func, uint64_t iterations) {
+        State state{iterations};
+        auto start = std::chrono::steady_clock::now();
+        func(state);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    static Result measure(const std::string& name, const std::function<void(State&)>& func, const Options& options) {
+        // grow the iteration count until one repetition is long enough to time reliably
+        uint64_t iterations = 1;
+        double elapsed = timeOnce(func, iterations);
+        while (elapsed < options.minTimeMs * 1e6 && iterations < (1ULL << 40)) {
+            double scale = elapsed > 0 ? options.minTimeMs * 1e6 / elapsed : 10.0;
+            iterations = static_cast<uint64_t>(iterations * std::min(10.0, std::max(1.5, scale * 1.1)));
+            elapsed = timeOnce(func, iterations);
+        }
+        for (int i = 0; i < options.warmup; ++i) {
+            timeOnce(func, iterations);
+        }
+
+        std::vector<double> samples;
+        for (int i = 0; i < options.reps; ++i) {
+            samples.push_back(timeOnce(func, iterations) / iterations);
+        }
+        double mean = 0;
+        for (double sample : samples) {
+            mean += sample;
+        }
+        mean /= samples.size();
+        double variance = 0;
+        for (double sample : samples) {
+            variance += (sample - mean) * (sample - mean);
+        }
+        variance /= samples.size() - 1;
+        return {name, iterations, mean, std::sqrt(variance), *std::min_element(samples.begin(), samples.end()),
+                *std::max_element(samples.begin(), samples.end())};
+    }
+
+    static void writeJson(const std::string& path, const std::vector<Result>& results) {
+        std::ofstream out(path);
+        out << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations << std::fixed
+                << std::setprecision(3) << ", \"mean_ns\": " << r.mean << ", \"stddev_ns\": " << r.stddev
+                << ", \"min_ns\": " << r.min << ", \"max_ns\": " << r.max << "}" << (i + 1 < results.size() ? "," : "")
+                << "\n";
+        }
+        out << "  ]\n}\n";
+        if (!out) {
+            std::cerr << "cannot write " << path << std::endl;
+        }
+    }
+
+    // reads the name -> mean_ns pairs back out of a file written by writeJson
+    static std::map<std::string, double> readJson(const std::string& path) {
+        std::map<std::string, double> means;
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t name = line.find("\"name\": \"");
+            size_t mean = line.find("\"mean_ns\": ");
+            if (name == std::string::npos || mean == std::string::npos) {
+                continue;
+            }
+            name += 9;
+            means[line.substr(name, line.find('"', name) - name)] = std::stod(line.substr(mean + 11));
+        }
+        return means;
+    }
+
+    static int compare(const std::string& path, const std::vector<Result>& results, double thresholdPercent) {
+        const std::string red = "\033[31m";
+        const std::string green = "\033[32m";
+        const std::string reset = "\033[0m";
+        std::map<std::string, double> baseline = readJson(path);
+        if (baseline.empty()) {
+            std::cerr << "no baseline results in " << path << std::endl;
+            return 1;
+        }
+
+        int regressions = 0;
+        std::cout << std::defaultfloat << "\n=== Baseline Comparison (" << path << ", threshold " << thresholdPercent << "%) ===\n";
+        for (const Result& result : results) {
+            auto base = baseline.find(result.name);
+            if (base == baseline.end()) {
+                std::cout << std::left << std::setw(36) << result.name << " new\n";
+                continue;
+            }
+            double change = (result.mean - base->second) / base->second * 100.0;
+            bool regressed = change > thresholdPercent;
+            regressions += regressed;
+            std::cout << std::left << std::setw(36) << result.name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(8) << std::showpos << change << "%" << std::noshowpos
+                      << (regressed ? red + "  REGRESSION" + reset : change < -thresholdPercent ? green + "  faster" + reset : "")
+                      << "\n";
+        }
+        std::cout << regressions << " regressions\n";
+        return regressions;
+    }
+};
+
+class BenchRegistrar {
+public:
+    BenchRegistrar(const std::string& name, std::function<void(State&)> func) {
+        BenchRegistry::instance().add(name, func);
+    }
+};
+
+} // namespace SimpleBench
+
+// Defines a benchmark; the body runs `state.iterations` operations.
+#define BENCH(name) \
+    void bench_##name(SimpleBench::State& state); \
+    static SimpleBench::BenchRegistrar bench_registrar_##name(#name, bench_##name); \
+    void bench_##name(SimpleBench::State& state)
+
+#define RUN_ALL_BENCHMARKS(argc, argv) \
+    SimpleBench::BenchRegistry::instance().run(argc, argv)
+
+#endif // SIMPLE_BENCH_H
@@ -0,0 +1,5 @@
+#include "bench.h"
+int main(int argc, char* argv[])
+{
+    return RUN_ALL_BENCHMARKS(argc, argv);
+}
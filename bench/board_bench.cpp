@@ -0,0 +1,147 @@
+#include "bench.h"
+#include "chess.hpp"
+#include "board/batch.hpp"
+#include "eval/planes.hpp"
+
+// Fixed position corpus: the standard perft positions plus a couple of endgames,
+// so every run times the same work.
+static const std::vector<std::string>& corpus() {
+    static const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - -",
+        "8/8/4k3/8/2p5/8/B2K4/8 w - -",
+        "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - -",
+    };
+    return fens;
+}
+static std::vector<Board> corpusBoards() {
+    std::vector<Board> boards;
+    for (const std::string& fen : corpus()) {
+        boards.emplace_back(fen);
+    }
+    return boards;
+}
+// every square name, so the string-based lookups get realistic input
+static const std::vector<std::string>& squareNames() {
+    static const std::vector<std::string> names = []() {
+        std::vector<std::string> result;
+        for (int square = 0; square < 64; ++square) {
+            result.push_back({static_cast<char>('a' + square % 8), static_cast<char>('1' + square / 8)});
+        }
+        return result;
+    }();
+    return names;
+}
+
+BENCH(board_default_constructor) {
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        Board board;
+        SimpleBench::doNotOptimize(board);
+    }
+}
+BENCH(board_fen_constructor) {
+    const std::vector<std::string>& fens = corpus();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        Board board(fens[i % fens.size()]);
+        SimpleBench::doNotOptimize(board);
+    }
+}
+BENCH(get_piece_at_position) {
+    std::vector<Board> boards = corpusBoards();
+    const std::vector<std::string>& squares = squareNames();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        SimpleBench::doNotOptimize(boards[(i / 64) % boards.size()].getPieceAtPosition(squares[i % 64]));
+    }
+}
+BENCH(get_bitmask_for_board) {
+    std::vector<Board> boards = corpusBoards();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        SimpleBench::doNotOptimize(boards[i % boards.size()].getBitmaskForBoard());
+    }
+}
+BENCH(get_moves_for_piece_at_position) {
+    // only squares holding a piece of the side to move, which is how callers use it
+    std::vector<Board> boards = corpusBoards();
+    std::vector<std::pair<size_t, std::string>> occupied;
+    for (size_t b = 0; b < boards.size(); ++b) {
+        for (int square = 0; square < 64; ++square) {
+            Board::Piece piece = boards[b].getPieceAtSquare(square);
+            if (piece != Board::EMPTY && (piece < Board::BLACK_PAWN) == boards[b].getTurn()) {
+                occupied.emplace_back(b, squareNames()[square]);
+            }
+        }
+    }
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        const auto& target = occupied[i % occupied.size()];
+        SimpleBench::doNotOptimize(boards[target.first].getMovesForPieceAtPosition(target.second));
+    }
+}
+BENCH(generate_fen) {
+    std::vector<Board> boards = corpusBoards();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        std::string fen = boards[i % boards.size()].generateFEN();
+        SimpleBench::doNotOptimize(fen.data());
+    }
+}
+BENCH(board_to_string) {
+    std::vector<Board> boards = corpusBoards();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        std::string text = boards[i % boards.size()].boardToString();
+        SimpleBench::doNotOptimize(text.data());
+    }
+}
+BENCH(generate_moves) {
+    std::vector<Board> boards = corpusBoards();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        // a fresh copy each time so the cached checkers and pins are recomputed
+        Board board = boards[i % boards.size()];
+        SimpleBench::doNotOptimize(board.generateMoves().count);
+    }
+}
+BENCH(count_moves) {
+    std::vector<Board> boards = corpusBoards();
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        Board board = boards[i % boards.size()];
+        SimpleBench::doNotOptimize(board.countMoves());
+    }
+}
+BENCH(count_moves_batch) {
+    // one op is one board, as in count_moves, counted in blocks of the corpus repeated
+    std::vector<Board> boards;
+    for (int copy = 0; copy < 32; ++copy) {
+        for (const Board& board : corpusBoards()) {
+            boards.push_back(board);
+        }
+    }
+    std::vector<int> counts(boards.size());
+    for (uint64_t i = 0; i < state.iterations; i += boards.size()) {
+        size_t count = std::min<uint64_t>(boards.size(), state.iterations - i);
+        Batch::countMoves(boards.data(), count, counts.data());
+        SimpleBench::doNotOptimize(counts.data());
+    }
+}
+BENCH(validate_move) {
+    std::vector<Board> boards = corpusBoards();
+    std::vector<Board::Move> moves;
+    for (const Board& board : boards) {
+        Board::MoveList legal = board.generateMoves();
+        moves.push_back(legal.size() ? legal[legal.size() / 2] : Board::Move{0, 0});
+    }
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        Board board = boards[i % boards.size()];
+        SimpleBench::doNotOptimize(board.validateMove(moves[i % moves.size()]));
+    }
+}
+BENCH(encode_planes) {
+    // one op is the whole corpus, as a training loader would convert it
+    std::vector<Board> boards = corpusBoards();
+    std::vector<float> planes(boards.size() * Planes::BOARD_VALUES);
+    for (uint64_t i = 0; i < state.iterations; ++i) {
+        Planes::encode(boards.data(), boards.size(), planes.data(), true);
+        SimpleBench::doNotOptimize(planes.data());
+    }
+}
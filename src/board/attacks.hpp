@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Precomputed attack sets for every piece type.
+ *
+ * Squares are indexed 0-63 with a1 = 0 and h8 = 63, matching the layout of the
+ * Board bitboards. Slider attacks take the current occupancy and include the
+ * first blocker in each direction (friendly or not); callers mask out their
+ * own pieces where needed.
+ *
+ * Every table is computed by the compiler and lands in read-only data, so
+ * there is no initialisation pass at startup and the lookups below can be
+ * used in constant expressions.
+ */
+namespace Attacks {
+    // positive directions move towards h8, negative ones towards a1
+    enum Direction {
+        NORTH,
+        EAST,
+        NORTH_EAST,
+        NORTH_WEST,
+        SOUTH,
+        WEST,
+        SOUTH_WEST,
+        SOUTH_EAST
+    };
+
+    struct Tables {
+        uint64_t pawnAttacks[2][64]; // [0] = white, [1] = black
+        uint64_t knightAttacks[64];
+        uint64_t kingAttacks[64];
+        uint64_t rays[8][64];
+        // squares strictly between two squares on a shared line, empty otherwise
+        uint64_t between[64][64];
+        // the whole line through two squares (both included), empty if they do not share one
+        uint64_t line[64][64];
+    };
+
+    // returns the bit for (rank, file), or 0 when it falls off the board
+    constexpr uint64_t squareBit(int rank, int file)
+    {
+        return rank < 0 || rank > 7 || file < 0 || file > 7 ? 0 : 1ULL << (rank * 8 + file);
+    }
+    constexpr Tables makeTables()
+    {
+        Tables tables{};
+        const int knightSteps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+        const int kingSteps[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+        // indexed by Direction as {rank step, file step}
+        const int raySteps[8][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}, {-1, 0}, {0, -1}, {-1, -1}, {-1, 1}};
+
+        for (int square = 0; square < 64; ++square)
+        {
+            int rank = square / 8;
+            int file = square % 8;
+            tables.pawnAttacks[0][square] = squareBit(rank + 1, file - 1) | squareBit(rank + 1, file + 1);
+            tables.pawnAttacks[1][square] = squareBit(rank - 1, file - 1) | squareBit(rank - 1, file + 1);
+            for (int i = 0; i < 8; ++i)
+            {
+                tables.knightAttacks[square] |= squareBit(rank + knightSteps[i][0], file + knightSteps[i][1]);
+                tables.kingAttacks[square] |= squareBit(rank + kingSteps[i][0], file + kingSteps[i][1]);
+            }
+            for (int direction = 0; direction < 8; ++direction)
+            {
+                int r = rank + raySteps[direction][0];
+                int f = file + raySteps[direction][1];
+                for (; squareBit(r, f); r += raySteps[direction][0], f += raySteps[direction][1])
+                {
+                    tables.rays[direction][square] |= squareBit(r, f);
+                }
+            }
+        }
+
+        for (int from = 0; from < 64; ++from)
+        {
+            for (int direction = 0; direction < 8; ++direction)
+            {
+                // walk the ray and record everything passed before each square;
+                // the opposite direction is four entries further along the enum
+                uint64_t fullLine = tables.rays[direction][from] | tables.rays[(direction + 4) % 8][from] | (1ULL << from);
+                uint64_t passed = 0;
+                int r = from / 8 + raySteps[direction][0];
+                int f = from % 8 + raySteps[direction][1];
+                for (; squareBit(r, f); r += raySteps[direction][0], f += raySteps[direction][1])
+                {
+                    tables.between[from][r * 8 + f] = passed;
+                    tables.line[from][r * 8 + f] = fullLine;
+                    passed |= squareBit(r, f);
+                }
+            }
+        }
+        return tables;
+    }
+
+    inline constexpr Tables TABLES = makeTables();
+    inline constexpr const uint64_t (&pawnAttacks)[2][64] = TABLES.pawnAttacks;
+    inline constexpr const uint64_t (&knightAttacks)[64] = TABLES.knightAttacks;
+    inline constexpr const uint64_t (&kingAttacks)[64] = TABLES.kingAttacks;
+    inline constexpr const uint64_t (&rays)[8][64] = TABLES.rays;
+    inline constexpr const uint64_t (&between)[64][64] = TABLES.between;
+    inline constexpr const uint64_t (&line)[64][64] = TABLES.line;
+
+    /**
+     * @brief Returns the squares a slider on `square` reaches in a positive direction.
+     *
+     * rays[d][63] is empty for every positive direction, so OR-ing bit 63 into the
+     * blockers gives a branch-free lookup when the ray is unobstructed.
+     */
+    constexpr uint64_t positiveRay(Direction direction, int square, uint64_t occupancy)
+    {
+        uint64_t blockers = (rays[direction][square] & occupancy) | 0x8000000000000000ULL;
+        return rays[direction][square] ^ rays[direction][__builtin_ctzll(blockers)];
+    }
+    /**
+     * @brief Negative direction counterpart of positiveRay, relying on rays[d][0] being empty.
+     */
+    constexpr uint64_t negativeRay(Direction direction, int square, uint64_t occupancy)
+    {
+        uint64_t blockers = (rays[direction][square] & occupancy) | 1ULL;
+        return rays[direction][square] ^ rays[direction][63 - __builtin_clzll(blockers)];
+    }
+
+    constexpr uint64_t pawn(bool white, int square) { return pawnAttacks[white ? 0 : 1][square]; }
+    constexpr uint64_t knight(int square) { return knightAttacks[square]; }
+    constexpr uint64_t king(int square) { return kingAttacks[square]; }
+    constexpr uint64_t bishop(int square, uint64_t occupancy)
+    {
+        return positiveRay(NORTH_EAST, square, occupancy) | positiveRay(NORTH_WEST, square, occupancy)
+             | negativeRay(SOUTH_WEST, square, occupancy) | negativeRay(SOUTH_EAST, square, occupancy);
+    }
+    constexpr uint64_t rook(int square, uint64_t occupancy)
+    {
+        return positiveRay(NORTH, square, occupancy) | positiveRay(EAST, square, occupancy)
+             | negativeRay(SOUTH, square, occupancy) | negativeRay(WEST, square, occupancy);
+    }
+    constexpr uint64_t queen(int square, uint64_t occupancy)
+    {
+        return bishop(square, occupancy) | rook(square, occupancy);
+    }
+}
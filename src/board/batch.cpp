@@ -0,0 +1,203 @@
+#include "batch.hpp"
+#include <vector>
+#include "batch_kernel.hpp"
+#include "movegen.hpp"
+
+namespace {
+    using namespace BatchKernel;
+
+    // a white pawn on `square` capturing en passant must not leave its king
+    // exposed once both pawns are gone from the rank
+    int countEnPassant(const uint64_t (&pieces)[12], int square)
+    {
+        uint64_t occupancy = 0;
+        for (uint64_t bitboard : pieces)
+        {
+            occupancy |= bitboard;
+        }
+        uint64_t capturedBit = 1ULL << (square - 8);
+        uint64_t king = pieces[Board::WHITE_KING];
+        int count = 0;
+        for (uint64_t capturers = pieces[Board::WHITE_PAWN] & Attacks::pawn(false, square); capturers;
+             capturers &= capturers - 1)
+        {
+            if (!king)
+            {
+                count++;
+                continue;
+            }
+            int kingSquare = __builtin_ctzll(king);
+            uint64_t after = (occupancy ^ (capturers & -capturers) ^ capturedBit) | (1ULL << square);
+            uint64_t diagonal = pieces[Board::BLACK_BISHOP] | pieces[Board::BLACK_QUEEN];
+            uint64_t straight = pieces[Board::BLACK_ROOK] | pieces[Board::BLACK_QUEEN];
+            uint64_t attackers = (Attacks::knight(kingSquare) & pieces[Board::BLACK_KNIGHT])
+                               | (Attacks::pawn(true, kingSquare) & pieces[Board::BLACK_PAWN])
+                               | (Attacks::king(kingSquare) & pieces[Board::BLACK_KING])
+                               | (Attacks::bishop(kingSquare, after) & diagonal)
+                               | (Attacks::rook(kingSquare, after) & straight);
+            if (!(attackers & ~capturedBit))
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    template<int N> void load(Block<N>& block, int lane, const Board& board)
+    {
+        bool white = board.getTurn();
+        uint64_t pieces[12];
+        for (int piece = 0; piece < 12; ++piece)
+        {
+            // black to move: swap the colours and mirror the ranks
+            uint64_t bitboard = board.getBitmaskForPiece(static_cast<Board::Piece>(white ? piece : (piece + 6) % 12));
+            pieces[piece] = white ? bitboard : __builtin_bswap64(bitboard);
+            block.pieces[piece][lane] = pieces[piece];
+        }
+        int rights = board.getCastlingRights();
+        if (!white)
+        {
+            rights = ((rights & 0b0011) << 2) | ((rights >> 2) & 0b0011);
+        }
+        block.castling[lane] = ((rights & 0b1000) ? 1ULL << 6 : 0) | ((rights & 0b0100) ? 1ULL << 2 : 0);
+        int square = board.getEnPassantSquare();
+        block.enPassant[lane] = square >= 0 ? countEnPassant(pieces, white ? square : square ^ 56) : 0;
+    }
+
+    // Queues boards into blocks and adds each count to the slot its board belongs to.
+    template<int N, void (*Count)(const Block<N>&, int*)> class Collector {
+        Block<N> block{};
+        size_t owners[N];
+        int filled = 0;
+        uint64_t* nodes;
+
+        public:
+        explicit Collector(uint64_t* nodes) : nodes(nodes) {}
+        void add(const Board& board, size_t owner)
+        {
+            load(block, filled, board);
+            owners[filled++] = owner;
+            if (filled == N)
+            {
+                flush();
+            }
+        }
+        // lanes past `filled` still hold earlier boards; their counts are ignored
+        void flush()
+        {
+            int counts[N];
+            Count(block, counts);
+            for (int lane = 0; lane < filled; ++lane)
+            {
+                nodes[owners[lane]] += counts[lane];
+            }
+            filled = 0;
+        }
+    };
+
+    template<typename Collector> void walk(Board& board, int depth, size_t owner, Collector& collector)
+    {
+        if (depth == 1)
+        {
+            collector.add(board, owner);
+            return;
+        }
+        Board::MoveList moves = board.generateMoves();
+        for (const Board::Move& move : moves)
+        {
+            Board::UndoInfo undo = board.makeMove(move);
+            walk(board, depth - 1, owner, collector);
+            board.unmakeMove(move, undo);
+        }
+    }
+    template<int N, void (*Count)(const Block<N>&, int*)>
+    void countWith(const Board* boards, size_t count, int* counts)
+    {
+        std::vector<uint64_t> nodes(count, 0);
+        Collector<N, Count> collector(nodes.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+            collector.add(boards[i], i);
+        }
+        collector.flush();
+        for (size_t i = 0; i < count; ++i)
+        {
+            counts[i] = static_cast<int>(nodes[i]);
+        }
+    }
+    template<int N, void (*Count)(const Block<N>&, int*)>
+    void perftWith(const Board* roots, size_t count, int depth, uint64_t* nodes)
+    {
+        Collector<N, Count> collector(nodes);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Board board = roots[i];
+            walk(board, depth, i, collector);
+        }
+        collector.flush();
+    }
+}
+
+int Batch::lanes()
+{
+#ifdef CHESS_BATCH_SIMD
+    static const int width = __builtin_cpu_supports("avx512f") ? 8 : __builtin_cpu_supports("avx2") ? 4 : 1;
+    return width;
+#else
+    return 1;
+#endif
+}
+
+void Batch::countMoves(const Board* boards, size_t count, int* counts)
+{
+#ifdef CHESS_BATCH_SIMD
+    switch (lanes())
+    {
+    case 8:
+        countWith<8, countBlockAvx512>(boards, count, counts);
+        return;
+    case 4:
+        countWith<4, countBlockAvx2>(boards, count, counts);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i)
+    {
+        counts[i] = boards[i].countMoves();
+    }
+}
+
+void Batch::perft(const Board* roots, size_t count, int depth, uint64_t* nodes)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        nodes[i] = depth <= 0 ? 1 : 0;
+    }
+    if (depth <= 0)
+    {
+        return;
+    }
+#ifdef CHESS_BATCH_SIMD
+    switch (lanes())
+    {
+    case 8:
+        perftWith<8, countBlockAvx512>(roots, count, depth, nodes);
+        return;
+    case 4:
+        perftWith<4, countBlockAvx2>(roots, count, depth, nodes);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i)
+    {
+        Board board = roots[i];
+        nodes[i] = board.perft(depth);
+    }
+}
+
+uint64_t Batch::perft(const Board& root, int depth)
+{
+    uint64_t nodes;
+    perft(&root, 1, depth, &nodes);
+    return nodes;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "board.hpp"
+
+/**
+ * @brief Legal move counting over many boards at once.
+ *
+ * Boards are transposed into blocks of 8 (AVX-512) or 4 (AVX2) lanes, each
+ * mirrored so that the side to move plays white, and every lane is counted
+ * with the same instructions: pawn, knight and king moves are shifts of
+ * whole bitboards, slider moves are Kogge-Stone fills per direction, and
+ * checks and pins come from fills out of each king. En passant needs the
+ * occupancy after the capture and is counted per board while loading.
+ *
+ * The counts are identical to Board::countMoves(). Only the counting is
+ * vectorised, so the gain is in throughput over many positions rather than
+ * latency on one; on CPUs without AVX2 every call falls back to the Board
+ * methods.
+ */
+namespace Batch {
+    /**
+     * @brief Boards counted per instruction on this CPU: 8, 4, or 1 without AVX2.
+     */
+    int lanes();
+    /**
+     * @brief Writes the number of legal moves of each of `count` boards to `counts`.
+     */
+    void countMoves(const Board* boards, size_t count, int* counts);
+    /**
+     * @brief Runs perft from each of `count` roots and writes the leaf counts to `nodes`.
+     *
+     * The trees are walked one move at a time as in Board::perft(), but the
+     * positions one ply above the leaves, from every root, are queued into
+     * shared blocks and counted together.
+     */
+    void perft(const Board* roots, size_t count, int depth, uint64_t* nodes);
+    uint64_t perft(const Board& root, int depth);
+}
@@ -0,0 +1,198 @@
+#include "batch_kernel.hpp"
+#include <cstring>
+#include "movegen.hpp"
+
+#ifdef CHESS_BATCH_SIMD
+// GCC reports -Wpsabi for the vector-returning helpers only once it reaches
+// the end of the file, past any diagnostic pop, so the ignore cannot be
+// narrower than this file; see batch_kernel.hpp.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+    using namespace BatchKernel;
+    using namespace MoveGen;
+    constexpr uint64_t ALL = ~0ULL;
+    constexpr uint64_t NOT_A = ~FILE_A;
+    constexpr uint64_t NOT_H = ~FILE_H;
+    constexpr uint64_t NOT_AB = ~(FILE_A | FILE_A << 1);
+    constexpr uint64_t NOT_GH = ~(FILE_H | FILE_H >> 1);
+    constexpr uint64_t RANK_3 = RANK_1 << 16;
+
+    typedef uint64_t Lanes4 __attribute__((vector_size(32)));
+    typedef uint64_t Lanes8 __attribute__((vector_size(64)));
+
+    // The kernel is written once over GCC vector types and inlined into one
+    // function per instruction set, which picks the register width. No helper
+    // is ever called out of line, so GCC's note that passing these vectors
+    // without AVX changes the calling convention does not apply.
+#define BATCH_INLINE inline __attribute__((always_inline))
+
+    template<int Shift, typename V> BATCH_INLINE V shift(const V& bitboards)
+    {
+        if constexpr (Shift > 0)
+        {
+            return bitboards << Shift;
+        }
+        else
+        {
+            return bitboards >> -Shift;
+        }
+    }
+    // all-ones in lanes where `bitboards` is empty, zero elsewhere
+    template<typename V> BATCH_INLINE V isEmpty(const V& bitboards)
+    {
+        return (V)(bitboards == 0);
+    }
+    template<typename V> BATCH_INLINE V popcount(const V& bitboards)
+    {
+        V x = bitboards - ((bitboards >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = x + (x >> 8);
+        x = x + (x >> 16);
+        return (x + (x >> 32)) & 0x7F;
+    }
+    // Kogge-Stone: squares reached from `origins` by sliding through `through` in
+    // one direction, including the first square that is not open; `Mask`
+    // drops squares that wrapped around the board edge
+    template<int Shift, uint64_t Mask, typename V> BATCH_INLINE V slide(const V& origins, const V& through)
+    {
+        V open = through & Mask;
+        V from = origins | (open & shift<Shift>(origins));
+        open &= shift<Shift>(open);
+        from |= open & shift<2 * Shift>(from);
+        open &= shift<2 * Shift>(open);
+        from |= open & shift<4 * Shift>(from);
+        return shift<Shift>(from) & Mask;
+    }
+    template<typename V> BATCH_INLINE V knightAttacks(const V& knights)
+    {
+        return (shift<17>(knights) & NOT_A) | (shift<15>(knights) & NOT_H) | (shift<10>(knights) & NOT_AB)
+             | (shift<6>(knights) & NOT_GH) | (shift<-6>(knights) & NOT_AB) | (shift<-10>(knights) & NOT_GH)
+             | (shift<-15>(knights) & NOT_A) | (shift<-17>(knights) & NOT_H);
+    }
+    template<typename V> BATCH_INLINE V kingAttacks(const V& kings)
+    {
+        V sideways = kings | (shift<1>(kings) & NOT_A) | (shift<-1>(kings) & NOT_H);
+        return (sideways | shift<8>(sideways) | shift<-8>(sideways)) ^ kings;
+    }
+    // Casts the ray out of the king in one direction, through our own pieces
+    // up to the first enemy piece. If that is a slider moving along this line,
+    // the ray is a check when no piece of ours stands on it and a pin when
+    // exactly one does.
+    template<int Shift, uint64_t Mask, typename V>
+    BATCH_INLINE void kingRay(const V& king, const V& own, const V& enemy, const V& sliders, V& checkRays, V& pinLine)
+    {
+        V ray = slide<Shift, Mask>(king, ~enemy);
+        V hit = ~isEmpty(ray & sliders);
+        V blockers = ray & own;
+        checkRays |= ray & hit & isEmpty(blockers);
+        pinLine |= ray & hit & ~isEmpty(blockers) & isEmpty(blockers & (blockers - 1));
+    }
+    // one per piece per direction, so the fills of different pieces never overlap
+    template<int Shift, uint64_t Mask, typename V>
+    BATCH_INLINE V countSlides(const V& movers, const V& empty, const V& targets)
+    {
+        return popcount(slide<Shift, Mask>(movers, empty) & targets);
+    }
+
+    template<typename V, int N> BATCH_INLINE void countBlock(const Block<N>& block, int* counts)
+    {
+        static_assert(sizeof(V) == N * sizeof(uint64_t), "one lane per board");
+        V p[12];
+        for (int piece = 0; piece < 12; ++piece)
+        {
+            std::memcpy(&p[piece], block.pieces[piece], sizeof(V));
+        }
+        V own = p[0] | p[1] | p[2] | p[3] | p[4] | p[5];
+        V enemy = p[6] | p[7] | p[8] | p[9] | p[10] | p[11];
+        V empty = ~(own | enemy);
+        V king = p[Board::WHITE_KING];
+        V enemyStraight = p[Board::BLACK_ROOK] | p[Board::BLACK_QUEEN];
+        V enemyDiagonal = p[Board::BLACK_BISHOP] | p[Board::BLACK_QUEEN];
+
+        // the king is taken off the board so it cannot step back along a slider's line
+        V open = empty | king;
+        V attacked = (shift<-7>(p[Board::BLACK_PAWN]) & NOT_A) | (shift<-9>(p[Board::BLACK_PAWN]) & NOT_H)
+                   | knightAttacks(p[Board::BLACK_KNIGHT]) | kingAttacks(p[Board::BLACK_KING])
+                   | slide<8, ALL>(enemyStraight, open) | slide<-8, ALL>(enemyStraight, open)
+                   | slide<1, NOT_A>(enemyStraight, open) | slide<-1, NOT_H>(enemyStraight, open)
+                   | slide<9, NOT_A>(enemyDiagonal, open) | slide<-9, NOT_H>(enemyDiagonal, open)
+                   | slide<7, NOT_H>(enemyDiagonal, open) | slide<-7, NOT_A>(enemyDiagonal, open);
+
+        // pins are kept per line, as a pinned piece may still move along its own
+        V checkRays = {};
+        V vertical = {}, horizontal = {}, diagonal = {}, antiDiagonal = {};
+        kingRay<8, ALL>(king, own, enemy, enemyStraight, checkRays, vertical);
+        kingRay<-8, ALL>(king, own, enemy, enemyStraight, checkRays, vertical);
+        kingRay<1, NOT_A>(king, own, enemy, enemyStraight, checkRays, horizontal);
+        kingRay<-1, NOT_H>(king, own, enemy, enemyStraight, checkRays, horizontal);
+        kingRay<9, NOT_A>(king, own, enemy, enemyDiagonal, checkRays, diagonal);
+        kingRay<-9, NOT_H>(king, own, enemy, enemyDiagonal, checkRays, diagonal);
+        kingRay<7, NOT_H>(king, own, enemy, enemyDiagonal, checkRays, antiDiagonal);
+        kingRay<-7, NOT_A>(king, own, enemy, enemyDiagonal, checkRays, antiDiagonal);
+        V checkers = (checkRays & enemy) | (knightAttacks(king) & p[Board::BLACK_KNIGHT])
+                   | (((shift<7>(king) & NOT_H) | (shift<9>(king) & NOT_A)) & p[Board::BLACK_PAWN]);
+        // capture the checker or block it; double checks only leave king moves
+        V doubleCheck = ~isEmpty(checkers & (checkers - 1));
+        V checkMask = (isEmpty(checkers) | checkRays | checkers) & ~doubleCheck;
+        V free = ~(own & (vertical | horizontal | diagonal | antiDiagonal));
+        V targets = ~own & checkMask;
+
+        // every jump is counted on its own, as two knights may share a target
+        V knights = p[Board::WHITE_KNIGHT] & free;
+        V total = popcount(shift<17>(knights) & NOT_A & targets) + popcount(shift<15>(knights) & NOT_H & targets)
+                + popcount(shift<10>(knights) & NOT_AB & targets) + popcount(shift<6>(knights) & NOT_GH & targets)
+                + popcount(shift<-6>(knights) & NOT_AB & targets) + popcount(shift<-10>(knights) & NOT_GH & targets)
+                + popcount(shift<-15>(knights) & NOT_A & targets) + popcount(shift<-17>(knights) & NOT_H & targets);
+        V straight = p[Board::WHITE_ROOK] | p[Board::WHITE_QUEEN];
+        V diagonals = p[Board::WHITE_BISHOP] | p[Board::WHITE_QUEEN];
+        total += countSlides<8, ALL>(straight & (free | vertical), empty, targets)
+               + countSlides<-8, ALL>(straight & (free | vertical), empty, targets)
+               + countSlides<1, NOT_A>(straight & (free | horizontal), empty, targets)
+               + countSlides<-1, NOT_H>(straight & (free | horizontal), empty, targets)
+               + countSlides<9, NOT_A>(diagonals & (free | diagonal), empty, targets)
+               + countSlides<-9, NOT_H>(diagonals & (free | diagonal), empty, targets)
+               + countSlides<7, NOT_H>(diagonals & (free | antiDiagonal), empty, targets)
+               + countSlides<-7, NOT_A>(diagonals & (free | antiDiagonal), empty, targets);
+
+        // a pinned pawn may push along a file pin and capture along a diagonal one
+        V pawns = p[Board::WHITE_PAWN];
+        V single = shift<8>(pawns & (free | vertical)) & empty;
+        V twice = shift<8>(single & RANK_3) & empty & checkMask;
+        single &= checkMask;
+        V west = shift<7>(pawns & (free | antiDiagonal)) & NOT_H & enemy & checkMask;
+        V east = shift<9>(pawns & (free | diagonal)) & NOT_A & enemy & checkMask;
+        // each promotion counts four times; the three last-rank sets share one popcount
+        V promotions = shift<-56>(single & RANK_8) | shift<-48>(west & RANK_8) | shift<-40>(east & RANK_8);
+        total += popcount(single) + popcount(twice) + popcount(west) + popcount(east) + 3 * popcount(promotions);
+
+        // castling squares are fixed once the board is mirrored: e1 to g1 or c1
+        V castling;
+        std::memcpy(&castling, block.castling, sizeof(V));
+        V notInCheck = isEmpty(checkers);
+        V kingside = notInCheck & ~isEmpty(castling & 0x40ULL & (king << 2) & (p[Board::WHITE_ROOK] >> 1))
+                   & isEmpty((~empty & 0x60ULL) | (attacked & 0x60ULL));
+        V queenside = notInCheck & ~isEmpty(castling & 0x04ULL & (king >> 2) & (p[Board::WHITE_ROOK] << 2))
+                    & isEmpty((~empty & 0x0EULL) | (attacked & 0x0CULL));
+        V kingTargets = (kingAttacks(king) & ~own & ~attacked) | (kingside & 0x40ULL) | (queenside & 0x04ULL);
+        total += popcount(kingTargets);
+        for (int lane = 0; lane < N; ++lane)
+        {
+            counts[lane] = static_cast<int>(total[lane]) + block.enPassant[lane];
+        }
+    }
+#undef BATCH_INLINE
+}
+
+namespace BatchKernel {
+    __attribute__((target("avx2"))) void countBlockAvx2(const Block<4>& block, int* counts)
+    {
+        countBlock<Lanes4>(block, counts);
+    }
+    __attribute__((target("avx512f"))) void countBlockAvx512(const Block<8>& block, int* counts)
+    {
+        countBlock<Lanes8>(block, counts);
+    }
+}
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include "board.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHESS_BATCH_SIMD 1
+#endif
+
+// The lane layout shared by Batch and its vector kernels. The kernels live in
+// batch_kernel.cpp on their own, so that the -Wpsabi ignore they need, which
+// GCC only honours for the whole translation unit, covers nothing else.
+// Internal to the board module.
+namespace BatchKernel {
+    // lane data for N boards, each mirrored so that white is to move
+    template<int N> struct Block {
+        alignas(64) uint64_t pieces[12][N];
+        // g1 and c1 while the castling rights still allow them
+        alignas(64) uint64_t castling[N];
+        // legal en passant captures, counted while loading
+        int enPassant[N];
+    };
+
+#ifdef CHESS_BATCH_SIMD
+    // legal move counts of the N boards in `block`; the CPU must support the instruction set
+    void countBlockAvx2(const Block<4>& block, int* counts);
+    void countBlockAvx512(const Block<8>& block, int* counts);
+#endif
+}
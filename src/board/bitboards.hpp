@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Storage layouts for the pieces of a Board.
+ *
+ * Both layouts answer the same queries, with pieces indexed in Board::Piece
+ * order (white pawn to black king, 12 meaning none), so the Board code is the
+ * same whichever one it stores. They only differ in which queries are single
+ * loads and how much a Board copy moves:
+ *
+ * - PerPiece keeps one bitboard per piece (96 bytes). A piece is one load,
+ *   colours and occupancy are ORs of six or twelve.
+ * - Compact keeps one bitboard per piece type, one per colour and the
+ *   occupancy (72 bytes). Colours, occupancy and both-colour types such as
+ *   "all bishops" are one load, a single piece is an AND of two.
+ *
+ * Board uses PerPiece unless the library is built with CHESS_COMPACT_BOARD
+ * (the CMake option of the same name), which brings a Board from 160 to 136
+ * bytes. Board's own layout is fixed per build, as every module shares its
+ * Piece type and interface. Both layouts are ordinary types, though, so code
+ * that keeps many positions can store them in the other one side by side
+ * with Board (Tuning::Position keeps Compact in either build). toggle() flips
+ * squares with XOR, so callers must only toggle squares on and off
+ * consistently: a square never holds two pieces.
+ */
+namespace BoardLayout {
+    struct PerPiece {
+        uint64_t pieces[12];
+
+        constexpr void clear()
+        {
+            for (uint64_t& bitboard : pieces)
+            {
+                bitboard = 0;
+            }
+        }
+        constexpr uint64_t piece(int piece) const { return pieces[piece]; }
+        // both colours of a piece type, given by its white piece
+        constexpr uint64_t pieceType(int whitePiece) const { return pieces[whitePiece] | pieces[whitePiece + 6]; }
+        constexpr uint64_t color(bool white) const
+        {
+            const uint64_t* side = white ? &pieces[0] : &pieces[6];
+            return side[0] | side[1] | side[2] | side[3] | side[4] | side[5];
+        }
+        constexpr uint64_t occupancy() const { return color(true) | color(false); }
+        constexpr int pieceAt(int square) const
+        {
+            uint64_t bit = 1ULL << square;
+            for (int piece = 0; piece < 12; ++piece)
+            {
+                if (pieces[piece] & bit)
+                {
+                    return piece;
+                }
+            }
+            return 12;
+        }
+        constexpr void toggle(int piece, uint64_t squares) { pieces[piece] ^= squares; }
+    };
+
+    struct Compact {
+        uint64_t types[6];
+        uint64_t colors[2]; // [0] = white, [1] = black
+        uint64_t occupied;
+
+        constexpr void clear()
+        {
+            for (uint64_t& bitboard : types)
+            {
+                bitboard = 0;
+            }
+            colors[0] = colors[1] = occupied = 0;
+        }
+        constexpr uint64_t piece(int piece) const { return types[piece % 6] & colors[piece / 6]; }
+        constexpr uint64_t pieceType(int whitePiece) const { return types[whitePiece]; }
+        constexpr uint64_t color(bool white) const { return colors[white ? 0 : 1]; }
+        constexpr uint64_t occupancy() const { return occupied; }
+        constexpr int pieceAt(int square) const
+        {
+            uint64_t bit = 1ULL << square;
+            if (!(occupied & bit))
+            {
+                return 12;
+            }
+            int first = (colors[0] & bit) ? 0 : 6;
+            for (int type = 0; type < 5; ++type)
+            {
+                if (types[type] & bit)
+                {
+                    return first + type;
+                }
+            }
+            return first + 5;
+        }
+        constexpr void toggle(int piece, uint64_t squares)
+        {
+            types[piece % 6] ^= squares;
+            colors[piece / 6] ^= squares;
+            occupied ^= squares;
+        }
+    };
+
+#ifdef CHESS_COMPACT_BOARD
+    using Selected = Compact;
+#else
+    using Selected = PerPiece;
+#endif
+}
@@ -1,5 +1,30 @@
 #include <stdexcept>
 #include "board.hpp"
+#include "util/instrumentation.hpp"
+
+namespace {
+    // castling rights that survive a move touching each square (king or rook home squares)
+    int castlingMaskForSquare(int square)
+    {
+        switch (square)
+        {
+        case 0:
+            return ~0b0100;
+        case 4:
+            return ~0b1100;
+        case 7:
+            return ~0b1000;
+        case 56:
+            return ~0b0001;
+        case 60:
+            return ~0b0011;
+        case 63:
+            return ~0b0010;
+        default:
+            return ~0;
+        }
+    }
+}
 
 /**
  * === REQUIREMENTS ===
@@ -22,28 +47,7 @@
  */
 Board::Piece Board::getPieceAtPosition(std::string position)
 {
-    uint64_t bitmask = getBitmaskForPosition(position);
-    for (int i = 0; i < 12; ++i)
-    {
-        if (pieces[i] & bitmask)
-        {
-            return static_cast<Piece>(i);
-        }
-    }
-    return EMPTY;
-}
-uint64_t Board::getBitmaskForBoard()
-{
-    uint64_t bitmask = 0;
-    for (int i = 0; i < 12; ++i)
-    {
-        bitmask |= pieces[i];
-    }
-    return bitmask;
-}
-bool Board::getTurn()
-{
-    return whiteTurn;
+    return getPieceAtSquare(getSquareForPosition(position));
 }
 uint64_t Board::getMovesForPieceAtPosition(std::string position)
 {
@@ -90,4 +94,127 @@ uint64_t Board::getMovesForPieceAtPosition(std::string position)
     default:
         throw std::invalid_argument("Unknown piece type");
     }
-}
\ No newline at end of file
+}
+void Board::move(std::string move)
+{
+    Move requested = parseMove(move);
+    MoveError error = validateMove(requested);
+    if (error != MOVE_OK)
+    {
+        throw std::invalid_argument(std::string("Illegal move: ") + describeMoveError(error));
+    }
+    makeMove(requested);
+}
+Board::UndoInfo Board::makeMove(Move move)
+{
+    CHESS_TIMED(MAKE_MOVE);
+    const Zobrist::Keys& keys = Zobrist::KEYS;
+    UndoInfo undo{EMPTY, castlingRights, enPassantSquare, attackCache, halfmoveClock, hashKey};
+    uint64_t fromBit = 1ULL << move.from;
+    uint64_t toBit = 1ULL << move.to;
+    Piece piece = getPieceAtSquare(move.from);
+
+    undo.captured = getPieceAtSquare(move.to);
+    if (undo.captured != EMPTY)
+    {
+        bitboards.toggle(undo.captured, toBit);
+        hashKey ^= keys.pieceSquare[undo.captured][move.to];
+    }
+    bitboards.toggle(piece, fromBit | toBit);
+    hashKey ^= keys.pieceSquare[piece][move.from] ^ keys.pieceSquare[piece][move.to];
+
+    if (enPassantSquare >= 0)
+    {
+        hashKey ^= keys.enPassantFile[enPassantSquare % 8];
+    }
+    enPassantSquare = -1;
+    if (piece == WHITE_PAWN || piece == BLACK_PAWN)
+    {
+        int forward = piece == WHITE_PAWN ? 8 : -8;
+        if (move.to == undo.enPassantSquare)
+        {
+            undo.captured = piece == WHITE_PAWN ? BLACK_PAWN : WHITE_PAWN;
+            bitboards.toggle(undo.captured, 1ULL << (move.to - forward));
+            hashKey ^= keys.pieceSquare[undo.captured][move.to - forward];
+        }
+        else if (move.to - move.from == 2 * forward)
+        {
+            enPassantSquare = move.from + forward;
+            hashKey ^= keys.enPassantFile[enPassantSquare % 8];
+        }
+        if (move.promotion != EMPTY)
+        {
+            bitboards.toggle(piece, toBit);
+            bitboards.toggle(move.promotion, toBit);
+            hashKey ^= keys.pieceSquare[piece][move.to] ^ keys.pieceSquare[move.promotion][move.to];
+        }
+    }
+    else if ((piece == WHITE_KING || piece == BLACK_KING) && (move.to - move.from == 2 || move.from - move.to == 2))
+    {
+        // castling: the rook jumps to the square the king crossed
+        Piece rook = piece == WHITE_KING ? WHITE_ROOK : BLACK_ROOK;
+        int rookFrom = move.to > move.from ? move.to + 1 : move.to - 2;
+        int rookTo = move.to > move.from ? move.to - 1 : move.to + 1;
+        bitboards.toggle(rook, (1ULL << rookFrom) | (1ULL << rookTo));
+        hashKey ^= keys.pieceSquare[rook][rookFrom] ^ keys.pieceSquare[rook][rookTo];
+    }
+
+    // captures and pawn moves can never be undone, so repetitions start over
+    bool irreversible = undo.captured != EMPTY || piece == WHITE_PAWN || piece == BLACK_PAWN;
+    halfmoveClock = irreversible ? 0 : halfmoveClock + 1;
+    if (!whiteTurn)
+    {
+        fullmoveNumber++;
+    }
+
+    castlingRights &= castlingMaskForSquare(move.from) & castlingMaskForSquare(move.to);
+    hashKey ^= keys.castling[undo.castlingRights] ^ keys.castling[castlingRights] ^ keys.blackToMove;
+    whiteTurn = !whiteTurn;
+    attackCache.valid = false;
+    return undo;
+}
+void Board::unmakeMove(Move move, const UndoInfo& undo)
+{
+    CHESS_TIMED(UNMAKE_MOVE);
+    whiteTurn = !whiteTurn;
+    uint64_t fromBit = 1ULL << move.from;
+    uint64_t toBit = 1ULL << move.to;
+    Piece piece = getPieceAtSquare(move.to);
+
+    if (move.promotion != EMPTY)
+    {
+        bitboards.toggle(move.promotion, toBit);
+        piece = whiteTurn ? WHITE_PAWN : BLACK_PAWN;
+        bitboards.toggle(piece, toBit);
+    }
+    bitboards.toggle(piece, fromBit | toBit);
+
+    if (undo.captured != EMPTY)
+    {
+        if ((piece == WHITE_PAWN || piece == BLACK_PAWN) && move.to == undo.enPassantSquare)
+        {
+            bitboards.toggle(undo.captured, 1ULL << (piece == WHITE_PAWN ? move.to - 8 : move.to + 8));
+        }
+        else
+        {
+            bitboards.toggle(undo.captured, toBit);
+        }
+    }
+    else if ((piece == WHITE_KING || piece == BLACK_KING) && (move.to - move.from == 2 || move.from - move.to == 2))
+    {
+        Piece rook = piece == WHITE_KING ? WHITE_ROOK : BLACK_ROOK;
+        int rookFrom = move.to > move.from ? move.to + 1 : move.to - 2;
+        int rookTo = move.to > move.from ? move.to - 1 : move.to + 1;
+        bitboards.toggle(rook, (1ULL << rookFrom) | (1ULL << rookTo));
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    attackCache = undo.attackCache;
+    halfmoveClock = undo.halfmoveClock;
+    hashKey = undo.hashKey;
+    if (!whiteTurn)
+    {
+        fullmoveNumber--;
+    }
+}
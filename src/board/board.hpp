@@ -1,9 +1,12 @@
 #pragma once
 
 #include <vector>
-#include <map>
 #include <string>
+#include <string_view>
+#include <stdexcept>
 #include <cstdint>
+#include "bitboards.hpp"
+#include "zobrist.hpp"
 
 /**
  * @brief Represents a chessboard.
@@ -12,12 +15,24 @@
  * of pieces, turn management, and special rules like castling and en passant.
  */
 class Board {
-    // each bitboard is big endian, where the most significant bit is a8 and the least significant bit is h1
-    uint64_t pieces[12];
+    // piece bitboards, bit 0 = a1 and bit 63 = h8; see bitboards.hpp for the layouts
+    BoardLayout::Selected bitboards;
     // special rules
     bool whiteTurn; // is it white's turn?
     int castlingRights;  // can anyone castle?
     int enPassantSquare; // which squares are valid en passant squares
+    int halfmoveClock;   // plies since the last capture or pawn move
+    int fullmoveNumber;  // starts at 1, incremented after black moves
+    uint64_t hashKey;    // Zobrist key, updated incrementally
+    // checkers and pins only depend on the pieces and side to move, so they are
+    // computed on first use and kept until the position changes. Anything that
+    // modifies the fields above must clear `valid`.
+    struct AttackCache {
+        bool valid;
+        uint64_t checkers;
+        uint64_t pinned[2];
+    };
+    mutable AttackCache attackCache;
 
     public: 
     enum Piece {
@@ -35,19 +50,87 @@ class Board {
         BLACK_KING,
         EMPTY
     };
-    std::map<char, Piece> pieceMap = {
-        {'P', WHITE_PAWN},
-        {'N', WHITE_KNIGHT},
-        {'B', WHITE_BISHOP},
-        {'R', WHITE_ROOK},
-        {'Q', WHITE_QUEEN},
-        {'K', WHITE_KING},
-        {'p', BLACK_PAWN},
-        {'n', BLACK_KNIGHT},
-        {'b', BLACK_BISHOP},
-        {'r', BLACK_ROOK},
-        {'q', BLACK_QUEEN},
-        {'k', BLACK_KING}
+    enum Color {
+        WHITE,
+        BLACK
+    };
+    /**
+     * @brief Returns the `Us` coloured counterpart of a WHITE_* piece, at compile time.
+     */
+    template<Color Us> static constexpr Piece pieceFor(Piece whitePiece)
+    {
+        return static_cast<Piece>(Us == WHITE ? whitePiece : whitePiece + BLACK_PAWN);
+    }
+    /**
+     * @brief Returns the piece for a FEN letter ('P', 'n', ...), or EMPTY.
+     */
+    static constexpr Piece pieceForSymbol(char symbol);
+    /**
+     * @brief A single move between two squares.
+     *
+     * Squares are indexed 0-63 with a1 = 0 and h8 = 63. `promotion` holds the
+     * piece a pawn turns into, or EMPTY for every other move.
+     */
+    struct Move {
+        int from;
+        int to;
+        Piece promotion = EMPTY;
+    };
+    /**
+     * @brief Fixed-capacity list of moves, filled without allocating.
+     *
+     * 256 entries is more than the largest number of legal moves in any position.
+     */
+    struct MoveList {
+        Move moves[256];
+        int count = 0;
+
+        void add(int from, int to, Piece promotion = EMPTY) { moves[count++] = {from, to, promotion}; }
+        int size() const { return count; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+        const Move& operator[](int i) const { return moves[i]; }
+    };
+    /**
+     * @brief Why validateMove() rejected a move, or MOVE_OK.
+     */
+    enum MoveError {
+        MOVE_OK,
+        MOVE_OFF_BOARD,      // a square outside 0-63
+        MOVE_NO_PIECE,       // nothing stands on the origin square
+        MOVE_WRONG_SIDE,     // the piece belongs to the side not to move
+        MOVE_OWN_PIECE,      // the destination holds one of the mover's pieces
+        MOVE_UNREACHABLE,    // the piece cannot get there, or castling is not allowed
+        MOVE_BAD_PROMOTION,  // a missing, misplaced or invalid promotion piece
+        MOVE_LEAVES_KING_IN_CHECK // pinned, ignores a check or steps into one
+    };
+    /**
+     * @brief Why tryFromFEN() rejected a FEN, or FEN_OK.
+     */
+    enum FENError {
+        FEN_OK,
+        FEN_MALFORMED,          // not 8 ranks of 8 files, a missing or bad side to move, or bad characters
+        FEN_KING_COUNT,         // a side without exactly one king
+        FEN_PAWN_ON_BACK_RANK,  // a pawn on the first or eighth rank
+        FEN_BAD_EN_PASSANT,     // a target that no double push by the side not to move could leave
+        FEN_OPPONENT_IN_CHECK   // the side not to move is in check
+    };
+    /**
+     * @brief Never a valid piece; validateMove() rejects it as a promotion.
+     *
+     * EMPTY + 1 rather than -1, so it stays within the values a Piece can hold.
+     */
+    static constexpr Piece INVALID_PIECE = static_cast<Piece>(EMPTY + 1);
+    /**
+     * @brief Everything makeMove() overwrites that unmakeMove() cannot recompute.
+     */
+    struct UndoInfo {
+        Piece captured;
+        int castlingRights;
+        int enPassantSquare;
+        AttackCache attackCache;
+        int halfmoveClock;
+        uint64_t hashKey;
     };
     /**
      * @brief Constructs a new Board object with all pieces in their initial positions.
@@ -55,20 +138,92 @@ class Board {
      * Initializes the board with white and black pieces in their starting positions,
      * sets the turn to white, enables castling rights, and sets no en passant square.
      */
-    Board();
+    constexpr Board();
     /**
      * @brief Constructs a new Board object from a FEN string.
      */
     Board(std::string FEN);
+    /**
+     * @brief Parses a FEN string; usable in constant expressions.
+     *
+     * The halfmove clock and fullmove number are optional and default to 0 and
+     * 1. Board(std::string) and tryFromFEN() run this parser under the
+     * FEN_PARSE timer; calling it directly is untimed, so that fixed
+     * positions can be built at compile time:
+     * `constexpr Board kiwipete = Board::fromFEN("r3k2r/...");`
+     * Malformed input that would put a piece off the board (a rank longer than
+     * 8 files, a ninth rank, an unknown piece letter) or an en passant square
+     * off the third and sixth ranks is rejected, which makes it a compile
+     * error in a constant expression. The position itself is not checked; use
+     * tryFromFEN() for untrusted input.
+     * @throws std::invalid_argument If the FEN is malformed or the side to move is not 'w' or 'b'.
+     */
+    static constexpr Board fromFEN(std::string_view fen);
     Piece getPieceAtPosition(std::string position);
+    /**
+     * @brief Returns the piece on a square index (a1 = 0), or EMPTY.
+     */
+    constexpr Piece getPieceAtSquare(int square) const;
     /**
      * @brief Returns a bitmask representing which squares are occupied on the board.
      */
-    uint64_t getBitmaskForBoard();
+    constexpr uint64_t getBitmaskForBoard() const;
+    /**
+     * @brief Returns the bitboard of a single piece type (e.g., every white knight).
+     */
+    constexpr uint64_t getBitmaskForPiece(Piece piece) const { return bitboards.piece(piece); }
     /**
      * @brief Returns the current turn. True for white's turn, false for black.
      */
-    bool getTurn();
+    constexpr bool getTurn() const { return whiteTurn; }
+    /**
+     * @brief Returns the castling rights as a bitmask: 0b1000 K, 0b0100 Q, 0b0010 k, 0b0001 q.
+     */
+    constexpr int getCastlingRights() const { return castlingRights; }
+    /**
+     * @brief Returns the en passant target square (a1 = 0), or -1 if there is none.
+     */
+    constexpr int getEnPassantSquare() const { return enPassantSquare; }
+    /**
+     * @brief Returns the number of plies since the last capture or pawn move.
+     */
+    constexpr int getHalfmoveClock() const { return halfmoveClock; }
+    /**
+     * @brief Returns the FEN fullmove number, starting at 1 and incremented after black moves.
+     */
+    constexpr int getFullmoveNumber() const { return fullmoveNumber; }
+    /**
+     * @brief Returns the Zobrist key of the position (see zobrist.hpp).
+     *
+     * Covers pieces, side to move, castling rights and the en passant file, and
+     * is kept up to date by makeMove(), so reading it costs nothing.
+     */
+    constexpr uint64_t getHash() const { return hashKey; }
+    /**
+     * @brief Returns true if 100 plies have passed without a capture or pawn move.
+     *
+     * Checkmate on the final move takes precedence; callers adjudicating a game
+     * should look for legal moves first.
+     */
+    constexpr bool isFiftyMoveRule() const { return halfmoveClock >= 100; }
+    /**
+     * @brief Puts `piece` on `square`, replacing whatever stood there.
+     *
+     * Meant for setting up positions; no legality checks are made.
+     */
+    constexpr void placePiece(Piece piece, int square);
+    /**
+     * @brief Sets the side to move. True for white, false for black.
+     */
+    constexpr void setTurn(bool white)
+    {
+        if (white != whiteTurn)
+        {
+            hashKey ^= Zobrist::KEYS.blackToMove;
+        }
+        whiteTurn = white;
+        attackCache.valid = false;
+    }
     uint64_t getMovesForPieceAtPosition(std::string position);
     uint64_t getMovesForPawnAtPosition(std::string position);
     uint64_t getMovesForKnightAtPosition(std::string position);
@@ -76,6 +231,98 @@ class Board {
     uint64_t getMovesForRookAtPosition(std::string position);
     uint64_t getMovesForQueenAtPosition(std::string position);
     uint64_t getMovesForKingAtPosition(std::string position);
+    /**
+     * @brief Generates every legal move for the side to move.
+     *
+     * Uses the cached checkers and pins, so no move is tried and taken back
+     * to test legality.
+     */
+    MoveList generateMoves() const;
+    /**
+     * @brief Returns the number of legal moves for the side to move.
+     *
+     * Gives the same count as generateMoves().size() from popcounts over the
+     * target bitboards, without building a move list.
+     */
+    int countMoves() const;
+    /**
+     * @brief Returns the number of legal moves of the side-to-move piece on `square`, or 0.
+     */
+    int countMovesFrom(int square) const;
+    /**
+     * @brief Returns true if the side to move has at least one legal move.
+     *
+     * Stops as soon as one is found, usually after looking at the king.
+     */
+    bool hasLegalMoves() const;
+    bool isCheckmate() const { return inCheck() && !hasLegalMoves(); }
+    bool isStalemate() const { return !inCheck() && !hasLegalMoves(); }
+    /**
+     * @brief Returns the pseudo-legal mobility of the piece on `square`, of either colour.
+     *
+     * Counts the squares it attacks that are not taken by its own side (pushes
+     * and captures for pawns), ignoring pins and checks, as evaluation features
+     * expect. Returns 0 for an empty square.
+     */
+    int mobility(int square) const;
+    /**
+     * @brief Returns every square attacked by a piece of colour `by`.
+     */
+    uint64_t attackedSquares(Color by) const;
+    /**
+     * @brief Returns the number of squares attacked by colour `by`.
+     */
+    int countAttackedSquares(Color by) const { return __builtin_popcountll(attackedSquares(by)); }
+    /**
+     * @brief Checks a single move for the side to move without generating the move list.
+     *
+     * Meant for untrusted input: any squares and promotion are accepted and
+     * nothing throws. Uses the attack tables with the cached pins and checkers,
+     * so it costs about as much as looking up one piece's targets. `promotion`
+     * must be the mover's queen, rook, bishop or knight for a pawn reaching the
+     * last rank and EMPTY otherwise.
+     */
+    MoveError validateMove(int from, int to, Piece promotion = EMPTY) const noexcept;
+    MoveError validateMove(Move move) const noexcept { return validateMove(move.from, move.to, move.promotion); }
+    /**
+     * @brief Returns a short lowercase description of `error`, e.g. "illegal promotion".
+     */
+    static const char* describeMoveError(MoveError error);
+    /**
+     * @brief Parses and checks a FEN from an untrusted source. Never throws.
+     *
+     * fromFEN() only guards against writing off the board; this also requires
+     * the side to move, exactly 8 ranks of 8 files, one king per side, no
+     * pawns on the back ranks, an en passant target behind a pawn the side not
+     * to move just pushed two squares, and the side not to move not in check,
+     * so that move generation can rely on the result.
+     * @param board Receives the position for every result but FEN_MALFORMED;
+     * only FEN_OK makes it safe to generate moves from.
+     */
+    static FENError tryFromFEN(std::string_view fen, Board& board) noexcept;
+    /**
+     * @brief Returns a short lowercase description of `error`, e.g. "pawn on back rank".
+     */
+    static const char* describeFENError(FENError error);
+    /**
+     * @brief Plays a move given as "<from> <to>", e.g. "g1 f3".
+     * @throws std::invalid_argument If the move is malformed or not legal.
+     */
+    void move(std::string move);
+    /**
+     * @brief Plays a legal move and returns what is needed to take it back.
+     *
+     * The move is not validated; pass moves from generateMoves().
+     */
+    UndoInfo makeMove(Move move);
+    /**
+     * @brief Restores the position from before makeMove(move).
+     */
+    void unmakeMove(Move move, const UndoInfo& undo);
+    /**
+     * @brief Counts the leaf nodes of the legal move tree `depth` plies deep.
+     */
+    uint64_t perft(int depth);
     /**
      * @brief Compares two rows on the chessboard.
      * 
@@ -99,6 +346,75 @@ class Board {
      */
     static int compareColumn(std::string position, char targetColumn);
     static int compareColumn(std::string position, int targetColumn);
+    /**
+     * @brief Converts a position string (e.g., "e4") to its square index (a1 = 0, h8 = 63).
+     * @throws std::invalid_argument If the position is malformed or off the board.
+     */
+    static constexpr int getSquareForPosition(std::string_view position);
+    /**
+     * @brief Parses a move written as "<from> <to>", e.g. "g1 f3".
+     *
+     * A promotion piece may follow the destination ("e7 e8q"); its colour is
+     * taken from the promotion rank.
+     * @throws std::invalid_argument If either square or the promotion piece is invalid.
+     */
+    static Move parseMove(std::string move);
+    /**
+     * @brief Parses a move in standard algebraic notation (e.g. "Nf3", "exd5", "e8=Q", "O-O").
+     *
+     * Check and annotation suffixes ("+", "#", "!", "?") are ignored.
+     * @throws std::invalid_argument If the move is malformed, illegal or ambiguous.
+     */
+    Move parseSAN(std::string san) const;
+    /**
+     * @brief Writes a legal move in standard algebraic notation, including "+" or "#".
+     */
+    std::string toSAN(Move move) const;
+
+    /**
+     * @brief Static exchange evaluation of a move.
+     *
+     * Plays out the capture sequence on the destination square, each side always
+     * recapturing with its least valuable attacker, and reports whether the side
+     * making `move` ends up at least `threshold` centipawns ahead. Sliders hidden
+     * behind a capturing piece join in as soon as it leaves the square. The board
+     * is never modified and nothing is allocated, so this is cheap enough to call
+     * on every capture during move ordering and pruning.
+     *
+     * @param move The move to evaluate, usually a capture.
+     * @param threshold The minimum material balance the exchange must reach.
+     * @return bool True if the exchange nets at least `threshold`.
+     */
+    bool see(Move move, int threshold = 0) const;
+
+    /**
+     * @brief Returns every piece, of either colour, attacking `square`.
+     *
+     * Sliders are blocked by `occupancy` rather than the current board, which
+     * lets callers ask "what if these pieces were gone" without moving anything.
+     */
+    uint64_t attackersTo(int square, uint64_t occupancy) const;
+    /**
+     * @brief Returns true if any piece of colour `by` attacks `square`.
+     */
+    bool isSquareAttacked(int square, Color by) const;
+    /**
+     * @brief Returns true if the side to move is in check.
+     */
+    bool inCheck() const;
+    /**
+     * @brief Returns a bitmask of the enemy pieces giving check to the side to move.
+     *
+     * Computed once per position and cached until the board changes.
+     */
+    uint64_t checkers() const;
+    /**
+     * @brief Returns a bitmask of `color`'s pieces that are pinned to their own king.
+     *
+     * A piece is pinned when it is the only piece between its king and an enemy
+     * bishop, rook or queen on the same line. Cached like checkers().
+     */
+    uint64_t pinned(Color color) const;
 
     /**
      * @brief Generates a string representation of the current board state.
@@ -121,9 +437,366 @@ class Board {
      */
     std::string generateFEN() const;
     private:
-    // bitmask utility functions    
-    uint64_t getBitmaskForPosition(std::string position);
-    uint64_t getBitmaskForRow(int row);
-    uint64_t getBitmaskForColumn(char column);
-    uint64_t getBitmaskForColumn(int column);
-};
\ No newline at end of file
+    // selects the constructor that leaves the board empty, for fromFEN() to fill in
+    struct EmptyBoard {};
+    constexpr explicit Board(EmptyBoard);
+    // fromFEN() under the FEN_PARSE timer, for the runtime entry points
+    static Board parseFEN(std::string_view fen);
+    // occupancy queries used by the attack code
+    constexpr uint64_t getBitmaskForColor(bool white) const { return bitboards.color(white); }
+    void updateAttackCache() const;
+    template<Color Us> void updatePins(uint64_t occupancy) const;
+    // state shared by the piece generators while building one move list
+    struct MoveGenContext {
+        uint64_t own;
+        uint64_t enemy;
+        uint64_t occupancy;
+        // destinations that resolve a check, every square when not in check
+        uint64_t checkMask;
+        uint64_t pinned;
+        int kingSquare;
+    };
+    // Move generation is specialised on the side to move. generateMoves() and
+    // the getMovesFor*AtPosition() wrappers pick the colour once, so piece
+    // indices, pawn directions and promotion ranks are constants below them.
+    // The small helpers are defined in movegen.hpp.
+    template<Color Us> uint64_t getBitmaskForColor() const;
+    template<Color Us> MoveGenContext getMoveGenContext() const;
+    // true if a piece of colour `Them` attacks `square` with the given occupancy
+    template<Color Them> bool isAttackedBy(int square, uint64_t occupancy) const;
+    // restricts targets of a pinned piece to the line through its king
+    uint64_t getPinMask(const MoveGenContext& context, int square) const;
+    template<Color Us> void generateAllMoves(MoveList& moves) const;
+    // piece generators, adding moves for every piece in `from` that belongs to `Us`
+    template<Color Us> void generatePawnMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const;
+    template<Color Us> void generateKnightMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const;
+    template<Color Us> void generateBishopMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const;
+    template<Color Us> void generateRookMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const;
+    template<Color Us> void generateQueenMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const;
+    template<Color Us> void generateKingMoves(const MoveGenContext& context, MoveList& moves) const;
+    // safe king steps plus castling destinations
+    template<Color Us> uint64_t getKingTargets(const MoveGenContext& context) const;
+    // counting counterparts of the generators above; `anyOnly` stops at the first move found
+    template<Color Us> int countPawnMoves(const MoveGenContext& context, uint64_t from) const;
+    template<Color Us> int countAllMoves(uint64_t from, bool anyOnly) const;
+    // single-move legality check behind validateMove()
+    template<Color Us> MoveError validateMoveFor(int from, int to, Piece promotion) const;
+    // destinations of the legal moves generated for a single square
+    static uint64_t getTargetMask(const MoveList& moves);
+    // recomputes hashKey from scratch, for freshly set up positions
+    constexpr uint64_t computeHash() const;
+    // bitmask utility functions
+    static constexpr uint64_t getBitmaskForPosition(std::string_view position);
+    static constexpr uint64_t getBitmaskForRow(int row);
+    static constexpr uint64_t getBitmaskForColumn(char column);
+    static constexpr uint64_t getBitmaskForColumn(int column);
+};
+
+// === Constant expression support ===
+// Construction, FEN parsing and the square/bitmask helpers are defined here so
+// that boards and masks can be built by the compiler.
+
+constexpr Board::Board()
+    : bitboards{},
+      whiteTurn(true),
+      castlingRights(0b1111), // Both sides can castle both ways initially
+      enPassantSquare(-1), // No en passant square initially
+      halfmoveClock(0),
+      fullmoveNumber(1),
+      hashKey(0),
+      attackCache{}
+{
+    constexpr uint64_t START[12] = {
+        0x000000000000FF00, // WHITE_PAWN
+        0x0000000000000042, // WHITE_KNIGHT
+        0x0000000000000024, // WHITE_BISHOP
+        0x0000000000000081, // WHITE_ROOK
+        0x0000000000000008, // WHITE_QUEEN
+        0x0000000000000010, // WHITE_KING
+        0x00FF000000000000, // BLACK_PAWN
+        0x4200000000000000, // BLACK_KNIGHT
+        0x2400000000000000, // BLACK_BISHOP
+        0x8100000000000000, // BLACK_ROOK
+        0x0800000000000000, // BLACK_QUEEN
+        0x1000000000000000  // BLACK_KING
+    };
+    for (int piece = 0; piece < 12; ++piece)
+    {
+        bitboards.toggle(piece, START[piece]);
+    }
+    hashKey = computeHash();
+}
+constexpr Board::Board(EmptyBoard)
+    : bitboards{},
+      whiteTurn(true),
+      castlingRights(0),
+      enPassantSquare(-1),
+      halfmoveClock(0),
+      fullmoveNumber(1),
+      hashKey(0),
+      attackCache{}
+{
+}
+constexpr Board::Piece Board::pieceForSymbol(char symbol)
+{
+    switch (symbol)
+    {
+    case 'P': return WHITE_PAWN;
+    case 'N': return WHITE_KNIGHT;
+    case 'B': return WHITE_BISHOP;
+    case 'R': return WHITE_ROOK;
+    case 'Q': return WHITE_QUEEN;
+    case 'K': return WHITE_KING;
+    case 'p': return BLACK_PAWN;
+    case 'n': return BLACK_KNIGHT;
+    case 'b': return BLACK_BISHOP;
+    case 'r': return BLACK_ROOK;
+    case 'q': return BLACK_QUEEN;
+    case 'k': return BLACK_KING;
+    default: return EMPTY;
+    }
+}
+constexpr Board Board::fromFEN(std::string_view fen)
+{
+    Board board{EmptyBoard{}};
+    int rank = 7;
+    int file = 0;
+    enum FEN_PART
+    {
+        PIECES,
+        TURN,
+        CASTLING,
+        EN_PASSANT,
+        HALF_MOVE,
+        FULL_MOVE
+    };
+    FEN_PART currentPart = PIECES;
+    for (char c : fen)
+    {
+        if (currentPart == PIECES)
+        {
+            Piece piece = pieceForSymbol(c);
+            if (piece != EMPTY)
+            {
+                if (file >= 8)
+                {
+                    throw std::invalid_argument("Invalid FEN: Rank has more than 8 files");
+                }
+                board.bitboards.toggle(piece, 1ULL << (rank * 8 + file));
+                file++;
+            }
+            else if (c >= '1' && c <= '8')
+            {
+                file += (c - '0');
+                if (file > 8)
+                {
+                    throw std::invalid_argument("Invalid FEN: Rank has more than 8 files");
+                }
+            }
+            else if (c == '/')
+            {
+                if (rank == 0)
+                {
+                    throw std::invalid_argument("Invalid FEN: More than 8 ranks");
+                }
+                rank--;
+                file = 0;
+            }
+            else if (c == ' ')
+            {
+                currentPart = TURN;
+            }
+            else
+            {
+                throw std::invalid_argument("Invalid FEN: Unknown piece character");
+            }
+        }
+        else if (currentPart == TURN)
+        {
+            if (c == 'w')
+            {
+                board.whiteTurn = true;
+            }
+            else if (c == 'b')
+            {
+                board.whiteTurn = false;
+            }
+            else if (c == ' ')
+            {
+                currentPart = CASTLING;
+            }
+            else
+            {
+                throw std::invalid_argument("Invalid FEN: Unknown turn character");
+            }
+        }
+        else if (currentPart == CASTLING)
+        {
+            if (c == 'K')
+            {
+                board.castlingRights |= 0b1000;
+            }
+            else if (c == 'Q')
+            {
+                board.castlingRights |= 0b0100;
+            }
+            else if (c == 'k')
+            {
+                board.castlingRights |= 0b0010;
+            }
+            else if (c == 'q')
+            {
+                board.castlingRights |= 0b0001;
+            }
+            else if (c == ' ')
+            {
+                currentPart = EN_PASSANT;
+            }
+        }
+        else if (currentPart == EN_PASSANT)
+        {
+            if (c >= 'a' && c <= 'h')
+            {
+                board.enPassantSquare = c - 'a';
+            }
+            else if (c >= '1' && c <= '8' && board.enPassantSquare >= 0 && board.enPassantSquare < 8)
+            {
+                // only a double pawn push leaves a target, always on the third or sixth rank
+                if (c != '3' && c != '6')
+                {
+                    throw std::invalid_argument("Invalid FEN: En passant square not on rank 3 or 6");
+                }
+                board.enPassantSquare += (c - '1') * 8;
+            }
+            else if (c == ' ')
+            {
+                currentPart = HALF_MOVE;
+            }
+        }
+        else if (currentPart == HALF_MOVE)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                board.halfmoveClock = board.halfmoveClock * 10 + (c - '0');
+            }
+            else if (c == ' ')
+            {
+                currentPart = FULL_MOVE;
+                board.fullmoveNumber = 0;
+            }
+        }
+        else if (c >= '0' && c <= '9')
+        {
+            board.fullmoveNumber = board.fullmoveNumber * 10 + (c - '0');
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (board.enPassantSquare >= 0 && board.enPassantSquare < 8)
+    {
+        throw std::invalid_argument("Invalid FEN: En passant square has no rank");
+    }
+    if (board.fullmoveNumber < 1)
+    {
+        board.fullmoveNumber = 1;
+    }
+    board.hashKey = board.computeHash();
+    return board;
+}
+constexpr Board::Piece Board::getPieceAtSquare(int square) const
+{
+    return static_cast<Piece>(bitboards.pieceAt(square));
+}
+constexpr uint64_t Board::getBitmaskForBoard() const
+{
+    return bitboards.occupancy();
+}
+constexpr void Board::placePiece(Piece piece, int square)
+{
+    uint64_t bitmask = 1ULL << square;
+    Piece replaced = getPieceAtSquare(square);
+    if (replaced != EMPTY)
+    {
+        bitboards.toggle(replaced, bitmask);
+        hashKey ^= Zobrist::KEYS.pieceSquare[replaced][square];
+    }
+    if (piece != EMPTY)
+    {
+        bitboards.toggle(piece, bitmask);
+        hashKey ^= Zobrist::KEYS.pieceSquare[piece][square];
+    }
+    attackCache.valid = false;
+}
+constexpr uint64_t Board::computeHash() const
+{
+    uint64_t key = Zobrist::KEYS.castling[castlingRights];
+    for (int piece = 0; piece < 12; ++piece)
+    {
+        for (uint64_t bitboard = bitboards.piece(piece); bitboard; bitboard &= bitboard - 1)
+        {
+            key ^= Zobrist::KEYS.pieceSquare[piece][__builtin_ctzll(bitboard)];
+        }
+    }
+    if (enPassantSquare >= 0)
+    {
+        key ^= Zobrist::KEYS.enPassantFile[enPassantSquare % 8];
+    }
+    if (!whiteTurn)
+    {
+        key ^= Zobrist::KEYS.blackToMove;
+    }
+    return key;
+}
+constexpr int Board::getSquareForPosition(std::string_view position)
+{
+    if (position.length() < 2)
+    {
+        throw std::invalid_argument("Invalid position format");
+    }
+
+    char file = position[0];
+    char rank = position[1];
+
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8')
+    {
+        throw std::invalid_argument("Position out of bounds");
+    }
+
+    int fileIndex = file - 'a';
+    int rankIndex = rank - '1';
+
+    return rankIndex * 8 + fileIndex;
+}
+constexpr uint64_t Board::getBitmaskForPosition(std::string_view position)
+{
+    return 1ULL << getSquareForPosition(position);
+}
+constexpr uint64_t Board::getBitmaskForRow(int row)
+{
+    if (row < 1 || row > 8)
+    {
+        throw std::invalid_argument("Row out of bounds");
+    }
+
+    return 0xFFULL << ((row - 1) * 8);
+}
+constexpr uint64_t Board::getBitmaskForColumn(char column)
+{
+    if (column < 'a' || column > 'h')
+    {
+        throw std::invalid_argument("Column out of bounds");
+    }
+
+    return getBitmaskForColumn(column - 'a' + 1);
+}
+constexpr uint64_t Board::getBitmaskForColumn(int column)
+{
+    if (column < 1 || column > 8)
+    {
+        throw std::invalid_argument("Column out of bounds");
+    }
+
+    return 0x0101010101010101ULL << (column - 1);
+}
\ No newline at end of file
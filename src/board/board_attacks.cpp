@@ -0,0 +1,82 @@
+#include "board.hpp"
+#include "movegen.hpp"
+
+uint64_t Board::attackersTo(int square, uint64_t occupancy) const
+{
+    uint64_t diagonal = bitboards.pieceType(WHITE_BISHOP) | bitboards.pieceType(WHITE_QUEEN);
+    uint64_t straight = bitboards.pieceType(WHITE_ROOK) | bitboards.pieceType(WHITE_QUEEN);
+
+    // a white pawn attacks `square` exactly when a black pawn on `square` would attack it back
+    return (Attacks::pawn(false, square) & bitboards.piece(WHITE_PAWN))
+         | (Attacks::pawn(true, square) & bitboards.piece(BLACK_PAWN))
+         | (Attacks::knight(square) & bitboards.pieceType(WHITE_KNIGHT))
+         | (Attacks::king(square) & bitboards.pieceType(WHITE_KING))
+         | (Attacks::bishop(square, occupancy) & diagonal)
+         | (Attacks::rook(square, occupancy) & straight);
+}
+bool Board::isSquareAttacked(int square, Color by) const
+{
+    return attackersTo(square, getBitmaskForBoard()) & getBitmaskForColor(by == WHITE);
+}
+bool Board::inCheck() const
+{
+    return checkers() != 0;
+}
+uint64_t Board::checkers() const
+{
+    if (!attackCache.valid)
+    {
+        updateAttackCache();
+    }
+    return attackCache.checkers;
+}
+uint64_t Board::pinned(Color color) const
+{
+    if (!attackCache.valid)
+    {
+        updateAttackCache();
+    }
+    return attackCache.pinned[color];
+}
+template<Board::Color Us> void Board::updatePins(uint64_t occupancy) const
+{
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    uint64_t king = bitboards.piece(pieceFor<Us>(WHITE_KING));
+    attackCache.pinned[Us] = 0;
+    if (!king)
+    {
+        return;
+    }
+    int kingSquare = __builtin_ctzll(king);
+    uint64_t own = getBitmaskForColor<Us>();
+
+    // enemy sliders that would see the king on an empty board
+    uint64_t queens = bitboards.piece(pieceFor<Them>(WHITE_QUEEN));
+    uint64_t snipers = ((bitboards.piece(pieceFor<Them>(WHITE_ROOK)) | queens) & Attacks::rook(kingSquare, 0))
+                     | ((bitboards.piece(pieceFor<Them>(WHITE_BISHOP)) | queens) & Attacks::bishop(kingSquare, 0));
+    while (snipers)
+    {
+        int sniper = __builtin_ctzll(snipers);
+        snipers &= snipers - 1;
+        uint64_t blockers = Attacks::between[kingSquare][sniper] & occupancy;
+        // exactly one piece in the way, and it is ours
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & own))
+        {
+            attackCache.pinned[Us] |= blockers;
+        }
+    }
+}
+void Board::updateAttackCache() const
+{
+    uint64_t occupancy = getBitmaskForBoard();
+    updatePins<WHITE>(occupancy);
+    updatePins<BLACK>(occupancy);
+
+    attackCache.checkers = 0;
+    uint64_t king = bitboards.piece(whiteTurn ? WHITE_KING : BLACK_KING);
+    if (king)
+    {
+        attackCache.checkers = attackersTo(__builtin_ctzll(king), occupancy) & getBitmaskForColor(!whiteTurn);
+    }
+    attackCache.valid = true;
+}
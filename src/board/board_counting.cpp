@@ -0,0 +1,120 @@
+#include "board.hpp"
+#include "movegen.hpp"
+#include "util/instrumentation.hpp"
+
+template<Board::Color Us> int Board::countAllMoves(uint64_t from, bool anyOnly) const
+{
+    MoveGenContext context = getMoveGenContext<Us>();
+    int count = 0;
+    if (context.kingSquare >= 0 && (from & (1ULL << context.kingSquare)))
+    {
+        count = __builtin_popcountll(getKingTargets<Us>(context));
+    }
+    uint64_t checking = checkers();
+    if ((anyOnly && count) || (checking & (checking - 1)))
+    {
+        return count;
+    }
+
+    count += countPawnMoves<Us>(context, from);
+    // knights, bishops, rooks and queens; a pinned knight never has a move
+    uint64_t targetMask = ~context.own & context.checkMask;
+    uint64_t diagonal = bitboards.piece(pieceFor<Us>(WHITE_BISHOP)) | bitboards.piece(pieceFor<Us>(WHITE_QUEEN));
+    uint64_t straight = bitboards.piece(pieceFor<Us>(WHITE_ROOK)) | bitboards.piece(pieceFor<Us>(WHITE_QUEEN));
+    for (uint64_t knights = bitboards.piece(pieceFor<Us>(WHITE_KNIGHT)) & ~context.pinned & from; knights; knights &= knights - 1)
+    {
+        count += __builtin_popcountll(Attacks::knight(__builtin_ctzll(knights)) & targetMask);
+    }
+    for (uint64_t sliders = (diagonal | straight) & from; sliders; sliders &= sliders - 1)
+    {
+        int square = __builtin_ctzll(sliders);
+        uint64_t bit = 1ULL << square;
+        uint64_t attacks = ((diagonal & bit) ? Attacks::bishop(square, context.occupancy) : 0)
+                         | ((straight & bit) ? Attacks::rook(square, context.occupancy) : 0);
+        count += __builtin_popcountll(attacks & targetMask & getPinMask(context, square));
+    }
+    return count;
+}
+int Board::countMoves() const
+{
+    CHESS_TIMED(MOVE_COUNT);
+    return whiteTurn ? countAllMoves<WHITE>(~0ULL, false) : countAllMoves<BLACK>(~0ULL, false);
+}
+int Board::countMovesFrom(int square) const
+{
+    uint64_t from = 1ULL << square;
+    return whiteTurn ? countAllMoves<WHITE>(from, false) : countAllMoves<BLACK>(from, false);
+}
+bool Board::hasLegalMoves() const
+{
+    return (whiteTurn ? countAllMoves<WHITE>(~0ULL, true) : countAllMoves<BLACK>(~0ULL, true)) != 0;
+}
+int Board::mobility(int square) const
+{
+    Piece piece = getPieceAtSquare(square);
+    if (piece == EMPTY)
+    {
+        return 0;
+    }
+    bool white = piece < BLACK_PAWN;
+    uint64_t own = getBitmaskForColor(white);
+    uint64_t occupancy = getBitmaskForBoard();
+    switch (piece)
+    {
+    case WHITE_PAWN:
+    case BLACK_PAWN:
+    {
+        uint64_t bit = 1ULL << square;
+        uint64_t push = (white ? bit << 8 : bit >> 8) & ~occupancy;
+        uint64_t startRank = white ? 0xFF00ULL : 0x00FF000000000000ULL;
+        uint64_t twice = (bit & startRank) ? (white ? push << 8 : push >> 8) & ~occupancy : 0;
+        uint64_t captures = Attacks::pawn(white, square) & occupancy & ~own;
+        return __builtin_popcountll(push | twice | captures);
+    }
+    case WHITE_KNIGHT:
+    case BLACK_KNIGHT:
+        return __builtin_popcountll(Attacks::knight(square) & ~own);
+    case WHITE_BISHOP:
+    case BLACK_BISHOP:
+        return __builtin_popcountll(Attacks::bishop(square, occupancy) & ~own);
+    case WHITE_ROOK:
+    case BLACK_ROOK:
+        return __builtin_popcountll(Attacks::rook(square, occupancy) & ~own);
+    case WHITE_QUEEN:
+    case BLACK_QUEEN:
+        return __builtin_popcountll(Attacks::queen(square, occupancy) & ~own);
+    default:
+        return __builtin_popcountll(Attacks::king(square) & ~own);
+    }
+}
+uint64_t Board::attackedSquares(Color by) const
+{
+    using namespace MoveGen;
+    uint64_t occupancy = getBitmaskForBoard();
+    Piece first = by == WHITE ? WHITE_PAWN : BLACK_PAWN;
+    uint64_t side[6];
+    for (int type = 0; type < 6; ++type)
+    {
+        side[type] = bitboards.piece(first + type);
+    }
+    uint64_t attacked = by == WHITE
+        ? pawnCapturesWest<WHITE>(side[0]) | pawnCapturesEast<WHITE>(side[0])
+        : pawnCapturesWest<BLACK>(side[0]) | pawnCapturesEast<BLACK>(side[0]);
+    for (uint64_t knights = side[1]; knights; knights &= knights - 1)
+    {
+        attacked |= Attacks::knight(__builtin_ctzll(knights));
+    }
+    for (uint64_t diagonal = side[2] | side[4]; diagonal; diagonal &= diagonal - 1)
+    {
+        attacked |= Attacks::bishop(__builtin_ctzll(diagonal), occupancy);
+    }
+    for (uint64_t straight = side[3] | side[4]; straight; straight &= straight - 1)
+    {
+        attacked |= Attacks::rook(__builtin_ctzll(straight), occupancy);
+    }
+    for (uint64_t kings = side[5]; kings; kings &= kings - 1)
+    {
+        attacked |= Attacks::king(__builtin_ctzll(kings));
+    }
+    return attacked;
+}
@@ -0,0 +1,64 @@
+#include "board.hpp"
+#include "movegen.hpp"
+#include "util/instrumentation.hpp"
+
+uint64_t Board::getTargetMask(const MoveList& moves)
+{
+    uint64_t mask = 0;
+    for (const Move& move : moves)
+    {
+        mask |= 1ULL << move.to;
+    }
+    return mask;
+}
+template<Board::Color Us> void Board::generateAllMoves(MoveList& moves) const
+{
+    MoveGenContext context = getMoveGenContext<Us>();
+    generateKingMoves<Us>(context, moves);
+    uint64_t checking = checkers();
+    if (checking & (checking - 1))
+    {
+        return;
+    }
+    generatePawnMoves<Us>(context, ~0ULL, moves);
+    generateKnightMoves<Us>(context, ~0ULL, moves);
+    generateBishopMoves<Us>(context, ~0ULL, moves);
+    generateRookMoves<Us>(context, ~0ULL, moves);
+    generateQueenMoves<Us>(context, ~0ULL, moves);
+}
+Board::MoveList Board::generateMoves() const
+{
+    CHESS_TIMED(MOVE_GENERATION);
+    MoveList moves;
+    // the only runtime colour branch; everything below is specialised
+    if (whiteTurn)
+    {
+        generateAllMoves<WHITE>(moves);
+    }
+    else
+    {
+        generateAllMoves<BLACK>(moves);
+    }
+    return moves;
+}
+uint64_t Board::perft(int depth)
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+    // bulk counting: the last ply only needs the number of moves
+    if (depth == 1)
+    {
+        return countMoves();
+    }
+    MoveList moves = generateMoves();
+    uint64_t nodes = 0;
+    for (const Move& move : moves)
+    {
+        UndoInfo undo = makeMove(move);
+        nodes += perft(depth - 1);
+        unmakeMove(move, undo);
+    }
+    return nodes;
+}
@@ -0,0 +1,180 @@
+#include "board.hpp"
+#include <stdexcept>
+
+namespace {
+    const char PIECE_LETTERS[6] = {'P', 'N', 'B', 'R', 'Q', 'K'};
+
+    // piece type (pawn .. king) for a SAN piece letter, or -1
+    int pieceTypeForLetter(char letter)
+    {
+        for (int type = 1; type < 6; ++type)
+        {
+            if (PIECE_LETTERS[type] == letter)
+            {
+                return type;
+            }
+        }
+        return -1;
+    }
+    std::string squareName(int square)
+    {
+        return {static_cast<char>('a' + square % 8), static_cast<char>('1' + square / 8)};
+    }
+}
+
+Board::Move Board::parseSAN(std::string san) const
+{
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+    {
+        san.pop_back();
+    }
+    MoveList moves = generateMoves();
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+    {
+        int from = whiteTurn ? 4 : 60;
+        int to = san.length() == 3 ? from + 2 : from - 2;
+        for (const Move& move : moves)
+        {
+            if (move.from == from && move.to == to && getPieceAtSquare(from) == (whiteTurn ? WHITE_KING : BLACK_KING))
+            {
+                return move;
+            }
+        }
+        throw std::invalid_argument("Illegal castling move: " + san);
+    }
+
+    int type = 0;
+    size_t start = 0;
+    if (!san.empty() && pieceTypeForLetter(san[0]) > 0)
+    {
+        type = pieceTypeForLetter(san[0]);
+        start = 1;
+    }
+    Piece promotion = EMPTY;
+    size_t equals = san.find('=');
+    if (equals != std::string::npos || (type == 0 && san.length() > 2 && pieceTypeForLetter(san.back()) > 0))
+    {
+        int promotionType = pieceTypeForLetter(san.back());
+        if (promotionType <= 0 || promotionType == 5)
+        {
+            throw std::invalid_argument("Invalid promotion: " + san);
+        }
+        promotion = static_cast<Piece>(promotionType + (whiteTurn ? 0 : 6));
+        san = san.substr(0, equals != std::string::npos ? equals : san.length() - 1);
+    }
+    if (san.length() < start + 2)
+    {
+        throw std::invalid_argument("Invalid move: " + san);
+    }
+    int to = getSquareForPosition(san.substr(san.length() - 2));
+
+    // whatever is left between the piece letter and the destination narrows down the origin
+    int fromFile = -1;
+    int fromRank = -1;
+    for (size_t i = start; i < san.length() - 2; ++i)
+    {
+        if (san[i] >= 'a' && san[i] <= 'h')
+        {
+            fromFile = san[i] - 'a';
+        }
+        else if (san[i] >= '1' && san[i] <= '8')
+        {
+            fromRank = san[i] - '1';
+        }
+        else if (san[i] != 'x' && san[i] != '-')
+        {
+            throw std::invalid_argument("Invalid move: " + san);
+        }
+    }
+
+    Piece piece = static_cast<Piece>(type + (whiteTurn ? 0 : 6));
+    const Move* found = nullptr;
+    for (const Move& move : moves)
+    {
+        if (move.to != to || move.promotion != promotion || getPieceAtSquare(move.from) != piece
+            || (fromFile >= 0 && move.from % 8 != fromFile) || (fromRank >= 0 && move.from / 8 != fromRank))
+        {
+            continue;
+        }
+        if (found)
+        {
+            throw std::invalid_argument("Ambiguous move: " + san);
+        }
+        found = &move;
+    }
+    if (!found)
+    {
+        throw std::invalid_argument("Illegal move: " + san);
+    }
+    return *found;
+}
+std::string Board::toSAN(Move move) const
+{
+    Piece piece = getPieceAtSquare(move.from);
+    int type = piece % 6;
+    bool capture = getPieceAtSquare(move.to) != EMPTY || (type == 0 && move.to == enPassantSquare);
+    std::string san;
+
+    if (type == 5 && (move.to - move.from == 2 || move.from - move.to == 2))
+    {
+        san = move.to > move.from ? "O-O" : "O-O-O";
+    }
+    else if (type == 0)
+    {
+        if (capture)
+        {
+            san += static_cast<char>('a' + move.from % 8);
+            san += 'x';
+        }
+        san += squareName(move.to);
+        if (move.promotion != EMPTY)
+        {
+            san += '=';
+            san += PIECE_LETTERS[move.promotion % 6];
+        }
+    }
+    else
+    {
+        san += PIECE_LETTERS[type];
+        // disambiguate against other pieces of the same kind that reach the same square
+        bool sameFile = false, sameRank = false, ambiguous = false;
+        for (const Move& other : generateMoves())
+        {
+            if (other.to == move.to && other.from != move.from && getPieceAtSquare(other.from) == piece)
+            {
+                ambiguous = true;
+                sameFile |= other.from % 8 == move.from % 8;
+                sameRank |= other.from / 8 == move.from / 8;
+            }
+        }
+        if (ambiguous)
+        {
+            if (!sameFile)
+            {
+                san += static_cast<char>('a' + move.from % 8);
+            }
+            else if (!sameRank)
+            {
+                san += static_cast<char>('1' + move.from / 8);
+            }
+            else
+            {
+                san += squareName(move.from);
+            }
+        }
+        if (capture)
+        {
+            san += 'x';
+        }
+        san += squareName(move.to);
+    }
+
+    Board after = *this;
+    after.makeMove(move);
+    if (after.inCheck())
+    {
+        san += after.hasLegalMoves() ? '+' : '#';
+    }
+    return san;
+}
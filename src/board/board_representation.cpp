@@ -1,4 +1,5 @@
 #include "board.hpp"
+#include "util/instrumentation.hpp"
 
 std::string Board::boardToString() const
 {
@@ -9,51 +10,51 @@ std::string Board::boardToString() const
         {
             uint64_t square = 1ULL << (row * 8 + col);
 
-            if (pieces[WHITE_PAWN] & square)
+            if (bitboards.piece(WHITE_PAWN) & square)
             {
                 boardRepresentation += 'P';
             }
-            else if (pieces[WHITE_KNIGHT] & square)
+            else if (bitboards.piece(WHITE_KNIGHT) & square)
             {
                 boardRepresentation += 'N';
             }
-            else if (pieces[WHITE_BISHOP] & square)
+            else if (bitboards.piece(WHITE_BISHOP) & square)
             {
                 boardRepresentation += 'B';
             }
-            else if (pieces[WHITE_ROOK] & square)
+            else if (bitboards.piece(WHITE_ROOK) & square)
             {
                 boardRepresentation += 'R';
             }
-            else if (pieces[WHITE_QUEEN] & square)
+            else if (bitboards.piece(WHITE_QUEEN) & square)
             {
                 boardRepresentation += 'Q';
             }
-            else if (pieces[WHITE_KING] & square)
+            else if (bitboards.piece(WHITE_KING) & square)
             {
                 boardRepresentation += 'K';
             }
-            else if (pieces[BLACK_PAWN] & square)
+            else if (bitboards.piece(BLACK_PAWN) & square)
             {
                 boardRepresentation += 'p';
             }
-            else if (pieces[BLACK_KNIGHT] & square)
+            else if (bitboards.piece(BLACK_KNIGHT) & square)
             {
                 boardRepresentation += 'n';
             }
-            else if (pieces[BLACK_BISHOP] & square)
+            else if (bitboards.piece(BLACK_BISHOP) & square)
             {
                 boardRepresentation += 'b';
             }
-            else if (pieces[BLACK_ROOK] & square)
+            else if (bitboards.piece(BLACK_ROOK) & square)
             {
                 boardRepresentation += 'r';
             }
-            else if (pieces[BLACK_QUEEN] & square)
+            else if (bitboards.piece(BLACK_QUEEN) & square)
             {
                 boardRepresentation += 'q';
             }
-            else if (pieces[BLACK_KING] & square)
+            else if (bitboards.piece(BLACK_KING) & square)
             {
                 boardRepresentation += 'k';
             }
@@ -76,6 +77,7 @@ std::string Board::boardToString() const
 }
 std::string Board::generateFEN() const
 {
+    CHESS_TIMED(FEN_EMIT);
     std::string fen;
     for (int rank = 7; rank >= 0; --rank)
     {
@@ -83,7 +85,7 @@ std::string Board::generateFEN() const
         for (int file = 0; file < 8; ++file)
         {
             uint64_t square = 1ULL << (rank * 8 + file);
-            if (pieces[WHITE_PAWN] & square)
+            if (bitboards.piece(WHITE_PAWN) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -92,7 +94,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'P';
             }
-            else if (pieces[WHITE_KNIGHT] & square)
+            else if (bitboards.piece(WHITE_KNIGHT) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -101,7 +103,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'N';
             }
-            else if (pieces[WHITE_BISHOP] & square)
+            else if (bitboards.piece(WHITE_BISHOP) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -110,7 +112,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'B';
             }
-            else if (pieces[WHITE_ROOK] & square)
+            else if (bitboards.piece(WHITE_ROOK) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -119,7 +121,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'R';
             }
-            else if (pieces[WHITE_QUEEN] & square)
+            else if (bitboards.piece(WHITE_QUEEN) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -128,7 +130,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'Q';
             }
-            else if (pieces[WHITE_KING] & square)
+            else if (bitboards.piece(WHITE_KING) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -137,7 +139,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'K';
             }
-            else if (pieces[BLACK_PAWN] & square)
+            else if (bitboards.piece(BLACK_PAWN) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -146,7 +148,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'p';
             }
-            else if (pieces[BLACK_KNIGHT] & square)
+            else if (bitboards.piece(BLACK_KNIGHT) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -155,7 +157,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'n';
             }
-            else if (pieces[BLACK_BISHOP] & square)
+            else if (bitboards.piece(BLACK_BISHOP) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -164,7 +166,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'b';
             }
-            else if (pieces[BLACK_ROOK] & square)
+            else if (bitboards.piece(BLACK_ROOK) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -173,7 +175,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'r';
             }
-            else if (pieces[BLACK_QUEEN] & square)
+            else if (bitboards.piece(BLACK_QUEEN) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -182,7 +184,7 @@ std::string Board::generateFEN() const
                 }
                 fen += 'q';
             }
-            else if (pieces[BLACK_KING] & square)
+            else if (bitboards.piece(BLACK_KING) & square)
             {
                 if (emptyCount > 0)
                 {
@@ -220,7 +222,15 @@ std::string Board::generateFEN() const
     fen += castling.empty() ? "-" : castling;
 
     fen += " ";
-    fen += (enPassantSquare == -1) ? "-" : std::to_string(enPassantSquare);
+    if (enPassantSquare == -1)
+    {
+        fen += "-";
+    }
+    else
+    {
+        fen += static_cast<char>('a' + enPassantSquare % 8);
+        fen += static_cast<char>('1' + enPassantSquare / 8);
+    }
 
     return fen;
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "board.hpp"
+#include "attacks.hpp"
+
+namespace {
+    // exchange values indexed by piece type (pawn .. king), shared by both colours
+    constexpr int SEE_VALUES[6] = {100, 320, 330, 500, 900, 20000};
+}
+
+bool Board::see(Move move, int threshold) const
+{
+    Piece mover = getPieceAtSquare(move.from);
+    Piece victim = getPieceAtSquare(move.to);
+    bool whiteToMove = mover <= WHITE_KING;
+    bool enPassant = (mover == WHITE_PAWN || mover == BLACK_PAWN) && move.to == enPassantSquare;
+
+    // what we win if the opponent does not recapture
+    int swap = (victim == EMPTY ? (enPassant ? SEE_VALUES[0] : 0) : SEE_VALUES[victim % 6]) - threshold;
+    if (swap < 0)
+    {
+        return false;
+    }
+    // what we still have if the moved piece is lost for nothing
+    swap = SEE_VALUES[mover % 6] - swap;
+    if (swap <= 0)
+    {
+        return true;
+    }
+
+    uint64_t occupied = getBitmaskForBoard() ^ (1ULL << move.from) ^ (1ULL << move.to);
+    if (enPassant)
+    {
+        occupied ^= 1ULL << (whiteToMove ? move.to - 8 : move.to + 8);
+    }
+    uint64_t diagonal = bitboards.pieceType(WHITE_BISHOP) | bitboards.pieceType(WHITE_QUEEN);
+    uint64_t straight = bitboards.pieceType(WHITE_ROOK) | bitboards.pieceType(WHITE_QUEEN);
+    uint64_t attackers = attackersTo(move.to, occupied);
+
+    // res flips every time a side recaptures; it ends as 1 if the mover comes out ahead
+    int res = 1;
+    bool stm = whiteToMove;
+    while (true)
+    {
+        stm = !stm;
+        attackers &= occupied;
+        uint64_t stmAttackers = attackers & getBitmaskForColor(stm);
+        if (!stmAttackers)
+        {
+            break;
+        }
+        res ^= 1;
+
+        // pick the least valuable attacker; stmAttackers already holds one colour
+        int type = 0;
+        uint64_t candidates = stmAttackers & bitboards.pieceType(WHITE_PAWN);
+        while (!candidates && type < 5)
+        {
+            candidates = stmAttackers & bitboards.pieceType(++type);
+        }
+        if (type == 5)
+        {
+            // the king may only recapture if nothing defends the square any more
+            return (attackers & getBitmaskForColor(!stm)) ? res ^ 1 : res;
+        }
+        if ((swap = SEE_VALUES[type] - swap) < res)
+        {
+            break;
+        }
+
+        // remove the attacker and uncover any slider standing behind it
+        occupied ^= candidates & (0 - candidates);
+        if (type == 0 || type == 2 || type == 4)
+        {
+            attackers |= Attacks::bishop(move.to, occupied) & diagonal;
+        }
+        if (type == 3 || type == 4)
+        {
+            attackers |= Attacks::rook(move.to, occupied) & straight;
+        }
+    }
+    return res;
+}
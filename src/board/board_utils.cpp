@@ -69,62 +69,43 @@ int Board::compareColumn(std::string position, int targetColumn)
 
     return (posColumn - 'a' + 1) - targetColumn;
 }
-// === Bitmask Utils ===
-uint64_t Board::getBitmaskForPosition(std::string position)
+Board::Move Board::parseMove(std::string move)
 {
-    if (position.length() < 2)
-    {
-        throw std::invalid_argument("Invalid position format");
-    }
-
-    char file = position[0];
-    char rank = position[1];
-
-    if (file < 'a' || file > 'h' || rank < '1' || rank > '8')
-    {
-        throw std::invalid_argument("Position out of bounds");
-    }
-
-    int fileIndex = file - 'a';
-    int rankIndex = rank - '1';
-
-    return 1ULL << (rankIndex * 8 + fileIndex);
-}
-uint64_t Board::getBitmaskForRow(int row)
-{
-    if (row < 1 || row > 8)
-    {
-        throw std::invalid_argument("Row out of bounds");
-    }
-
-    return 0xFFULL << ((row - 1) * 8);
-}
-uint64_t Board::getBitmaskForColumn(char column)
-{
-    if (column < 'a' || column > 'h')
-    {
-        throw std::invalid_argument("Column out of bounds");
-    }
-
-    uint64_t bitmask = 0;
-    int colIndex = column - 'a';
-
-    return getBitmaskForColumn(colIndex + 1);
-}
-uint64_t Board::getBitmaskForColumn(int column)
-{
-    if (column < 1 || column > 8)
-    {
-        throw std::invalid_argument("Column out of bounds");
-    }
-
-    uint64_t bitmask = 0;
-    int colIndex = column - 1;
-
-    for (int row = 0; row < 8; ++row)
-    {
-        bitmask |= (1ULL << (row * 8 + colIndex));
-    }
-
-    return bitmask;
+    size_t separator = move.find(' ');
+    if (separator == std::string::npos)
+    {
+        throw std::invalid_argument("Invalid move format");
+    }
+    std::string target = move.substr(separator + 1);
+
+    Move result;
+    result.from = getSquareForPosition(move.substr(0, separator));
+    result.to = getSquareForPosition(target);
+    if (target.length() > 2)
+    {
+        // the promotion rank decides the colour of the new piece
+        bool white = result.to >= 56;
+        switch (target[2])
+        {
+        case 'n':
+        case 'N':
+            result.promotion = white ? WHITE_KNIGHT : BLACK_KNIGHT;
+            break;
+        case 'b':
+        case 'B':
+            result.promotion = white ? WHITE_BISHOP : BLACK_BISHOP;
+            break;
+        case 'r':
+        case 'R':
+            result.promotion = white ? WHITE_ROOK : BLACK_ROOK;
+            break;
+        case 'q':
+        case 'Q':
+            result.promotion = white ? WHITE_QUEEN : BLACK_QUEEN;
+            break;
+        default:
+            throw std::invalid_argument("Invalid promotion piece");
+        }
+    }
+    return result;
 }
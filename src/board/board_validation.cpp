@@ -0,0 +1,207 @@
+#include "board.hpp"
+#include "movegen.hpp"
+#include <stdexcept>
+
+template<Board::Color Us> Board::MoveError Board::validateMoveFor(int from, int to, Piece promotion) const
+{
+    using namespace MoveGen;
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr bool white = Us == WHITE;
+    uint64_t fromBit = 1ULL << from;
+    uint64_t toBit = 1ULL << to;
+    MoveGenContext context = getMoveGenContext<Us>();
+    if (!(context.own & fromBit))
+    {
+        return (context.enemy & fromBit) ? MOVE_WRONG_SIDE : MOVE_NO_PIECE;
+    }
+    if (context.own & toBit)
+    {
+        return MOVE_OWN_PIECE;
+    }
+    Piece piece = getPieceAtSquare(from);
+    bool promotes = piece == pieceFor<Us>(WHITE_PAWN) && (toBit & PROMOTION_RANK<Us>);
+    if (promotes ? (promotion < pieceFor<Us>(WHITE_KNIGHT) || promotion > pieceFor<Us>(WHITE_QUEEN)) : promotion != EMPTY)
+    {
+        return MOVE_BAD_PROMOTION;
+    }
+
+    if (piece == pieceFor<Us>(WHITE_KING))
+    {
+        if (Attacks::king(from) & toBit)
+        {
+            // the king must not hide behind itself from a slider
+            return isAttackedBy<Them>(to, context.occupancy ^ fromBit) ? MOVE_LEAVES_KING_IN_CHECK : MOVE_OK;
+        }
+        // the only other king move is castling, which getKingTargets() already checks in full
+        return (getKingTargets<Us>(context) & toBit) ? MOVE_OK : MOVE_UNREACHABLE;
+    }
+
+    uint64_t reachable;
+    switch (piece - pieceFor<Us>(WHITE_PAWN))
+    {
+    case WHITE_PAWN:
+    {
+        uint64_t push = pawnPushes<Us>(fromBit) & ~context.occupancy;
+        reachable = push | (pawnPushes<Us>(push & DOUBLE_PUSH_RANK<Us>) & ~context.occupancy)
+                  | (Attacks::pawn(white, from) & context.enemy);
+        if (to == enPassantSquare && (Attacks::pawn(white, from) & toBit))
+        {
+            // two pawns leave one rank, so test the king against the resulting occupancy
+            uint64_t capturedBit = 1ULL << (enPassantSquare - UP<Us>);
+            uint64_t occupancy = (context.occupancy ^ fromBit ^ capturedBit) | toBit;
+            bool exposed = context.kingSquare >= 0
+                && (attackersTo(context.kingSquare, occupancy) & context.enemy & ~capturedBit);
+            return exposed ? MOVE_LEAVES_KING_IN_CHECK : MOVE_OK;
+        }
+        break;
+    }
+    case WHITE_KNIGHT:
+        reachable = Attacks::knight(from);
+        break;
+    case WHITE_BISHOP:
+        reachable = Attacks::bishop(from, context.occupancy);
+        break;
+    case WHITE_ROOK:
+        reachable = Attacks::rook(from, context.occupancy);
+        break;
+    default:
+        reachable = Attacks::queen(from, context.occupancy);
+        break;
+    }
+    if (!(reachable & toBit))
+    {
+        return MOVE_UNREACHABLE;
+    }
+    // in double check checkMask still admits capturing one checker, which does not help
+    uint64_t checking = checkers();
+    if ((checking & (checking - 1)) || !(toBit & context.checkMask & getPinMask(context, from)))
+    {
+        return MOVE_LEAVES_KING_IN_CHECK;
+    }
+    return MOVE_OK;
+}
+Board::MoveError Board::validateMove(int from, int to, Piece promotion) const noexcept
+{
+    if (from < 0 || from > 63 || to < 0 || to > 63)
+    {
+        return MOVE_OFF_BOARD;
+    }
+    if (promotion < WHITE_PAWN || promotion > EMPTY)
+    {
+        return MOVE_BAD_PROMOTION;
+    }
+    return whiteTurn ? validateMoveFor<WHITE>(from, to, promotion) : validateMoveFor<BLACK>(from, to, promotion);
+}
+const char* Board::describeMoveError(MoveError error)
+{
+    switch (error)
+    {
+    case MOVE_OK:
+        return "legal move";
+    case MOVE_OFF_BOARD:
+        return "square off the board";
+    case MOVE_NO_PIECE:
+        return "no piece to move";
+    case MOVE_WRONG_SIDE:
+        return "not that side's turn";
+    case MOVE_OWN_PIECE:
+        return "destination holds own piece";
+    case MOVE_UNREACHABLE:
+        return "piece cannot move there";
+    case MOVE_BAD_PROMOTION:
+        return "illegal promotion";
+    case MOVE_LEAVES_KING_IN_CHECK:
+        return "king would be in check";
+    }
+    return "unknown error";
+}
+Board::FENError Board::tryFromFEN(std::string_view fen, Board& board) noexcept
+{
+    // fromFEN() tolerates short ranks and a missing side to move, so the first two fields are checked here
+    size_t placementEnd = fen.find(' ');
+    if (placementEnd == std::string_view::npos || fen.size() < placementEnd + 2
+        || (fen[placementEnd + 1] != 'w' && fen[placementEnd + 1] != 'b')
+        || (fen.size() > placementEnd + 2 && fen[placementEnd + 2] != ' '))
+    {
+        return FEN_MALFORMED;
+    }
+    int ranks = 1;
+    int files = 0;
+    for (char c : fen.substr(0, placementEnd))
+    {
+        if (c == '/')
+        {
+            if (files != 8)
+            {
+                return FEN_MALFORMED;
+            }
+            ranks++;
+            files = 0;
+        }
+        else
+        {
+            files += c >= '1' && c <= '8' ? c - '0' : 1;
+        }
+    }
+    if (ranks != 8 || files != 8)
+    {
+        return FEN_MALFORMED;
+    }
+    try
+    {
+        board = parseFEN(fen);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return FEN_MALFORMED;
+    }
+
+    uint64_t whiteKing = board.bitboards.piece(WHITE_KING);
+    uint64_t blackKing = board.bitboards.piece(BLACK_KING);
+    if (__builtin_popcountll(whiteKing) != 1 || __builtin_popcountll(blackKing) != 1)
+    {
+        return FEN_KING_COUNT;
+    }
+    constexpr uint64_t BACK_RANKS = 0xFF000000000000FFULL;
+    if ((board.bitboards.piece(WHITE_PAWN) | board.bitboards.piece(BLACK_PAWN)) & BACK_RANKS)
+    {
+        return FEN_PAWN_ON_BACK_RANK;
+    }
+    if (board.enPassantSquare >= 0)
+    {
+        // the pushed pawn stands one rank past the target, and the two squares it crossed are empty
+        int target = board.enPassantSquare;
+        int pushed = board.whiteTurn ? target - 8 : target + 8;
+        int origin = board.whiteTurn ? target + 8 : target - 8;
+        if (target / 8 != (board.whiteTurn ? 5 : 2)
+            || board.getPieceAtSquare(pushed) != (board.whiteTurn ? BLACK_PAWN : WHITE_PAWN)
+            || board.getPieceAtSquare(target) != EMPTY || board.getPieceAtSquare(origin) != EMPTY)
+        {
+            return FEN_BAD_EN_PASSANT;
+        }
+    }
+    if (board.attackedSquares(board.whiteTurn ? WHITE : BLACK) & (board.whiteTurn ? blackKing : whiteKing))
+    {
+        return FEN_OPPONENT_IN_CHECK;
+    }
+    return FEN_OK;
+}
+const char* Board::describeFENError(FENError error)
+{
+    switch (error)
+    {
+    case FEN_OK:
+        return "valid position";
+    case FEN_MALFORMED:
+        return "malformed FEN";
+    case FEN_KING_COUNT:
+        return "not one king per side";
+    case FEN_PAWN_ON_BACK_RANK:
+        return "pawn on back rank";
+    case FEN_BAD_EN_PASSANT:
+        return "impossible en passant square";
+    case FEN_OPPONENT_IN_CHECK:
+        return "side not to move is in check";
+    }
+    return "unknown error";
+}
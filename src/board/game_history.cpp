@@ -0,0 +1,42 @@
+#include "game_history.hpp"
+
+int GameHistory::reach(const Board& board) const
+{
+    return std::min<int>(board.getHalfmoveClock(), size());
+}
+void GameHistory::play(Board& board, const Board::Move& move)
+{
+    push(board);
+    board.makeMove(move);
+    if (board.getHalfmoveClock() == 0)
+    {
+        clear();
+    }
+}
+bool GameHistory::isRepetition(const Board& board) const
+{
+    int limit = reach(board);
+    // the same side is to move every second ply, and going back two plies
+    // cannot restore a position, so the first candidate is four plies back
+    for (int distance = 4; distance <= limit; distance += 2)
+    {
+        if (key(distance) == board.getHash())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+int GameHistory::repetitionCount(const Board& board) const
+{
+    int limit = reach(board);
+    int repeats = 0;
+    for (int distance = 4; distance <= limit; distance += 2)
+    {
+        if (key(distance) == board.getHash())
+        {
+            repeats++;
+        }
+    }
+    return repeats;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "board.hpp"
+
+/**
+ * @brief Zobrist keys of the positions a game went through, for repetition checks.
+ *
+ * Kept apart from Board so that a Board stays a small value type that searches
+ * and playouts copy freely. Whoever plays the moves keeps the history in step:
+ * push() the position before each move and pop() after taking it back.
+ *
+ *     history.push(board);
+ *     Board::UndoInfo undo = board.makeMove(move);
+ *     ...
+ *     board.unmakeMove(move, undo);
+ *     history.pop();
+ *
+ * The keys live in a fixed ring of CAPACITY entries, so a history never
+ * allocates and copying one costs the same however long the game runs. Only
+ * positions since the last capture or pawn move can repeat, and play() drops
+ * the older ones, so a game stopped by the fifty-move rule never holds more
+ * than a hundred. pop() cannot bring back the keys that pushes past
+ * the capacity overwrote: a line of n plies pushed on top of a game keeps the
+ * last CAPACITY - n positions exact.
+ */
+class GameHistory {
+    public:
+    static constexpr uint32_t CAPACITY = 256;
+
+    private:
+    uint64_t keys[CAPACITY];
+    uint32_t count = 0; // pushes not yet popped, which may exceed CAPACITY
+
+    uint64_t key(uint32_t distance) const { return keys[(count - distance) % CAPACITY]; }
+    int reach(const Board& board) const;
+
+    public:
+    /**
+     * @brief Records `board` as the position before the next move.
+     */
+    void push(const Board& board)
+    {
+        keys[count % CAPACITY] = board.getHash();
+        count++;
+    }
+    /**
+     * @brief Forgets the position pushed last, when its move is taken back.
+     */
+    void pop() { count--; }
+    void clear() { count = 0; }
+    /**
+     * @brief Plays `move` on `board` for good, dropping the positions it makes unrepeatable.
+     */
+    void play(Board& board, const Board::Move& move);
+    /**
+     * @brief Returns how many of the recorded positions are still held, at most CAPACITY.
+     */
+    size_t size() const { return std::min(count, CAPACITY); }
+    /**
+     * @brief Returns true if `board` occurred before in this game.
+     *
+     * Only positions since the last capture or pawn move can repeat, and only
+     * every other one has the same side to move, so this compares at most
+     * board.getHalfmoveClock() / 2 hashes. Searches treat a single repetition as a draw.
+     */
+    bool isRepetition(const Board& board) const;
+    /**
+     * @brief Returns how many times `board` occurred before in this game.
+     */
+    int repetitionCount(const Board& board) const;
+    /**
+     * @brief Returns true once `board` has occurred three times.
+     */
+    bool isThreefoldRepetition(const Board& board) const { return repetitionCount(board) >= 2; }
+};
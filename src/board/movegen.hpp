@@ -0,0 +1,83 @@
+#pragma once
+
+#include "board.hpp"
+#include "attacks.hpp"
+
+// Colour-specialised helpers shared by the move generators, inline so they
+// fold into each generator. Internal to the board module.
+namespace MoveGen {
+    constexpr uint64_t FILE_A = 0x0101010101010101ULL;
+    constexpr uint64_t FILE_H = FILE_A << 7;
+    constexpr uint64_t RANK_1 = 0xFFULL;
+    constexpr uint64_t RANK_8 = RANK_1 << 56;
+
+    // one square forward for `Us`
+    template<Board::Color Us> constexpr int UP = Us == Board::WHITE ? 8 : -8;
+    // captures towards the a-file and the h-file
+    template<Board::Color Us> constexpr int UP_WEST = UP<Us> - 1;
+    template<Board::Color Us> constexpr int UP_EAST = UP<Us> + 1;
+    // where a single push lands when the pawn may still push again
+    template<Board::Color Us> constexpr uint64_t DOUBLE_PUSH_RANK = Us == Board::WHITE ? RANK_1 << 16 : RANK_1 << 40;
+    template<Board::Color Us> constexpr uint64_t PROMOTION_RANK = Us == Board::WHITE ? RANK_8 : RANK_1;
+
+    template<int Delta> constexpr uint64_t shift(uint64_t bitboard)
+    {
+        return Delta > 0 ? bitboard << Delta : bitboard >> -Delta;
+    }
+    template<Board::Color Us> constexpr uint64_t pawnPushes(uint64_t pawns)
+    {
+        return shift<UP<Us>>(pawns);
+    }
+    template<Board::Color Us> constexpr uint64_t pawnCapturesWest(uint64_t pawns)
+    {
+        return shift<UP_WEST<Us>>(pawns & ~FILE_A);
+    }
+    template<Board::Color Us> constexpr uint64_t pawnCapturesEast(uint64_t pawns)
+    {
+        return shift<UP_EAST<Us>>(pawns & ~FILE_H);
+    }
+}
+
+template<Board::Color Us> inline uint64_t Board::getBitmaskForColor() const
+{
+    return bitboards.color(Us == WHITE);
+}
+template<Board::Color Them> inline bool Board::isAttackedBy(int square, uint64_t occupancy) const
+{
+    // a pawn of `Them` attacks `square` exactly when a pawn of ours there would attack it back
+    constexpr bool usWhite = Them == BLACK;
+    uint64_t queens = bitboards.piece(pieceFor<Them>(WHITE_QUEEN));
+    return (Attacks::knight(square) & bitboards.piece(pieceFor<Them>(WHITE_KNIGHT)))
+        || (Attacks::pawn(usWhite, square) & bitboards.piece(pieceFor<Them>(WHITE_PAWN)))
+        || (Attacks::king(square) & bitboards.piece(pieceFor<Them>(WHITE_KING)))
+        || (Attacks::bishop(square, occupancy) & (bitboards.piece(pieceFor<Them>(WHITE_BISHOP)) | queens))
+        || (Attacks::rook(square, occupancy) & (bitboards.piece(pieceFor<Them>(WHITE_ROOK)) | queens));
+}
+template<Board::Color Us> inline Board::MoveGenContext Board::getMoveGenContext() const
+{
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    MoveGenContext context;
+    context.own = getBitmaskForColor<Us>();
+    context.enemy = getBitmaskForColor<Them>();
+    context.occupancy = context.own | context.enemy;
+    uint64_t king = bitboards.piece(pieceFor<Us>(WHITE_KING));
+    context.kingSquare = king ? __builtin_ctzll(king) : -1;
+    context.pinned = pinned(Us);
+
+    uint64_t checking = checkers();
+    context.checkMask = ~0ULL;
+    if (checking)
+    {
+        // capture the checker or block it; double checks only leave king moves
+        context.checkMask = Attacks::between[context.kingSquare][__builtin_ctzll(checking)] | checking;
+    }
+    return context;
+}
+inline uint64_t Board::getPinMask(const MoveGenContext& context, int square) const
+{
+    if (context.pinned & (1ULL << square))
+    {
+        return Attacks::line[context.kingSquare][square];
+    }
+    return ~0ULL;
+}
@@ -1,6 +1,102 @@
 #include "../board.hpp"
+#include "../movegen.hpp"
+namespace {
+    // castling squares for one side and direction, relative to a1
+    struct CastlingPath {
+        int right;
+        int kingFrom;
+        int kingTo;
+        int rookFrom;
+        uint64_t mustBeEmpty;
+        uint64_t mustBeSafe;
+    };
+    constexpr CastlingPath CASTLING_PATHS[4] = {
+        {0b1000, 4, 6, 7, 0x0000000000000060ULL, 0x0000000000000060ULL},   // K: f1 g1
+        {0b0100, 4, 2, 0, 0x000000000000000EULL, 0x000000000000000CULL},   // Q: b1 c1 d1, king crosses c1 d1
+        {0b0010, 60, 62, 63, 0x6000000000000000ULL, 0x6000000000000000ULL}, // k: f8 g8
+        {0b0001, 60, 58, 56, 0x0E00000000000000ULL, 0x0C00000000000000ULL}  // q: b8 c8 d8, king crosses c8 d8
+    };
+}
+template<Board::Color Us> uint64_t Board::getKingTargets(const MoveGenContext& context) const
+{
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    if (context.kingSquare < 0)
+    {
+        return 0;
+    }
+    // the king must not hide behind itself from a slider, so take it off the board
+    uint64_t occupancy = context.occupancy ^ (1ULL << context.kingSquare);
+    uint64_t candidates = Attacks::king(context.kingSquare) & ~context.own;
+    uint64_t targets = 0;
+    while (candidates)
+    {
+        int target = __builtin_ctzll(candidates);
+        candidates &= candidates - 1;
+        if (!isAttackedBy<Them>(target, occupancy))
+        {
+            targets |= 1ULL << target;
+        }
+    }
+
+    if (checkers())
+    {
+        return targets;
+    }
+    // castling lands two squares away, so it never overlaps a single king step
+    uint64_t rooks = bitboards.piece(pieceFor<Us>(WHITE_ROOK));
+    constexpr int first = Us == WHITE ? 0 : 2;
+    for (int i = first; i < first + 2; ++i)
+    {
+        const CastlingPath& path = CASTLING_PATHS[i];
+        if (!(castlingRights & path.right) || context.kingSquare != path.kingFrom
+            || !(rooks & (1ULL << path.rookFrom)) || (context.occupancy & path.mustBeEmpty))
+        {
+            continue;
+        }
+        bool safe = true;
+        for (uint64_t squares = path.mustBeSafe; squares && safe; squares &= squares - 1)
+        {
+            safe = !isAttackedBy<Them>(__builtin_ctzll(squares), context.occupancy);
+        }
+        if (safe)
+        {
+            targets |= 1ULL << path.kingTo;
+        }
+    }
+    return targets;
+}
+template uint64_t Board::getKingTargets<Board::WHITE>(const MoveGenContext&) const;
+template uint64_t Board::getKingTargets<Board::BLACK>(const MoveGenContext&) const;
+
+template<Board::Color Us> void Board::generateKingMoves(const MoveGenContext& context, MoveList& moves) const
+{
+    for (uint64_t targets = getKingTargets<Us>(context); targets; targets &= targets - 1)
+    {
+        moves.add(context.kingSquare, __builtin_ctzll(targets));
+    }
+}
+template void Board::generateKingMoves<Board::WHITE>(const MoveGenContext&, MoveList&) const;
+template void Board::generateKingMoves<Board::BLACK>(const MoveGenContext&, MoveList&) const;
+
 uint64_t Board::getMovesForKingAtPosition(std::string position)
 {
-    // Placeholder implementation
-    return 0;
-}
\ No newline at end of file
+    MoveList moves;
+    int square = getSquareForPosition(position);
+    if (whiteTurn)
+    {
+        MoveGenContext context = getMoveGenContext<WHITE>();
+        if (context.kingSquare == square)
+        {
+            generateKingMoves<WHITE>(context, moves);
+        }
+    }
+    else
+    {
+        MoveGenContext context = getMoveGenContext<BLACK>();
+        if (context.kingSquare == square)
+        {
+            generateKingMoves<BLACK>(context, moves);
+        }
+    }
+    return getTargetMask(moves);
+}
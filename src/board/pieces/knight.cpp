@@ -1,6 +1,35 @@
 #include "../board.hpp"
+#include "../movegen.hpp"
+template<Board::Color Us> void Board::generateKnightMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const
+{
+    // a pinned knight can never stay on the pin line, so it has no moves at all
+    from &= bitboards.piece(pieceFor<Us>(WHITE_KNIGHT)) & ~context.pinned;
+    while (from)
+    {
+        int square = __builtin_ctzll(from);
+        from &= from - 1;
+        uint64_t targets = Attacks::knight(square) & ~context.own & context.checkMask;
+        while (targets)
+        {
+            moves.add(square, __builtin_ctzll(targets));
+            targets &= targets - 1;
+        }
+    }
+}
+template void Board::generateKnightMoves<Board::WHITE>(const MoveGenContext&, uint64_t, MoveList&) const;
+template void Board::generateKnightMoves<Board::BLACK>(const MoveGenContext&, uint64_t, MoveList&) const;
+
 uint64_t Board::getMovesForKnightAtPosition(std::string position)
 {
-    // Placeholder implementation
-    return 0;
-}
\ No newline at end of file
+    MoveList moves;
+    uint64_t from = 1ULL << getSquareForPosition(position);
+    if (whiteTurn)
+    {
+        generateKnightMoves<WHITE>(getMoveGenContext<WHITE>(), from, moves);
+    }
+    else
+    {
+        generateKnightMoves<BLACK>(getMoveGenContext<BLACK>(), from, moves);
+    }
+    return getTargetMask(moves);
+}
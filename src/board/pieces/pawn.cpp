@@ -1,6 +1,145 @@
 #include "../board.hpp"
+#include "../movegen.hpp"
+namespace {
+    // adds a move, or all four promotions when it reaches the last rank
+    template<Board::Color Us> inline void addPawnMove(Board::MoveList& moves, int from, int to)
+    {
+        if ((1ULL << to) & MoveGen::PROMOTION_RANK<Us>)
+        {
+            moves.add(from, to, Board::pieceFor<Us>(Board::WHITE_QUEEN));
+            moves.add(from, to, Board::pieceFor<Us>(Board::WHITE_ROOK));
+            moves.add(from, to, Board::pieceFor<Us>(Board::WHITE_BISHOP));
+            moves.add(from, to, Board::pieceFor<Us>(Board::WHITE_KNIGHT));
+        }
+        else
+        {
+            moves.add(from, to);
+        }
+    }
+    // adds one move per target, each coming from `Delta` squares behind it
+    template<Board::Color Us, int Delta> inline void addPawnMoves(Board::MoveList& moves, uint64_t targets)
+    {
+        while (targets)
+        {
+            int target = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            addPawnMove<Us>(moves, target - Delta, target);
+        }
+    }
+}
+template<Board::Color Us> void Board::generatePawnMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const
+{
+    using namespace MoveGen;
+    constexpr bool white = Us == WHITE;
+    uint64_t pawns = bitboards.piece(pieceFor<Us>(WHITE_PAWN)) & from;
+    uint64_t empty = ~context.occupancy;
+
+    // unpinned pawns move set-wise, one shift per direction for all of them
+    uint64_t free = pawns & ~context.pinned;
+    uint64_t single = pawnPushes<Us>(free) & empty;
+    uint64_t twice = pawnPushes<Us>(single & DOUBLE_PUSH_RANK<Us>) & empty;
+    addPawnMoves<Us, UP<Us>>(moves, single & context.checkMask);
+    addPawnMoves<Us, 2 * UP<Us>>(moves, twice & context.checkMask);
+    addPawnMoves<Us, UP_WEST<Us>>(moves, pawnCapturesWest<Us>(free) & context.enemy & context.checkMask);
+    addPawnMoves<Us, UP_EAST<Us>>(moves, pawnCapturesEast<Us>(free) & context.enemy & context.checkMask);
+
+    // pinned pawns are rare and each keeps to its own pin line
+    for (uint64_t pinnedPawns = pawns & context.pinned; pinnedPawns; pinnedPawns &= pinnedPawns - 1)
+    {
+        int square = __builtin_ctzll(pinnedPawns);
+        uint64_t bit = 1ULL << square;
+        uint64_t push = pawnPushes<Us>(bit) & empty;
+        uint64_t targets = (Attacks::pawn(white, square) & context.enemy) | push
+                         | (pawnPushes<Us>(push & DOUBLE_PUSH_RANK<Us>) & empty);
+        targets &= context.checkMask & getPinMask(context, square);
+        while (targets)
+        {
+            int target = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            addPawnMove<Us>(moves, square, target);
+        }
+    }
+
+    // en passant removes two pawns from one rank, which can expose the king
+    // sideways, so it is verified against the resulting occupancy directly
+    if (enPassantSquare >= 0)
+    {
+        uint64_t capturers = pawns & Attacks::pawn(!white, enPassantSquare);
+        uint64_t capturedBit = 1ULL << (enPassantSquare - UP<Us>);
+        while (capturers)
+        {
+            int square = __builtin_ctzll(capturers);
+            capturers &= capturers - 1;
+            uint64_t occupancy = (context.occupancy ^ (1ULL << square) ^ capturedBit) | (1ULL << enPassantSquare);
+            if (context.kingSquare < 0
+                || !(attackersTo(context.kingSquare, occupancy) & context.enemy & ~capturedBit))
+            {
+                moves.add(square, enPassantSquare);
+            }
+        }
+    }
+}
+template void Board::generatePawnMoves<Board::WHITE>(const MoveGenContext&, uint64_t, MoveList&) const;
+template void Board::generatePawnMoves<Board::BLACK>(const MoveGenContext&, uint64_t, MoveList&) const;
+
+template<Board::Color Us> int Board::countPawnMoves(const MoveGenContext& context, uint64_t from) const
+{
+    using namespace MoveGen;
+    constexpr bool white = Us == WHITE;
+    // every target on the last rank stands for four promotions
+    auto count = [](uint64_t targets) {
+        return __builtin_popcountll(targets) + 3 * __builtin_popcountll(targets & PROMOTION_RANK<Us>);
+    };
+    uint64_t pawns = bitboards.piece(pieceFor<Us>(WHITE_PAWN)) & from;
+    uint64_t empty = ~context.occupancy;
+
+    uint64_t free = pawns & ~context.pinned;
+    uint64_t single = pawnPushes<Us>(free) & empty;
+    uint64_t twice = pawnPushes<Us>(single & DOUBLE_PUSH_RANK<Us>) & empty;
+    int total = count(single & context.checkMask) + count(twice & context.checkMask)
+              + count(pawnCapturesWest<Us>(free) & context.enemy & context.checkMask)
+              + count(pawnCapturesEast<Us>(free) & context.enemy & context.checkMask);
+
+    for (uint64_t pinnedPawns = pawns & context.pinned; pinnedPawns; pinnedPawns &= pinnedPawns - 1)
+    {
+        int square = __builtin_ctzll(pinnedPawns);
+        uint64_t push = pawnPushes<Us>(1ULL << square) & empty;
+        uint64_t targets = (Attacks::pawn(white, square) & context.enemy) | push
+                         | (pawnPushes<Us>(push & DOUBLE_PUSH_RANK<Us>) & empty);
+        total += count(targets & context.checkMask & getPinMask(context, square));
+    }
+
+    if (enPassantSquare >= 0)
+    {
+        uint64_t capturers = pawns & Attacks::pawn(!white, enPassantSquare);
+        uint64_t capturedBit = 1ULL << (enPassantSquare - UP<Us>);
+        for (; capturers; capturers &= capturers - 1)
+        {
+            int square = __builtin_ctzll(capturers);
+            uint64_t occupancy = (context.occupancy ^ (1ULL << square) ^ capturedBit) | (1ULL << enPassantSquare);
+            if (context.kingSquare < 0
+                || !(attackersTo(context.kingSquare, occupancy) & context.enemy & ~capturedBit))
+            {
+                total++;
+            }
+        }
+    }
+    return total;
+}
+template int Board::countPawnMoves<Board::WHITE>(const MoveGenContext&, uint64_t) const;
+template int Board::countPawnMoves<Board::BLACK>(const MoveGenContext&, uint64_t) const;
+
 uint64_t Board::getMovesForPawnAtPosition(std::string position)
 {
-    // Placeholder implementation
-    return 0;
-}
\ No newline at end of file
+    MoveList moves;
+    uint64_t from = 1ULL << getSquareForPosition(position);
+    if (whiteTurn)
+    {
+        generatePawnMoves<WHITE>(getMoveGenContext<WHITE>(), from, moves);
+    }
+    else
+    {
+        generatePawnMoves<BLACK>(getMoveGenContext<BLACK>(), from, moves);
+    }
+    return getTargetMask(moves);
+}
@@ -1,6 +1,35 @@
 #include "../board.hpp"
+#include "../movegen.hpp"
+template<Board::Color Us> void Board::generateQueenMoves(const MoveGenContext& context, uint64_t from, MoveList& moves) const
+{
+    from &= bitboards.piece(pieceFor<Us>(WHITE_QUEEN));
+    while (from)
+    {
+        int square = __builtin_ctzll(from);
+        from &= from - 1;
+        uint64_t targets = Attacks::queen(square, context.occupancy) & ~context.own & context.checkMask
+                         & getPinMask(context, square);
+        while (targets)
+        {
+            moves.add(square, __builtin_ctzll(targets));
+            targets &= targets - 1;
+        }
+    }
+}
+template void Board::generateQueenMoves<Board::WHITE>(const MoveGenContext&, uint64_t, MoveList&) const;
+template void Board::generateQueenMoves<Board::BLACK>(const MoveGenContext&, uint64_t, MoveList&) const;
+
 uint64_t Board::getMovesForQueenAtPosition(std::string position)
 {
-    // Placeholder implementation
-    return 0;
-}
\ No newline at end of file
+    MoveList moves;
+    uint64_t from = 1ULL << getSquareForPosition(position);
+    if (whiteTurn)
+    {
+        generateQueenMoves<WHITE>(getMoveGenContext<WHITE>(), from, moves);
+    }
+    else
+    {
+        generateQueenMoves<BLACK>(getMoveGenContext<BLACK>(), from, moves);
+    }
+    return getTargetMask(moves);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Zobrist keys for hashing positions.
+ *
+ * A position's key is the XOR of one key per piece on its square, one for the
+ * castling rights, one for the en passant file (when a target square is set)
+ * and one when black is to move. Board keeps its key up to date move by move,
+ * so repetition checks compare a single integer per position.
+ *
+ * The keys come from a fixed SplitMix64 sequence generated at compile time, so
+ * hashes are the same on every run and platform. They are unrelated to the
+ * Polyglot book keys.
+ */
+namespace Zobrist {
+    struct Keys {
+        uint64_t pieceSquare[12][64]; // indexed by Board::Piece, then square
+        uint64_t castling[16];        // indexed by the castling rights bitmask
+        uint64_t enPassantFile[8];
+        uint64_t blackToMove;
+    };
+
+    constexpr uint64_t splitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    constexpr Keys makeKeys()
+    {
+        Keys keys{};
+        uint64_t state = 0x5A0B1157C0FFEE42ULL;
+        for (int piece = 0; piece < 12; ++piece)
+        {
+            for (int square = 0; square < 64; ++square)
+            {
+                keys.pieceSquare[piece][square] = splitMix64(state);
+            }
+        }
+        // no rights hashes to zero, so a board without castling only pays for its pieces
+        for (int rights = 1; rights < 16; ++rights)
+        {
+            keys.castling[rights] = splitMix64(state);
+        }
+        for (int file = 0; file < 8; ++file)
+        {
+            keys.enPassantFile[file] = splitMix64(state);
+        }
+        keys.blackToMove = splitMix64(state);
+        return keys;
+    }
+
+    inline constexpr Keys KEYS = makeKeys();
+}
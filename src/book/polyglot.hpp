@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "board/board.hpp"
+#include "util/mapped_file.hpp"
+
+/**
+ * @brief Polyglot opening books.
+ *
+ * A book is a flat file of 16-byte entries sorted by position key, stored big
+ * endian: key (8 bytes), move (2), weight (2) and learn (4). Lookups map the
+ * file and binary search it in place, so opening a book costs nothing beyond
+ * the mmap and finding a position touches O(log n) entries.
+ */
+namespace Polyglot {
+    constexpr size_t ENTRY_SIZE = 16;
+
+    struct Entry {
+        uint64_t key;
+        uint16_t move;
+        uint16_t weight;
+        uint32_t learn;
+    };
+
+    /**
+     * @brief Returns the Polyglot Zobrist key of a position.
+     *
+     * Uses the Polyglot layout: pieces, castling rights, the en passant file
+     * (only when a pawn can actually capture there) and white to move.
+     */
+    uint64_t key(const Board& board);
+    /**
+     * @brief Encodes a move in Polyglot format. Castling is written as the king
+     * capturing its own rook (e1h1), as the format requires.
+     */
+    uint16_t encodeMove(const Board& board, Board::Move move);
+    /**
+     * @brief Decodes a Polyglot move for the position it was stored under.
+     */
+    Board::Move decodeMove(const Board& board, uint16_t move);
+
+    /**
+     * @brief A memory-mapped book file.
+     */
+    class Book {
+        MappedFile file;
+        size_t count;
+
+        // first entry whose key is not less than `key`
+        size_t lowerBound(uint64_t key) const;
+
+        public:
+        /**
+         * @brief Maps `path`. Nothing is read until the first lookup.
+         * @throws std::runtime_error If the file cannot be mapped or is not a whole number of entries.
+         */
+        explicit Book(const std::string& path);
+
+        size_t size() const { return count; }
+        Entry entry(size_t index) const;
+        /**
+         * @brief Returns every entry for `board`, in file order.
+         */
+        std::vector<Entry> lookup(const Board& board) const;
+        // entries with weight 0 are never picked, as in other Polyglot readers
+        /**
+         * @brief Picks the legal book move with the highest weight.
+         * @return bool False if the book has no legal move for `board`.
+         */
+        bool bestMove(const Board& board, Board::Move& move) const;
+        /**
+         * @brief Picks a legal book move with probability proportional to its weight.
+         *
+         * `random` is any uniformly distributed number; passing it in keeps the
+         * book free of shared random state.
+         * @return bool False if the book has no legal move for `board`.
+         */
+        bool weightedMove(const Board& board, uint64_t random, Board::Move& move) const;
+    };
+
+    /**
+     * @brief Collects move statistics and writes them as a book.
+     *
+     * Each move is scored from the mover's point of view, two points for a win
+     * and one for a draw, and weights are scaled so the best move in the book
+     * keeps full 16-bit precision.
+     */
+    class BookBuilder {
+        struct Stats {
+            uint32_t games = 0;
+            uint32_t points = 0; // 2 per win, 1 per draw
+        };
+        std::map<std::pair<uint64_t, uint16_t>, Stats> moves;
+
+        public:
+        enum Result {
+            LOSS = 0,
+            DRAW = 1,
+            WIN = 2
+        };
+        /**
+         * @brief Records `move` being played from `board` with `result` for the mover.
+         */
+        void addMove(const Board& board, Board::Move move, Result result);
+        /**
+         * @brief Records the first `maxPly` moves of a game.
+         * @param whiteResult The result from white's point of view.
+         */
+        void addGame(Board board, const std::vector<Board::Move>& game, Result whiteResult, int maxPly);
+        size_t size() const { return moves.size(); }
+        /**
+         * @brief Writes every move seen in at least `minGames` games, sorted by key.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        void write(const std::string& path, uint32_t minGames = 1) const;
+    };
+}
@@ -0,0 +1,67 @@
+#include "polyglot.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    void writeBigEndian(std::ofstream& out, uint64_t value, int length)
+    {
+        for (int i = length - 1; i >= 0; --i)
+        {
+            out.put(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+}
+
+namespace Polyglot {
+    void BookBuilder::addMove(const Board& board, Board::Move move, Result result)
+    {
+        Stats& stats = moves[{key(board), encodeMove(board, move)}];
+        ++stats.games;
+        stats.points += result;
+    }
+    void BookBuilder::addGame(Board board, const std::vector<Board::Move>& game, Result whiteResult, int maxPly)
+    {
+        int plies = std::min(maxPly, static_cast<int>(game.size()));
+        for (int ply = 0; ply < plies; ++ply)
+        {
+            Result result = board.getTurn() ? whiteResult : static_cast<Result>(WIN - whiteResult);
+            addMove(board, game[ply], result);
+            board.makeMove(game[ply]);
+        }
+    }
+    void BookBuilder::write(const std::string& path, uint32_t minGames) const
+    {
+        uint32_t maxPoints = 1;
+        for (const auto& move : moves)
+        {
+            if (move.second.games >= minGames)
+            {
+                maxPoints = std::max(maxPoints, move.second.points);
+            }
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        // std::map already iterates in key order, which is the order the book needs
+        for (const auto& move : moves)
+        {
+            if (move.second.games < minGames)
+            {
+                continue;
+            }
+            uint64_t weight = static_cast<uint64_t>(move.second.points) * 0xffff / maxPoints;
+            writeBigEndian(out, move.first.first, 8);
+            writeBigEndian(out, move.first.second, 2);
+            writeBigEndian(out, weight, 2);
+            writeBigEndian(out, 0, 4);
+        }
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+}
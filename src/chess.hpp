@@ -3,5 +3,7 @@
 #define CHESS_HPP
 
 #include "board/board.hpp"
+#include "board/game_history.hpp"
+#include "eval/evaluation.hpp"
 
 #endif // CHESS_HPP
\ No newline at end of file
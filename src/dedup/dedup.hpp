@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "selfplay/selfplay.hpp"
+
+/**
+ * @brief Deduplication of large position corpora by Board hash.
+ *
+ * Positions are compared by their 64-bit Zobrist key (Board::getHash()), so
+ * two lines that differ only in move counters or EPD operations count as the
+ * same position. Three strategies cover growing corpus sizes:
+ *
+ * - in memory: every key goes into a sharded HashSet;
+ * - Bloom pre-pass: a first pass over the file records every key in a
+ *   BloomFilter and only keys it has seen before go into the exact set, which
+ *   then holds little more than the actual duplicates;
+ * - external: keys are sorted in runs on disk and merged, so memory use is
+ *   fixed whatever the corpus size.
+ *
+ * Every strategy keeps the first occurrence of a position and preserves the
+ * input order.
+ */
+namespace Dedup {
+    enum Format {
+        FEN,   // one FEN per line; move counters are optional
+        EPD,   // one EPD per line; operations after the four position fields are ignored
+        PACKED // SelfPlay::Record binary records
+    };
+
+    /**
+     * @brief Hashes the position in a FEN or EPD line. Non-throwing.
+     * @return bool false if the line does not hold a position with one king per side.
+     */
+    bool hashLine(std::string_view line, uint64_t& hash);
+    /**
+     * @brief Hashes a packed record to the same key as record.unpack().getHash(),
+     * without building the board.
+     */
+    uint64_t hashRecord(const SelfPlay::Record& record);
+
+    /**
+     * @brief Concurrent set of 64-bit keys.
+     *
+     * Keys are spread over 64 shards by their mixed hash bits. Each shard is an
+     * open-addressing table with linear probing behind its own lock, so threads
+     * rarely contend, and grows on its own when it fills up.
+     */
+    class HashSet {
+        struct Shard {
+            std::mutex mutex;
+            std::vector<uint64_t> slots; // 0 marks an empty slot
+            size_t count = 0;
+        };
+        static constexpr int SHARD_BITS = 6;
+        std::unique_ptr<Shard[]> shards;
+        std::atomic<bool> hasZero;
+
+        Shard& shardFor(uint64_t mixed) const { return shards[mixed >> (64 - SHARD_BITS)]; }
+        static void grow(Shard& shard);
+
+        public:
+        /**
+         * @brief Creates a set sized for about `expected` keys.
+         */
+        explicit HashSet(size_t expected = 0);
+        /**
+         * @brief Adds `key` and returns true if it was not there yet. Thread-safe.
+         */
+        bool insert(uint64_t key);
+        bool contains(uint64_t key) const;
+        size_t size() const;
+    };
+
+    /**
+     * @brief Blocked Bloom filter over 64-bit keys.
+     *
+     * Every key sets seven bits inside a single 64-byte block, so each lookup
+     * touches one cache line. Bits are set with atomic ORs, so insert() may be
+     * called from several threads at once.
+     */
+    class BloomFilter {
+        std::unique_ptr<std::atomic<uint64_t>[]> words;
+        uint64_t blockMask;
+
+        public:
+        /**
+         * @brief Allocates about `bytes` of filter, rounded down to a power of two blocks.
+         */
+        explicit BloomFilter(size_t bytes);
+        /**
+         * @brief Adds `key` and returns true if it may have been added before.
+         */
+        bool insert(uint64_t key);
+        /**
+         * @brief Returns false if `key` was certainly never added.
+         */
+        bool mayContain(uint64_t key) const;
+        size_t bytes() const { return (blockMask + 1) * 64; }
+    };
+
+    /**
+     * @brief Sort-merge deduplication for more keys than fit in memory.
+     *
+     * add() collects (key, ordinal) pairs and writes them to disk in sorted
+     * runs whenever the memory budget is used up. finish() merges the runs and
+     * keeps the first ordinal of every key, sorting those again in runs, and
+     * nextKept() then streams the kept ordinals in increasing order, so a
+     * second pass over the input can copy out the surviving records.
+     */
+    class ExternalDeduplicator {
+        struct Entry {
+            uint64_t key;
+            uint64_t ordinal;
+        };
+        size_t runEntries;
+        std::string directory;
+        std::string prefix;
+        int files = 0;
+        std::vector<Entry> entries;
+        std::vector<std::string> entryRuns;
+        std::vector<uint64_t> kept;
+        std::vector<std::string> keptRuns;
+        // merge of the kept runs once finish() has been called: (next ordinal, run) pairs
+        std::vector<std::FILE*> keptFiles;
+        std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t>>,
+            std::greater<std::pair<uint64_t, size_t>>> keptHeads;
+        size_t keptPosition = 0;
+        bool finished = false;
+
+        std::string writeRun(const void* data, size_t bytes);
+        void spillEntries();
+        void keep(uint64_t ordinal);
+
+        public:
+        /**
+         * @brief Uses about `memoryBytes` for buffering and writes runs to `directory`
+         * (the system temporary directory if empty).
+         */
+        explicit ExternalDeduplicator(size_t memoryBytes, const std::string& directory = "");
+        ~ExternalDeduplicator();
+        ExternalDeduplicator(const ExternalDeduplicator&) = delete;
+        ExternalDeduplicator& operator=(const ExternalDeduplicator&) = delete;
+        /**
+         * @brief Records `key` for the record numbered `ordinal`; ordinals must increase.
+         * @throws std::runtime_error If a run cannot be written.
+         */
+        void add(uint64_t key, uint64_t ordinal);
+        /**
+         * @brief Merges the runs; call once after the last add().
+         * @throws std::runtime_error If a run cannot be read or written.
+         */
+        void finish();
+        /**
+         * @brief Yields the next kept ordinal in increasing order; false once all are read.
+         */
+        bool nextKept(uint64_t& ordinal);
+        /**
+         * @brief Number of runs written so far, for reporting.
+         */
+        int runCount() const { return files; }
+    };
+
+    struct Config {
+        Format format = FEN;
+        int threads = 1;
+        // two passes with a Bloom filter in front of the exact set
+        bool bloom = false;
+        // Bloom filter size; 0 picks about 16 bits per input record
+        size_t bloomBytes = 0;
+        // use sort-merge runs of this many bytes instead of an in-memory set; 0 disables
+        size_t externalBytes = 0;
+        std::string tempDirectory;
+    };
+    struct Stats {
+        uint64_t records = 0;
+        uint64_t unique = 0;
+        uint64_t invalid = 0; // unparsable lines, dropped from the output
+    };
+
+    /**
+     * @brief Copies the first occurrence of every position from `input` to `output`.
+     *
+     * "-" reads stdin or writes stdout. The Bloom and external strategies read
+     * the input twice and therefore need a file.
+     * @throws std::invalid_argument If a two-pass strategy is asked to read stdin.
+     * @throws std::runtime_error If a file cannot be opened, read or written.
+     */
+    Stats deduplicate(const Config& config, const std::string& input, const std::string& output);
+}
@@ -0,0 +1,333 @@
+#include "dedup.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include "board/zobrist.hpp"
+
+namespace {
+    using namespace Dedup;
+    // records parsed and hashed per step; large enough that starting threads per batch is noise
+    constexpr size_t BATCH_RECORDS = size_t(1) << 16;
+
+    class RecordReader {
+        std::ifstream file;
+        std::istream* in;
+        Format format;
+
+        public:
+        RecordReader(const std::string& path, Format format)
+            : in(&std::cin), format(format)
+        {
+            if (path != "-")
+            {
+                file.open(path, std::ios::binary);
+                if (!file)
+                {
+                    throw std::runtime_error("Cannot open " + path);
+                }
+                in = &file;
+            }
+        }
+        bool next(std::string& record)
+        {
+            if (format == PACKED)
+            {
+                record.resize(sizeof(SelfPlay::Record));
+                in->read(&record[0], sizeof(SelfPlay::Record));
+                return in->gcount() == static_cast<std::streamsize>(sizeof(SelfPlay::Record));
+            }
+            return static_cast<bool>(std::getline(*in, record));
+        }
+        // fills `records` from the front and returns how many were read
+        size_t nextBatch(std::vector<std::string>& records)
+        {
+            size_t count = 0;
+            while (count < records.size() && next(records[count]))
+            {
+                count++;
+            }
+            return count;
+        }
+    };
+
+    class RecordWriter {
+        std::ofstream file;
+        std::ostream* out;
+        Format format;
+
+        public:
+        RecordWriter(const std::string& path, Format format)
+            : out(&std::cout), format(format)
+        {
+            if (path != "-")
+            {
+                file.open(path, std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    throw std::runtime_error("Cannot open " + path);
+                }
+                out = &file;
+            }
+        }
+        void write(const std::string& record)
+        {
+            out->write(record.data(), record.size());
+            if (format != PACKED)
+            {
+                out->put('\n');
+            }
+        }
+        void close()
+        {
+            out->flush();
+            if (!*out)
+            {
+                throw std::runtime_error("Cannot write deduplicated records");
+            }
+        }
+    };
+
+    bool hashAny(const std::string& record, Format format, uint64_t& hash)
+    {
+        if (format == PACKED)
+        {
+            SelfPlay::Record packed;
+            std::copy(record.begin(), record.end(), reinterpret_cast<char*>(&packed));
+            hash = hashRecord(packed);
+            return true;
+        }
+        return hashLine(record, hash);
+    }
+    // hashes records [0, count) on `threads` threads; valid[i] is 0 for unparsable records
+    void hashBatch(const std::vector<std::string>& records, size_t count, Format format, int threads,
+        std::vector<uint64_t>& hashes, std::vector<char>& valid)
+    {
+        auto hashRange = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                valid[i] = hashAny(records[i], format, hashes[i]);
+            }
+        };
+        size_t workers = std::min<size_t>(std::max(1, threads), (count + 1023) / 1024);
+        if (workers <= 1)
+        {
+            hashRange(0, count);
+            return;
+        }
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < workers; ++t)
+        {
+            pool.emplace_back(hashRange, count * t / workers, count * (t + 1) / workers);
+        }
+        for (std::thread& thread : pool)
+        {
+            thread.join();
+        }
+    }
+    // a guess at the number of records in `path`, for sizing tables; 0 for stdin
+    size_t estimateRecords(const std::string& path, Format format)
+    {
+        std::error_code error;
+        uintmax_t bytes = path == "-" ? 0 : std::filesystem::file_size(path, error);
+        if (error)
+        {
+            return 0;
+        }
+        // FEN and EPD lines average somewhere around 60 bytes
+        return static_cast<size_t>(bytes / (format == PACKED ? sizeof(SelfPlay::Record) : 60));
+    }
+
+    // Walks the input in batches, handing each record with its ordinal, key and validity to `visit`.
+    template<typename Visit> void forEachRecord(const std::string& input, const Config& config, Visit visit)
+    {
+        RecordReader reader(input, config.format);
+        std::vector<std::string> records(BATCH_RECORDS);
+        std::vector<uint64_t> hashes(BATCH_RECORDS);
+        std::vector<char> valid(BATCH_RECORDS);
+        uint64_t ordinal = 0;
+        for (size_t count; (count = reader.nextBatch(records)) > 0;)
+        {
+            hashBatch(records, count, config.format, config.threads, hashes, valid);
+            for (size_t i = 0; i < count; ++i)
+            {
+                visit(records[i], ordinal++, hashes[i], valid[i] != 0);
+            }
+        }
+    }
+
+    Stats inMemory(const Config& config, const std::string& input, RecordWriter& writer)
+    {
+        Stats stats;
+        HashSet seen(estimateRecords(input, config.format));
+        forEachRecord(input, config, [&](const std::string& record, uint64_t, uint64_t hash, bool valid) {
+            stats.records++;
+            if (!valid)
+            {
+                stats.invalid++;
+            }
+            else if (seen.insert(hash))
+            {
+                stats.unique++;
+                writer.write(record);
+            }
+        });
+        return stats;
+    }
+
+    Stats withBloomFilter(const Config& config, const std::string& input, RecordWriter& writer)
+    {
+        size_t bloomBytes = config.bloomBytes;
+        if (bloomBytes == 0)
+        {
+            bloomBytes = std::max<size_t>(size_t(1) << 20, 2 * estimateRecords(input, config.format));
+        }
+        // pass 1: keys the filter may have seen before are the only possible duplicates
+        BloomFilter filter(bloomBytes);
+        HashSet candidates;
+        forEachRecord(input, config, [&](const std::string&, uint64_t, uint64_t hash, bool valid) {
+            if (valid && filter.insert(hash))
+            {
+                candidates.insert(hash);
+            }
+        });
+        // pass 2: everything else is unique without a lookup in an exact set
+        Stats stats;
+        HashSet written(candidates.size());
+        forEachRecord(input, config, [&](const std::string& record, uint64_t, uint64_t hash, bool valid) {
+            stats.records++;
+            if (!valid)
+            {
+                stats.invalid++;
+            }
+            else if (!candidates.contains(hash) || written.insert(hash))
+            {
+                stats.unique++;
+                writer.write(record);
+            }
+        });
+        return stats;
+    }
+
+    Stats external(const Config& config, const std::string& input, RecordWriter& writer)
+    {
+        Stats stats;
+        ExternalDeduplicator deduplicator(config.externalBytes, config.tempDirectory);
+        forEachRecord(input, config, [&](const std::string&, uint64_t ordinal, uint64_t hash, bool valid) {
+            stats.records++;
+            if (valid)
+            {
+                deduplicator.add(hash, ordinal);
+            }
+            else
+            {
+                stats.invalid++;
+            }
+        });
+        deduplicator.finish();
+
+        // pass 2 only needs ordinals, so records are copied without parsing them again
+        RecordReader reader(input, config.format);
+        std::string record;
+        uint64_t next;
+        bool more = deduplicator.nextKept(next);
+        for (uint64_t ordinal = 0; more && reader.next(record); ++ordinal)
+        {
+            if (ordinal == next)
+            {
+                stats.unique++;
+                writer.write(record);
+                more = deduplicator.nextKept(next);
+            }
+        }
+        return stats;
+    }
+}
+
+namespace Dedup {
+    bool hashLine(std::string_view line, uint64_t& hash)
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        // the position is the first four fields; FEN counters and EPD operations follow
+        size_t end = 0;
+        for (int field = 0; field < 4; ++field)
+        {
+            if (field > 0)
+            {
+                if (end >= line.size() || line[end] != ' ')
+                {
+                    return false;
+                }
+                end++;
+            }
+            size_t next = std::min(line.find(' ', end), line.size());
+            if (next == end)
+            {
+                return false;
+            }
+            end = next;
+        }
+        // a position only has to hash, not to be playable, so only an
+        // unreadable FEN or a missing king makes the line malformed
+        Board board;
+        Board::FENError error = Board::tryFromFEN(line.substr(0, end), board);
+        if (error == Board::FEN_MALFORMED || error == Board::FEN_KING_COUNT)
+        {
+            return false;
+        }
+        hash = board.getHash();
+        return true;
+    }
+    uint64_t hashRecord(const SelfPlay::Record& record)
+    {
+        const Zobrist::Keys& keys = Zobrist::KEYS;
+        uint64_t hash = keys.castling[(record.flags >> 1) & 0xF];
+        int index = 0;
+        for (uint64_t occupied = record.occupancy; occupied && index < 32; occupied &= occupied - 1, ++index)
+        {
+            int piece = (record.pieces[index / 2] >> (4 * (index % 2))) & 0xF;
+            if (piece < 12)
+            {
+                hash ^= keys.pieceSquare[piece][__builtin_ctzll(occupied)];
+            }
+        }
+        if (record.enPassant != 255)
+        {
+            hash ^= keys.enPassantFile[record.enPassant % 8];
+        }
+        if (!(record.flags & 1))
+        {
+            hash ^= keys.blackToMove;
+        }
+        return hash;
+    }
+
+    Stats deduplicate(const Config& config, const std::string& input, const std::string& output)
+    {
+        if ((config.bloom || config.externalBytes > 0) && input == "-")
+        {
+            throw std::invalid_argument("Bloom and external deduplication read the input twice and need a file");
+        }
+        RecordWriter writer(output, config.format);
+        Stats stats;
+        if (config.externalBytes > 0)
+        {
+            stats = external(config, input, writer);
+        }
+        else if (config.bloom)
+        {
+            stats = withBloomFilter(config, input, writer);
+        }
+        else
+        {
+            stats = inMemory(config, input, writer);
+        }
+        writer.close();
+        return stats;
+    }
+}
@@ -0,0 +1,215 @@
+#include "dedup.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    // reads fixed-size values from one sorted run
+    template<typename T> bool readValue(std::FILE* file, T& value)
+    {
+        return std::fread(&value, sizeof(T), 1, file) == 1;
+    }
+    std::FILE* openRun(const std::string& path)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            throw std::runtime_error("Cannot read dedup run " + path);
+        }
+        // many runs are read at once, so give each a buffer big enough for sequential reads
+        std::setvbuf(file, nullptr, _IOFBF, size_t(1) << 18);
+        return file;
+    }
+}
+
+namespace Dedup {
+    ExternalDeduplicator::ExternalDeduplicator(size_t memoryBytes, const std::string& directory)
+        : runEntries(std::max<size_t>(1024, memoryBytes / sizeof(Entry))),
+          directory(directory.empty() ? std::filesystem::temp_directory_path().string() : directory)
+    {
+        prefix = "chess-dedup-" + std::to_string(std::random_device()()) + "-";
+        entries.reserve(runEntries);
+    }
+    ExternalDeduplicator::~ExternalDeduplicator()
+    {
+        for (std::FILE* file : keptFiles)
+        {
+            std::fclose(file);
+        }
+        std::error_code ignored;
+        for (int i = 0; i < files; ++i)
+        {
+            std::filesystem::remove(std::filesystem::path(directory) / (prefix + std::to_string(i)), ignored);
+        }
+    }
+    std::string ExternalDeduplicator::writeRun(const void* data, size_t bytes)
+    {
+        std::string path = (std::filesystem::path(directory) / (prefix + std::to_string(files++))).string();
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        bool written = file && std::fwrite(data, 1, bytes, file) == bytes;
+        if (!file || std::fclose(file) != 0 || !written)
+        {
+            throw std::runtime_error("Cannot write dedup run " + path);
+        }
+        return path;
+    }
+    void ExternalDeduplicator::spillEntries()
+    {
+        // ordinals only increase, so a stable sort by key leaves the first occurrence in front
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        entries.erase(std::unique(entries.begin(), entries.end(),
+                          [](const Entry& a, const Entry& b) { return a.key == b.key; }),
+            entries.end());
+        entryRuns.push_back(writeRun(entries.data(), entries.size() * sizeof(Entry)));
+        entries.clear();
+    }
+    void ExternalDeduplicator::add(uint64_t key, uint64_t ordinal)
+    {
+        if (entries.size() == runEntries)
+        {
+            spillEntries();
+        }
+        entries.push_back({key, ordinal});
+    }
+    void ExternalDeduplicator::keep(uint64_t ordinal)
+    {
+        // kept ordinals take half the space of entries, so they share the same budget
+        if (kept.size() == 2 * runEntries)
+        {
+            std::sort(kept.begin(), kept.end());
+            keptRuns.push_back(writeRun(kept.data(), kept.size() * sizeof(uint64_t)));
+            kept.clear();
+        }
+        kept.push_back(ordinal);
+    }
+    void ExternalDeduplicator::finish()
+    {
+        if (finished)
+        {
+            return;
+        }
+        finished = true;
+        if (entryRuns.empty())
+        {
+            // everything fit in memory: no runs needed
+            std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                if (i == 0 || entries[i].key != entries[i - 1].key)
+                {
+                    kept.push_back(entries[i].ordinal);
+                }
+            }
+            std::vector<Entry>().swap(entries);
+            std::sort(kept.begin(), kept.end());
+            return;
+        }
+        if (!entries.empty())
+        {
+            spillEntries();
+        }
+        std::vector<Entry>().swap(entries);
+        kept.reserve(2 * runEntries);
+
+        // k-way merge by (key, ordinal); the first entry of every key is its first occurrence
+        struct Head {
+            Entry entry;
+            size_t run;
+            bool operator>(const Head& other) const
+            {
+                return entry.key != other.entry.key ? entry.key > other.entry.key : entry.ordinal > other.entry.ordinal;
+            }
+        };
+        std::vector<std::FILE*> runs;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        try
+        {
+            for (const std::string& path : entryRuns)
+            {
+                runs.push_back(openRun(path));
+                Entry entry;
+                if (readValue(runs.back(), entry))
+                {
+                    heads.push({entry, runs.size() - 1});
+                }
+            }
+            bool any = false;
+            uint64_t lastKey = 0;
+            while (!heads.empty())
+            {
+                Head head = heads.top();
+                heads.pop();
+                if (!any || head.entry.key != lastKey)
+                {
+                    keep(head.entry.ordinal);
+                    lastKey = head.entry.key;
+                    any = true;
+                }
+                Entry entry;
+                if (readValue(runs[head.run], entry))
+                {
+                    heads.push({entry, head.run});
+                }
+            }
+        }
+        catch (...)
+        {
+            for (std::FILE* run : runs)
+            {
+                std::fclose(run);
+            }
+            throw;
+        }
+        for (std::FILE* run : runs)
+        {
+            std::fclose(run);
+        }
+
+        std::sort(kept.begin(), kept.end());
+        if (keptRuns.empty())
+        {
+            return;
+        }
+        if (!kept.empty())
+        {
+            keptRuns.push_back(writeRun(kept.data(), kept.size() * sizeof(uint64_t)));
+        }
+        std::vector<uint64_t>().swap(kept);
+        for (const std::string& path : keptRuns)
+        {
+            keptFiles.push_back(openRun(path));
+            uint64_t ordinal;
+            if (readValue(keptFiles.back(), ordinal))
+            {
+                keptHeads.push({ordinal, keptFiles.size() - 1});
+            }
+        }
+    }
+    bool ExternalDeduplicator::nextKept(uint64_t& ordinal)
+    {
+        if (keptFiles.empty())
+        {
+            if (keptPosition == kept.size())
+            {
+                return false;
+            }
+            ordinal = kept[keptPosition++];
+            return true;
+        }
+        if (keptHeads.empty())
+        {
+            return false;
+        }
+        auto [smallest, run] = keptHeads.top();
+        keptHeads.pop();
+        ordinal = smallest;
+        uint64_t next;
+        if (readValue(keptFiles[run], next))
+        {
+            keptHeads.push({next, run});
+        }
+        return true;
+    }
+}
@@ -0,0 +1,157 @@
+#include "dedup.hpp"
+#include <algorithm>
+
+namespace {
+    // keys may be structured (or chosen by a caller), so spread them before picking shards and slots
+    uint64_t mix(uint64_t key)
+    {
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+        return key ^ (key >> 31);
+    }
+    size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result *= 2;
+        }
+        return result;
+    }
+}
+
+namespace Dedup {
+    HashSet::HashSet(size_t expected)
+        : shards(new Shard[size_t(1) << SHARD_BITS]), hasZero(false)
+    {
+        // at most half full before the first resize
+        size_t perShard = roundUpToPowerOfTwo(std::max<size_t>(16, 2 * expected >> SHARD_BITS));
+        for (size_t i = 0; i < (size_t(1) << SHARD_BITS); ++i)
+        {
+            shards[i].slots.assign(perShard, 0);
+        }
+    }
+    void HashSet::grow(Shard& shard)
+    {
+        std::vector<uint64_t> old(shard.slots.size() * 2, 0);
+        old.swap(shard.slots);
+        size_t mask = shard.slots.size() - 1;
+        for (uint64_t key : old)
+        {
+            if (key == 0)
+            {
+                continue;
+            }
+            size_t index = mix(key) & mask;
+            while (shard.slots[index] != 0)
+            {
+                index = (index + 1) & mask;
+            }
+            shard.slots[index] = key;
+        }
+    }
+    bool HashSet::insert(uint64_t key)
+    {
+        if (key == 0)
+        {
+            return !hasZero.exchange(true);
+        }
+        uint64_t mixed = mix(key);
+        Shard& shard = shardFor(mixed);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        // keep probe sequences short: grow at three quarters full
+        if (4 * (shard.count + 1) > 3 * shard.slots.size())
+        {
+            grow(shard);
+        }
+        size_t mask = shard.slots.size() - 1;
+        for (size_t index = mixed & mask;; index = (index + 1) & mask)
+        {
+            if (shard.slots[index] == key)
+            {
+                return false;
+            }
+            if (shard.slots[index] == 0)
+            {
+                shard.slots[index] = key;
+                shard.count++;
+                return true;
+            }
+        }
+    }
+    bool HashSet::contains(uint64_t key) const
+    {
+        if (key == 0)
+        {
+            return hasZero.load();
+        }
+        uint64_t mixed = mix(key);
+        Shard& shard = shardFor(mixed);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size_t mask = shard.slots.size() - 1;
+        for (size_t index = mixed & mask;; index = (index + 1) & mask)
+        {
+            if (shard.slots[index] == key)
+            {
+                return true;
+            }
+            if (shard.slots[index] == 0)
+            {
+                return false;
+            }
+        }
+    }
+    size_t HashSet::size() const
+    {
+        size_t total = hasZero.load() ? 1 : 0;
+        for (size_t i = 0; i < (size_t(1) << SHARD_BITS); ++i)
+        {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].count;
+        }
+        return total;
+    }
+
+    BloomFilter::BloomFilter(size_t bytes)
+    {
+        size_t blocks = 1;
+        while (blocks * 2 * 64 <= bytes)
+        {
+            blocks *= 2;
+        }
+        blockMask = blocks - 1;
+        words.reset(new std::atomic<uint64_t>[blocks * 8]());
+    }
+    // the block comes from the low bits of one mix, the seven probes from 9-bit
+    // slices of another: 3 bits pick the word in the block, 6 the bit in the word
+    bool BloomFilter::insert(uint64_t key)
+    {
+        uint64_t mixed = mix(key);
+        std::atomic<uint64_t>* block = &words[(mixed & blockMask) * 8];
+        uint64_t probes = mix(mixed ^ 0x9E3779B97F4A7C15ULL);
+        bool present = true;
+        for (int i = 0; i < 7; ++i, probes >>= 9)
+        {
+            uint64_t bit = 1ULL << (probes & 63);
+            if (!(block[(probes >> 6) & 7].fetch_or(bit, std::memory_order_relaxed) & bit))
+            {
+                present = false;
+            }
+        }
+        return present;
+    }
+    bool BloomFilter::mayContain(uint64_t key) const
+    {
+        uint64_t mixed = mix(key);
+        const std::atomic<uint64_t>* block = &words[(mixed & blockMask) * 8];
+        uint64_t probes = mix(mixed ^ 0x9E3779B97F4A7C15ULL);
+        for (int i = 0; i < 7; ++i, probes >>= 9)
+        {
+            if (!(block[(probes >> 6) & 7].load(std::memory_order_relaxed) & (1ULL << (probes & 63))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
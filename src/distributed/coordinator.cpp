@@ -0,0 +1,614 @@
+#include "distributed.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <filesystem>
+#include <fcntl.h>
+#include <fstream>
+#include <poll.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "util/socket.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    constexpr int POLL_MILLISECONDS = 200;
+    // a local worker that keeps dying is restarted at most this often
+    constexpr auto RESTART_INTERVAL = std::chrono::seconds(1);
+
+    const char* taskName(Distributed::Task task) { return task == Distributed::PERFT ? "perft" : "search"; }
+
+    // FNV-1a over the job's lines, so a checkpoint is only resumed for the same job
+    uint64_t jobHash(const std::vector<std::string>& positions)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const std::string& position : positions)
+        {
+            for (unsigned char c : position)
+            {
+                hash = (hash ^ c) * 1099511628211ULL;
+            }
+            hash = (hash ^ '\n') * 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+namespace Distributed {
+    struct Coordinator::Impl {
+        struct Unit {
+            size_t first = 0;
+            size_t count = 0;
+            bool done = false;
+            bool queued = false; // waiting in the pending queue
+            int holders = 0;     // connections working on it
+            Clock::time_point leased{};
+        };
+        struct Connection {
+            int fd = -1;
+            std::string input;
+            std::string output;
+            long unit = -1;       // the unit handed to this worker, if any
+            bool ready = false;   // waiting for a unit
+            size_t expected = 0;  // result lines still to come
+            size_t resultUnit = 0;
+            std::vector<std::string> lines;
+            bool closed = false;
+        };
+        struct LocalWorker {
+            pid_t pid = -1;
+            Clock::time_point started;
+        };
+
+        std::vector<std::string> positions;
+        std::vector<std::string> results;
+        CoordinatorConfig config;
+        std::vector<Unit> units;
+        std::deque<size_t> pending;
+        size_t remaining = 0;
+        Progress counts;
+        std::ofstream checkpoint;
+
+        std::vector<int> listeners;
+        std::vector<std::string> socketPaths;
+        std::vector<Connection> connections;
+        std::vector<LocalWorker> localWorkers;
+        Endpoint local;
+        bool hasLocal = false;
+        int stopPipe[2] = {-1, -1};
+
+        Impl(std::vector<std::string> jobPositions, const CoordinatorConfig& coordinatorConfig)
+            : positions(std::move(jobPositions)), results(positions.size()), config(coordinatorConfig)
+        {
+            for (size_t first = 0; first < positions.size(); first += config.unitSize)
+            {
+                Unit unit;
+                unit.first = first;
+                unit.count = std::min(config.unitSize, positions.size() - first);
+                units.push_back(unit);
+            }
+            counts.units = units.size();
+            if (!config.checkpointPath.empty())
+            {
+                resume();
+            }
+            for (size_t id = 0; id < units.size(); ++id)
+            {
+                if (!units[id].done)
+                {
+                    pending.push_back(id);
+                    units[id].queued = true;
+                    remaining++;
+                }
+            }
+            if (pipe2(stopPipe, O_CLOEXEC | O_NONBLOCK) < 0)
+            {
+                Socket::fail("pipe");
+            }
+        }
+        ~Impl()
+        {
+            for (Connection& connection : connections)
+            {
+                close(connection.fd);
+            }
+            stopLocalWorkers();
+            for (int listener : listeners)
+            {
+                close(listener);
+            }
+            for (const std::string& path : socketPaths)
+            {
+                unlink(path.c_str());
+            }
+            close(stopPipe[0]);
+            close(stopPipe[1]);
+        }
+
+        // Reads back the units a previous run finished, drops a record cut short
+        // by a crash, and leaves the file open for appending.
+        void resume()
+        {
+            const std::string& path = config.checkpointPath;
+            std::ostringstream expected;
+            expected << "checkpoint " << taskName(config.job.task) << ' ' << config.job.depth << ' ' << config.unitSize
+                     << ' ' << positions.size() << ' ' << std::hex << jobHash(positions);
+            std::ifstream in(path);
+            std::string header;
+            bool fresh = !in || !std::getline(in, header) || in.eof();
+            if (!fresh && header != expected.str())
+            {
+                throw std::runtime_error("Checkpoint " + path + " was written for a different job");
+            }
+            if (!fresh)
+            {
+                std::streamoff valid = in.tellg();
+                std::string line;
+                while (std::getline(in, line) && !in.eof())
+                {
+                    std::istringstream words(line);
+                    std::string keyword;
+                    size_t id;
+                    size_t count;
+                    if (!(words >> keyword >> id >> count) || keyword != "unit" || id >= units.size()
+                        || count != units[id].count)
+                    {
+                        break;
+                    }
+                    std::vector<std::string> lines(count);
+                    size_t read = 0;
+                    while (read < count && std::getline(in, lines[read]) && !in.eof())
+                    {
+                        read++;
+                    }
+                    if (read < count)
+                    {
+                        break;
+                    }
+                    if (!units[id].done)
+                    {
+                        units[id].done = true;
+                        std::move(lines.begin(), lines.end(), results.begin() + units[id].first);
+                        counts.resumed++;
+                    }
+                    valid = in.tellg();
+                }
+                in.close();
+                std::filesystem::resize_file(path, valid);
+            }
+            checkpoint.open(path, fresh ? std::ios::trunc : std::ios::app);
+            if (!checkpoint)
+            {
+                throw std::runtime_error("Cannot write checkpoint " + path);
+            }
+            if (fresh)
+            {
+                checkpoint << expected.str() << '\n' << std::flush;
+            }
+        }
+
+        void addListener(int fd)
+        {
+            listeners.push_back(fd);
+        }
+
+        void spawn(LocalWorker& worker)
+        {
+            worker.started = Clock::now();
+            worker.pid = fork();
+            if (worker.pid < 0)
+            {
+                Socket::fail("fork");
+            }
+            if (worker.pid == 0)
+            {
+                // the child only needs its own connection to us
+                for (int listener : listeners)
+                {
+                    close(listener);
+                }
+                for (Connection& connection : connections)
+                {
+                    close(connection.fd);
+                }
+                close(stopPipe[0]);
+                close(stopPipe[1]);
+                WorkerConfig workerConfig = config.worker;
+                workerConfig.coordinator = local;
+                try
+                {
+                    runWorker(workerConfig);
+                }
+                catch (...)
+                {
+                    _exit(1);
+                }
+                _exit(0);
+            }
+        }
+        void superviseLocalWorkers()
+        {
+            for (LocalWorker& worker : localWorkers)
+            {
+                if (worker.pid > 0 && waitpid(worker.pid, nullptr, WNOHANG) == worker.pid)
+                {
+                    worker.pid = -1;
+                }
+                if (worker.pid < 0 && Clock::now() - worker.started >= RESTART_INTERVAL)
+                {
+                    spawn(worker);
+                    counts.restarts++;
+                }
+            }
+        }
+        void stopLocalWorkers()
+        {
+            for (LocalWorker& worker : localWorkers)
+            {
+                if (worker.pid > 0)
+                {
+                    kill(worker.pid, SIGTERM);
+                    waitpid(worker.pid, nullptr, 0);
+                    worker.pid = -1;
+                }
+            }
+            localWorkers.clear();
+        }
+
+        void requeue(size_t id)
+        {
+            Unit& unit = units[id];
+            if (!unit.done && !unit.queued)
+            {
+                pending.push_back(id);
+                unit.queued = true;
+                counts.requeued++;
+            }
+        }
+        void expireLeases()
+        {
+            if (config.leaseSeconds <= 0)
+            {
+                return;
+            }
+            Clock::time_point expired = Clock::now() - std::chrono::seconds(config.leaseSeconds);
+            for (size_t id = 0; id < units.size(); ++id)
+            {
+                if (units[id].holders > 0 && units[id].leased <= expired)
+                {
+                    requeue(id);
+                }
+            }
+        }
+        void handOut()
+        {
+            for (Connection& connection : connections)
+            {
+                if (!connection.ready || connection.closed)
+                {
+                    continue;
+                }
+                while (!pending.empty() && units[pending.front()].done)
+                {
+                    pending.pop_front();
+                }
+                if (pending.empty())
+                {
+                    return;
+                }
+                size_t id = pending.front();
+                pending.pop_front();
+                Unit& unit = units[id];
+                unit.queued = false;
+                unit.holders++;
+                unit.leased = Clock::now();
+                connection.unit = id;
+                connection.ready = false;
+                connection.output += "unit " + std::to_string(id) + " " + taskName(config.job.task) + " "
+                                     + std::to_string(config.job.depth) + " " + std::to_string(unit.count) + "\n";
+                for (size_t i = 0; i < unit.count; ++i)
+                {
+                    connection.output += positions[unit.first + i] + "\n";
+                }
+            }
+        }
+
+        void drop(Connection& connection)
+        {
+            if (connection.closed)
+            {
+                return;
+            }
+            connection.closed = true;
+            close(connection.fd);
+            if (connection.unit >= 0)
+            {
+                Unit& unit = units[connection.unit];
+                if (--unit.holders == 0)
+                {
+                    requeue(connection.unit);
+                }
+                connection.unit = -1;
+            }
+        }
+        void finish(Connection& connection)
+        {
+            size_t id = connection.resultUnit;
+            if (connection.unit == long(id))
+            {
+                units[id].holders--;
+                connection.unit = -1;
+            }
+            connection.ready = connection.unit < 0;
+            Unit& unit = units[id];
+            if (unit.done)
+            {
+                return;
+            }
+            unit.done = true;
+            remaining--;
+            counts.finished++;
+            if (checkpoint.is_open())
+            {
+                checkpoint << "unit " << id << ' ' << unit.count << '\n';
+                for (const std::string& line : connection.lines)
+                {
+                    checkpoint << line << '\n';
+                }
+                checkpoint.flush();
+            }
+            std::move(connection.lines.begin(), connection.lines.end(), results.begin() + unit.first);
+        }
+        // false on anything that does not follow the protocol
+        bool handleLine(Connection& connection, std::string& line)
+        {
+            if (connection.expected > 0)
+            {
+                connection.lines.push_back(std::move(line));
+                if (--connection.expected == 0)
+                {
+                    finish(connection);
+                }
+                return true;
+            }
+            std::istringstream words(line);
+            std::string command;
+            words >> command;
+            if (command == "ready")
+            {
+                connection.ready = connection.unit < 0;
+                return true;
+            }
+            size_t id;
+            size_t count;
+            if (command != "result" || !(words >> id >> count) || id >= units.size() || count != units[id].count)
+            {
+                return false;
+            }
+            connection.resultUnit = id;
+            connection.expected = count;
+            connection.lines.clear();
+            return true;
+        }
+        void receive(Connection& connection)
+        {
+            char chunk[16384];
+            while (true)
+            {
+                ssize_t count = recv(connection.fd, chunk, sizeof(chunk), 0);
+                if (count < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    break;
+                }
+                if (count <= 0)
+                {
+                    drop(connection);
+                    return;
+                }
+                connection.input.append(chunk, count);
+            }
+            size_t start = 0;
+            std::string line;
+            while (Socket::takeLine(connection.input, start, line))
+            {
+                if (!handleLine(connection, line))
+                {
+                    drop(connection);
+                    return;
+                }
+            }
+            connection.input.erase(0, start);
+        }
+        void transmit(Connection& connection)
+        {
+            while (!connection.output.empty())
+            {
+                ssize_t count = send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+                if (count < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    return;
+                }
+                if (count <= 0)
+                {
+                    drop(connection);
+                    return;
+                }
+                connection.output.erase(0, count);
+            }
+        }
+        void accept(int listener)
+        {
+            while (true)
+            {
+                int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    return;
+                }
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // fails harmlessly on Unix sockets
+                Connection connection;
+                connection.fd = fd;
+                connections.push_back(std::move(connection));
+            }
+        }
+
+        // Lets every worker know the job is over; the ones still busy on a
+        // duplicate unit find out when their connection closes.
+        void dismiss()
+        {
+            for (Connection& connection : connections)
+            {
+                if (connection.closed)
+                {
+                    continue;
+                }
+                connection.output += "done\n";
+                int flags = fcntl(connection.fd, F_GETFL);
+                fcntl(connection.fd, F_SETFL, flags & ~O_NONBLOCK);
+                Socket::sendAll(connection.fd, connection.output);
+                shutdown(connection.fd, SHUT_WR);
+                close(connection.fd);
+            }
+            connections.clear();
+        }
+
+        std::vector<std::string> run()
+        {
+            if (listeners.empty())
+            {
+                throw std::logic_error("Coordinator::run() needs a listening socket");
+            }
+            for (int i = 0; i < config.localWorkers && remaining > 0; ++i)
+            {
+                localWorkers.emplace_back();
+                spawn(localWorkers.back());
+            }
+            bool stopped = false;
+            std::vector<pollfd> polled;
+            while (remaining > 0 && !stopped)
+            {
+                superviseLocalWorkers();
+                expireLeases();
+                handOut();
+
+                polled.clear();
+                polled.push_back(pollfd{stopPipe[0], POLLIN, 0});
+                for (int listener : listeners)
+                {
+                    polled.push_back(pollfd{listener, POLLIN, 0});
+                }
+                for (const Connection& connection : connections)
+                {
+                    short events = POLLIN | (connection.output.empty() ? 0 : POLLOUT);
+                    polled.push_back(pollfd{connection.fd, events, 0});
+                }
+                if (poll(polled.data(), polled.size(), POLL_MILLISECONDS) < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    Socket::fail("poll");
+                }
+                stopped = polled[0].revents != 0;
+                for (size_t i = 0; i < listeners.size(); ++i)
+                {
+                    if (polled[1 + i].revents)
+                    {
+                        accept(listeners[i]);
+                    }
+                }
+                // connections accepted just now are past the end of `polled`
+                size_t polledConnections = polled.size() - 1 - listeners.size();
+                for (size_t i = 0; i < polledConnections; ++i)
+                {
+                    Connection& connection = connections[i];
+                    short events = polled[1 + listeners.size() + i].revents;
+                    if (events & (POLLIN | POLLHUP | POLLERR))
+                    {
+                        receive(connection);
+                    }
+                    if ((events & POLLOUT) && !connection.closed)
+                    {
+                        transmit(connection);
+                    }
+                }
+                connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                                 [](const Connection& connection) { return connection.closed; }),
+                                  connections.end());
+            }
+            dismiss();
+            stopLocalWorkers();
+            if (stopped)
+            {
+                char drained[64];
+                while (read(stopPipe[0], drained, sizeof(drained)) > 0)
+                {
+                }
+                return {};
+            }
+            return results;
+        }
+    };
+
+    Coordinator::Coordinator(std::vector<std::string> positions, const CoordinatorConfig& config)
+    {
+        if (config.unitSize == 0)
+        {
+            throw std::invalid_argument("unitSize must be positive");
+        }
+        if (config.job.depth <= 0)
+        {
+            throw std::invalid_argument("depth must be positive");
+        }
+        impl = std::make_unique<Impl>(std::move(positions), config);
+    }
+    Coordinator::~Coordinator() = default;
+
+    uint16_t Coordinator::listenTcp(uint16_t port, const std::string& address)
+    {
+        impl->addListener(Socket::listenTcp(address, port));
+        if (!impl->hasLocal)
+        {
+            // local workers reach a wildcard address through loopback
+            impl->local.address = address == "0.0.0.0" ? "127.0.0.1" : address;
+            impl->local.port = port;
+            impl->hasLocal = true;
+        }
+        return port;
+    }
+    void Coordinator::listenUnix(const std::string& path)
+    {
+        int fd = Socket::listenUnix(path);
+        impl->socketPaths.push_back(path);
+        impl->addListener(fd);
+        // local workers prefer the Unix socket
+        impl->local = Endpoint{};
+        impl->local.unixPath = path;
+        impl->hasLocal = true;
+    }
+    std::vector<std::string> Coordinator::run()
+    {
+        return impl->run();
+    }
+    void Coordinator::stop()
+    {
+        ssize_t written = write(impl->stopPipe[1], "x", 1);
+        (void)written;
+    }
+    Progress Coordinator::progress() const
+    {
+        return impl->counts;
+    }
+}
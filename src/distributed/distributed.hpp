@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "search/search.hpp"
+
+/**
+ * @brief Analysis of a job file split across worker processes.
+ *
+ * A Coordinator splits the positions of a job (one FEN or EPD per line) into
+ * units of a few positions and serves them over TCP or a Unix socket. Workers
+ * connect, possibly from other machines, and talk one line at a time:
+ *
+ *     worker:      ready
+ *     coordinator: unit <id> <search|perft> <depth> <count>, then <count> positions
+ *     worker:      result <id> <count>, then <count> result lines
+ *     coordinator: done, once every unit has a result
+ *
+ * A worker asks for its next unit by sending a result, so faster workers
+ * simply take more units. Units held by a worker whose connection drops, or
+ * that it holds longer than the lease, go back to the queue; if two workers
+ * end up with the same unit, the first result wins. With a checkpoint file,
+ * every finished unit is appended to it, and a coordinator restarted on the
+ * same job only hands out the units still missing. Workers reconnect for a
+ * while when the coordinator goes away, so they carry on across such a
+ * restart. Linux only.
+ */
+namespace Distributed {
+    enum Task : uint8_t {
+        SEARCH,
+        PERFT
+    };
+
+    struct Job {
+        Task task = SEARCH;
+        int depth = 6;
+    };
+
+    /**
+     * @brief Runs `job` on one FEN or EPD line. Never throws.
+     *
+     * EPD operations after the position are ignored. Searches give
+     * "<SAN>\t<score>\tdepth <depth>" like the analyze tool, perft gives the
+     * node count, and a line that is not a position gives "error <reason>".
+     */
+    std::string analyze(const std::string& line, const Job& job, Search::Searcher& searcher);
+
+    /**
+     * @brief Where a coordinator listens: a Unix socket when `unixPath` is set, TCP otherwise.
+     */
+    struct Endpoint {
+        std::string address = "127.0.0.1";
+        uint16_t port = 0;
+        std::string unixPath;
+    };
+
+    struct WorkerConfig {
+        Endpoint coordinator;
+        // how long to keep trying to connect, or reconnect after losing the coordinator
+        int retrySeconds = 30;
+        // shared search cache file, see Search::AnalysisCache; empty for none
+        std::string cachePath;
+        size_t cacheMegabytes = 64;
+    };
+
+    /**
+     * @brief Connects to a coordinator and works on its units until it says done.
+     * @return size_t The number of units this worker finished.
+     * @throws std::runtime_error If the coordinator cannot be reached within the retry time.
+     */
+    size_t runWorker(const WorkerConfig& config);
+
+    struct CoordinatorConfig {
+        Job job;
+        size_t unitSize = 16;
+        // finished units are appended here and skipped when the job is run again; empty for none
+        std::string checkpointPath;
+        // requeue a unit its worker has held this long; 0 waits for the connection to drop
+        int leaseSeconds = 0;
+        // worker processes forked by run() itself and restarted if they die
+        int localWorkers = 0;
+        // settings for those workers; the endpoint is filled in by run()
+        WorkerConfig worker;
+    };
+
+    struct Progress {
+        size_t units = 0;
+        size_t resumed = 0;  // units read back from the checkpoint
+        size_t finished = 0; // units finished by workers during this run
+        size_t requeued = 0; // units handed out again after a worker dropped or its lease ran out
+        size_t restarts = 0; // local workers restarted after dying
+    };
+
+    class Coordinator {
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+
+        public:
+        /**
+         * @brief Splits `positions` into units and reads back any finished ones from the checkpoint.
+         * @throws std::invalid_argument If the unit size or depth is not positive.
+         * @throws std::runtime_error If the checkpoint belongs to a different job.
+         */
+        Coordinator(std::vector<std::string> positions, const CoordinatorConfig& config);
+        ~Coordinator();
+        Coordinator(const Coordinator&) = delete;
+        Coordinator& operator=(const Coordinator&) = delete;
+        /**
+         * @brief Listens on a TCP port; port 0 picks a free one.
+         * @return uint16_t The port actually bound.
+         * @throws std::runtime_error If the socket cannot be bound.
+         */
+        uint16_t listenTcp(uint16_t port, const std::string& address = "127.0.0.1");
+        /**
+         * @brief Listens on a Unix socket at `path`, replacing any stale socket file.
+         * @throws std::runtime_error If the socket cannot be bound.
+         */
+        void listenUnix(const std::string& path);
+        /**
+         * @brief Hands out units until every position has a result, then tells the workers to stop.
+         * @return std::vector<std::string> One result per position, in job order; empty if stopped early.
+         * @throws std::logic_error If nothing is listening.
+         */
+        std::vector<std::string> run();
+        /**
+         * @brief Makes run() return early. Safe to call from any thread or a signal handler.
+         */
+        void stop();
+        /**
+         * @brief Unit counts for the last run(); read them once it has returned.
+         */
+        Progress progress() const;
+    };
+}
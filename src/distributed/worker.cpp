@@ -0,0 +1,174 @@
+#include "distributed.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "board/batch.hpp"
+#include "search/analysis_cache.hpp"
+#include "util/socket.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // the board part of a FEN or EPD line: four fields, plus the move counters if present
+    std::string positionFields(const std::string& line)
+    {
+        std::istringstream fields(line);
+        std::string fen;
+        std::string field;
+        for (int index = 0; index < 6 && fields >> field; ++index)
+        {
+            if (index >= 4 && !std::all_of(field.begin(), field.end(), [](unsigned char c) { return std::isdigit(c); }))
+            {
+                break;
+            }
+            fen += (index > 0 ? " " : "") + field;
+        }
+        return fen;
+    }
+
+    int connectTo(const Distributed::Endpoint& endpoint)
+    {
+        return endpoint.unixPath.empty() ? Socket::connectTcp(endpoint.address, endpoint.port)
+                                         : Socket::connectUnix(endpoint.unixPath);
+    }
+
+    // serves one connection; true once the coordinator says the job is done
+    bool work(int fd, Search::Searcher& searcher, size_t& finished)
+    {
+        if (!Socket::sendAll(fd, "ready\n"))
+        {
+            return false;
+        }
+        std::string buffer;
+        size_t start = 0;
+        std::string line;
+        std::string unitId;
+        Distributed::Job job;
+        size_t expected = 0;
+        std::vector<std::string> positions;
+        char chunk[4096];
+        while (true)
+        {
+            while (Socket::takeLine(buffer, start, line))
+            {
+                if (expected > 0)
+                {
+                    positions.push_back(line);
+                    if (--expected > 0)
+                    {
+                        continue;
+                    }
+                    std::string reply = "result " + unitId + " " + std::to_string(positions.size()) + "\n";
+                    for (const std::string& position : positions)
+                    {
+                        reply += Distributed::analyze(position, job, searcher) + "\n";
+                    }
+                    if (!Socket::sendAll(fd, reply))
+                    {
+                        return false;
+                    }
+                    finished++;
+                    continue;
+                }
+                std::istringstream words(line);
+                std::string command;
+                std::string task;
+                words >> command;
+                if (command == "done")
+                {
+                    return true;
+                }
+                if (command != "unit" || !(words >> unitId >> task >> job.depth >> expected) || expected == 0
+                    || (task != "search" && task != "perft"))
+                {
+                    return false;
+                }
+                job.task = task == "perft" ? Distributed::PERFT : Distributed::SEARCH;
+                positions.clear();
+            }
+            buffer.erase(0, start);
+            start = 0;
+            ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                return false;
+            }
+            buffer.append(chunk, count);
+        }
+    }
+}
+
+namespace Distributed {
+    std::string analyze(const std::string& line, const Job& job, Search::Searcher& searcher)
+    {
+        try
+        {
+            Board board(positionFields(line));
+            if (job.task == PERFT)
+            {
+                return std::to_string(Batch::perft(board, job.depth));
+            }
+            Search::Limits limits;
+            limits.depth = job.depth;
+            Search::Result result = searcher.search(board, limits);
+            return (result.move.from >= 0 ? board.toSAN(result.move) : "none") + "\t" + std::to_string(result.score)
+                   + "\tdepth " + std::to_string(result.depth);
+        }
+        catch (const std::exception& e)
+        {
+            std::string reason = e.what();
+            std::replace(reason.begin(), reason.end(), '\n', ' ');
+            return "error " + reason;
+        }
+    }
+
+    size_t runWorker(const WorkerConfig& config)
+    {
+        Search::Searcher searcher;
+        std::unique_ptr<Search::AnalysisCache> cache;
+        if (!config.cachePath.empty())
+        {
+            cache = std::make_unique<Search::AnalysisCache>(config.cachePath, config.cacheMegabytes << 20);
+            searcher.setCache(cache.get());
+        }
+        size_t finished = 0;
+        bool connected = false;
+        Clock::time_point deadline = Clock::now() + std::chrono::seconds(config.retrySeconds);
+        while (true)
+        {
+            int fd = connectTo(config.coordinator);
+            if (fd < 0)
+            {
+                if (Clock::now() >= deadline)
+                {
+                    if (connected)
+                    {
+                        // the coordinator has finished, or is not coming back
+                        return finished;
+                    }
+                    const Endpoint& endpoint = config.coordinator;
+                    Socket::fail("connect " + (endpoint.unixPath.empty()
+                                           ? endpoint.address + ":" + std::to_string(endpoint.port)
+                                           : endpoint.unixPath));
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            connected = true;
+            bool done = work(fd, searcher, finished);
+            close(fd);
+            if (done)
+            {
+                return finished;
+            }
+            deadline = Clock::now() + std::chrono::seconds(config.retrySeconds);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#include "evaluation.hpp"
+#include "evaluation_tables.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHESS_EVAL_AVX2 1
+#endif
+
+namespace {
+    using namespace Evaluation;
+
+#ifdef CHESS_EVAL_AVX2
+    // popcount of each 64-bit lane: nibble lookup per byte, then sum the bytes
+    __attribute__((target("avx2"))) inline __m256i popcount64(__m256i v)
+    {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+        __m256i low = _mm256_and_si256(v, lowNibbles);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+    }
+
+    // scores four boards at once; each 64-bit lane holds one board
+    __attribute__((target("avx2"))) void evaluateBlockAvx2(const Board* boards, int32_t* scores)
+    {
+        // transpose into structure-of-arrays: soa[piece] holds that bitboard for all four boards
+        alignas(32) uint64_t soa[12][4];
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            for (int piece = 0; piece < 12; ++piece)
+            {
+                soa[piece][lane] = boards[lane].getBitmaskForPiece(static_cast<Board::Piece>(piece));
+            }
+        }
+
+        __m256i score[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+        __m256i phase = _mm256_setzero_si256();
+        __m256i bishopCounts[2];
+        for (int piece = 0; piece < 12; ++piece)
+        {
+            __m256i bitboard = _mm256_load_si256(reinterpret_cast<const __m256i*>(soa[piece]));
+            __m256i count = popcount64(bitboard);
+            phase = _mm256_add_epi64(phase, _mm256_mul_epi32(count, _mm256_set1_epi64x(PHASE_WEIGHT[piece % 6])));
+            if (piece % 6 == 2)
+            {
+                bishopCounts[piece / 6] = count;
+            }
+            for (int p = MIDDLEGAME; p <= ENDGAME; ++p)
+            {
+                __m256i sum = _mm256_mul_epi32(count, _mm256_set1_epi64x(PLANES.base[p][piece]));
+                for (int bit = 0; bit < PLANE_COUNT; ++bit)
+                {
+                    __m256i plane = _mm256_set1_epi64x(static_cast<long long>(PLANES.planes[p][piece][bit]));
+                    __m256i hits = popcount64(_mm256_and_si256(bitboard, plane));
+                    sum = _mm256_add_epi64(sum, _mm256_slli_epi64(hits, bit));
+                }
+                score[p] = piece < 6 ? _mm256_add_epi64(score[p], sum) : _mm256_sub_epi64(score[p], sum);
+            }
+        }
+        // bishop pair, as a 0/-1 mask per lane
+        const __m256i one = _mm256_set1_epi64x(1);
+        __m256i whitePair = _mm256_cmpgt_epi64(bishopCounts[0], one);
+        __m256i blackPair = _mm256_cmpgt_epi64(bishopCounts[1], one);
+        for (int p = MIDDLEGAME; p <= ENDGAME; ++p)
+        {
+            __m256i bonus = _mm256_set1_epi64x(BISHOP_PAIR[p]);
+            score[p] = _mm256_add_epi64(score[p], _mm256_and_si256(whitePair, bonus));
+            score[p] = _mm256_sub_epi64(score[p], _mm256_and_si256(blackPair, bonus));
+        }
+
+        alignas(32) int64_t middlegame[4], endgame[4], phases[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(middlegame), score[MIDDLEGAME]);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(endgame), score[ENDGAME]);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(phases), phase);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            scores[lane] = taper(middlegame[lane], endgame[lane], phases[lane]);
+        }
+    }
+
+    bool hasAvx2()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#endif
+}
+
+int Evaluation::evaluate(const Board& board)
+{
+    int64_t score[2] = {0, 0};
+    int64_t phase = 0;
+    for (int piece = 0; piece < 12; ++piece)
+    {
+        uint64_t bitboard = board.getBitmaskForPiece(static_cast<Board::Piece>(piece));
+        int sign = piece < 6 ? 1 : -1;
+        phase += __builtin_popcountll(bitboard) * PHASE_WEIGHT[piece % 6];
+        if (piece % 6 == 2 && __builtin_popcountll(bitboard) >= 2)
+        {
+            score[MIDDLEGAME] += sign * BISHOP_PAIR[MIDDLEGAME];
+            score[ENDGAME] += sign * BISHOP_PAIR[ENDGAME];
+        }
+        while (bitboard)
+        {
+            int square = __builtin_ctzll(bitboard);
+            bitboard &= bitboard - 1;
+            for (int p = MIDDLEGAME; p <= ENDGAME; ++p)
+            {
+                score[p] += sign * (MATERIAL[piece % 6] + pieceSquare(p, piece, square));
+            }
+        }
+    }
+    return taper(score[MIDDLEGAME], score[ENDGAME], phase);
+}
+
+void Evaluation::evaluateBatch(const Board* boards, size_t count, int32_t* scores)
+{
+    size_t i = 0;
+#ifdef CHESS_EVAL_AVX2
+    if (hasAvx2())
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            evaluateBlockAvx2(boards + i, scores + i);
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        scores[i] = evaluate(boards[i]);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "board/board.hpp"
+
+/**
+ * @brief Static position evaluation.
+ *
+ * Scores are in centipawns from white's point of view and only use features that
+ * can be read straight off the bitboards: material, piece-square tables tapered
+ * between middlegame and endgame, and the bishop pair. No moves are generated.
+ */
+namespace Evaluation {
+    /**
+     * @brief Evaluates a single board.
+     */
+    int evaluate(const Board& board);
+    /**
+     * @brief Evaluates `count` boards and writes one score per board to `scores`.
+     *
+     * Boards are transposed four at a time into a structure-of-arrays block (one
+     * vector per piece type) and scored with AVX2 when the CPU supports it, four
+     * positions per instruction. The results are identical to calling evaluate()
+     * on each board; the scalar path is used for leftovers and on other CPUs.
+     */
+    void evaluateBatch(const Board* boards, size_t count, int32_t* scores);
+}
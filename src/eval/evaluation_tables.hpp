@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+
+// Shared tables for the scalar and the vectorised evaluators. Not part of the
+// public interface.
+namespace Evaluation {
+    enum Phase {
+        MIDDLEGAME,
+        ENDGAME
+    };
+
+    // indexed by piece type (pawn .. king)
+    inline constexpr int MATERIAL[6] = {100, 320, 330, 500, 900, 0};
+    inline constexpr int PHASE_WEIGHT[6] = {0, 1, 1, 2, 4, 0};
+    inline constexpr int MAX_PHASE = 24;
+    inline constexpr int BISHOP_PAIR[2] = {30, 50};
+
+    // piece-square tables as seen by white, written with rank 8 first
+    inline constexpr int PIECE_SQUARE[2][6][64] = {
+        {
+            { // pawn
+                 0,  0,  0,  0,  0,  0,  0,  0,
+                50, 50, 50, 50, 50, 50, 50, 50,
+                10, 10, 20, 30, 30, 20, 10, 10,
+                 5,  5, 10, 25, 25, 10,  5,  5,
+                 0,  0,  0, 20, 20,  0,  0,  0,
+                 5, -5,-10,  0,  0,-10, -5,  5,
+                 5, 10, 10,-20,-20, 10, 10,  5,
+                 0,  0,  0,  0,  0,  0,  0,  0
+            },
+            { // knight
+                -50,-40,-30,-30,-30,-30,-40,-50,
+                -40,-20,  0,  0,  0,  0,-20,-40,
+                -30,  0, 10, 15, 15, 10,  0,-30,
+                -30,  5, 15, 20, 20, 15,  5,-30,
+                -30,  0, 15, 20, 20, 15,  0,-30,
+                -30,  5, 10, 15, 15, 10,  5,-30,
+                -40,-20,  0,  5,  5,  0,-20,-40,
+                -50,-40,-30,-30,-30,-30,-40,-50
+            },
+            { // bishop
+                -20,-10,-10,-10,-10,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5, 10, 10,  5,  0,-10,
+                -10,  5,  5, 10, 10,  5,  5,-10,
+                -10,  0, 10, 10, 10, 10,  0,-10,
+                -10, 10, 10, 10, 10, 10, 10,-10,
+                -10,  5,  0,  0,  0,  0,  5,-10,
+                -20,-10,-10,-10,-10,-10,-10,-20
+            },
+            { // rook
+                 0,  0,  0,  0,  0,  0,  0,  0,
+                 5, 10, 10, 10, 10, 10, 10,  5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                 0,  0,  0,  5,  5,  0,  0,  0
+            },
+            { // queen
+                -20,-10,-10, -5, -5,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5,  5,  5,  5,  0,-10,
+                 -5,  0,  5,  5,  5,  5,  0, -5,
+                  0,  0,  5,  5,  5,  5,  0, -5,
+                -10,  5,  5,  5,  5,  5,  0,-10,
+                -10,  0,  5,  0,  0,  0,  0,-10,
+                -20,-10,-10, -5, -5,-10,-10,-20
+            },
+            { // king
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -20,-30,-30,-40,-40,-30,-30,-20,
+                -10,-20,-20,-20,-20,-20,-20,-10,
+                 20, 20,  0,  0,  0,  0, 20, 20,
+                 20, 30, 10,  0,  0, 10, 30, 20
+            }
+        },
+        {
+            { // pawn: passers matter more as the board empties
+                 0,  0,  0,  0,  0,  0,  0,  0,
+                80, 80, 80, 80, 80, 80, 80, 80,
+                50, 50, 50, 50, 50, 50, 50, 50,
+                30, 30, 30, 30, 30, 30, 30, 30,
+                20, 20, 20, 20, 20, 20, 20, 20,
+                10, 10, 10, 10, 10, 10, 10, 10,
+                 0,  0,  0,  0,  0,  0,  0,  0,
+                 0,  0,  0,  0,  0,  0,  0,  0
+            },
+            { // knight
+                -50,-40,-30,-30,-30,-30,-40,-50,
+                -40,-20,  0,  0,  0,  0,-20,-40,
+                -30,  0, 10, 15, 15, 10,  0,-30,
+                -30,  5, 15, 20, 20, 15,  5,-30,
+                -30,  0, 15, 20, 20, 15,  0,-30,
+                -30,  5, 10, 15, 15, 10,  5,-30,
+                -40,-20,  0,  5,  5,  0,-20,-40,
+                -50,-40,-30,-30,-30,-30,-40,-50
+            },
+            { // bishop
+                -20,-10,-10,-10,-10,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5, 10, 10,  5,  0,-10,
+                -10,  5,  5, 10, 10,  5,  5,-10,
+                -10,  0, 10, 10, 10, 10,  0,-10,
+                -10, 10, 10, 10, 10, 10, 10,-10,
+                -10,  5,  0,  0,  0,  0,  5,-10,
+                -20,-10,-10,-10,-10,-10,-10,-20
+            },
+            { // rook
+                 0,  0,  0,  0,  0,  0,  0,  0,
+                 5, 10, 10, 10, 10, 10, 10,  5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                -5,  0,  0,  0,  0,  0,  0, -5,
+                 0,  0,  0,  5,  5,  0,  0,  0
+            },
+            { // queen
+                -20,-10,-10, -5, -5,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5,  5,  5,  5,  0,-10,
+                 -5,  0,  5,  5,  5,  5,  0, -5,
+                  0,  0,  5,  5,  5,  5,  0, -5,
+                -10,  5,  5,  5,  5,  5,  0,-10,
+                -10,  0,  5,  0,  0,  0,  0,-10,
+                -20,-10,-10, -5, -5,-10,-10,-20
+            },
+            { // king: centralise once the queens are off
+                -50,-40,-30,-20,-20,-30,-40,-50,
+                -30,-20,-10,  0,  0,-10,-20,-30,
+                -30,-10, 20, 30, 30, 20,-10,-30,
+                -30,-10, 30, 40, 40, 30,-10,-30,
+                -30,-10, 30, 40, 40, 30,-10,-30,
+                -30,-10, 20, 30, 30, 20,-10,-30,
+                -30,-30,  0,  0,  0,  0,-30,-30,
+                -50,-30,-30,-30,-30,-30,-30,-50
+            }
+        }
+    };
+
+    /**
+     * @brief Piece-square value of `piece` (0-11, Board::Piece order) on `square` (a1 = 0),
+     * from the owner's point of view.
+     */
+    constexpr int pieceSquare(int phase, int piece, int square)
+    {
+        // the tables are written rank 8 first, so white looks them up mirrored
+        return piece < 6 ? PIECE_SQUARE[phase][piece][square ^ 56] : PIECE_SQUARE[phase][piece - 6][square];
+    }
+
+    /**
+     * @brief Piece-square tables split into bit-planes so they can be summed with popcounts.
+     *
+     * For every phase and piece, value(square) = base + sum over b of (bit b of the
+     * biased value) << b, which turns sum(value(square) for square in bitboard) into
+     * count * base + sum over b of popcount(bitboard & planes[b]) << b. `base`
+     * also folds in the material value so one multiply covers both.
+     */
+    inline constexpr int PLANE_COUNT = 8;
+    struct PieceSquarePlanes {
+        uint64_t planes[2][12][PLANE_COUNT];
+        int base[2][12];
+    };
+    constexpr PieceSquarePlanes buildPieceSquarePlanes()
+    {
+        PieceSquarePlanes result{};
+        for (int phase = 0; phase < 2; ++phase)
+        {
+            for (int piece = 0; piece < 12; ++piece)
+            {
+                int lowest = pieceSquare(phase, piece, 0);
+                for (int square = 1; square < 64; ++square)
+                {
+                    int value = pieceSquare(phase, piece, square);
+                    lowest = value < lowest ? value : lowest;
+                }
+                result.base[phase][piece] = lowest + MATERIAL[piece % 6];
+                for (int square = 0; square < 64; ++square)
+                {
+                    // biased values must fit in PLANE_COUNT bits
+                    int biased = pieceSquare(phase, piece, square) - lowest;
+                    for (int bit = 0; bit < PLANE_COUNT; ++bit)
+                    {
+                        if (biased & (1 << bit))
+                        {
+                            result.planes[phase][piece][bit] |= 1ULL << square;
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+    inline constexpr PieceSquarePlanes PLANES = buildPieceSquarePlanes();
+
+    /**
+     * @brief Blends middlegame and endgame scores by game phase.
+     */
+    constexpr int taper(int64_t middlegame, int64_t endgame, int64_t phase)
+    {
+        if (phase > MAX_PHASE)
+        {
+            phase = MAX_PHASE;
+        }
+        return static_cast<int>((middlegame * phase + endgame * (MAX_PHASE - phase)) / MAX_PHASE);
+    }
+}
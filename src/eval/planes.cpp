@@ -0,0 +1,159 @@
+#include "planes.hpp"
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHESS_PLANES_AVX2 1
+#endif
+
+namespace {
+    using namespace Planes;
+    constexpr uint64_t LOW_BITS = 0x0101010101010101ULL;
+    // byte i holds bit i, so a rank copied into every byte can be tested file by file
+    constexpr uint64_t FILE_BITS = 0x8040201008040201ULL;
+
+    // the bitboard behind each plane, after the optional flip
+    void gatherPlanes(const Board& board, bool flip, uint64_t* planes)
+    {
+        bool mirror = flip && !board.getTurn();
+        for (int piece = 0; piece < 12; ++piece)
+        {
+            // a mirrored board swaps colours, so black's pieces fill the first six planes
+            int source = mirror ? (piece + 6) % 12 : piece;
+            uint64_t bitboard = board.getBitmaskForPiece(static_cast<Board::Piece>(source));
+            planes[piece] = mirror ? __builtin_bswap64(bitboard) : bitboard;
+        }
+        planes[12] = board.getTurn() ? ~0ULL : 0;
+        int castling = board.getCastlingRights();
+        if (mirror)
+        {
+            castling = ((castling & 0b0011) << 2) | ((castling & 0b1100) >> 2);
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            planes[13 + i] = (castling & (0b1000 >> i)) ? ~0ULL : 0;
+        }
+        int enPassant = board.getEnPassantSquare();
+        planes[17] = enPassant < 0 ? 0 : 1ULL << (mirror ? enPassant ^ 56 : enPassant);
+    }
+
+    // eight squares per multiply: copy the rank into every byte, keep bit i in
+    // byte i, then carry any set bit up to bit 7 and shift it down to bit 0
+    uint64_t expandRank(uint64_t bitboard, int rank)
+    {
+        uint64_t bytes = (((bitboard >> (8 * rank)) & 0xFF) * LOW_BITS) & FILE_BITS;
+        bytes = ((bytes + 0x7F7F7F7F7F7F7F7FULL) >> 7) & LOW_BITS;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        bytes = __builtin_bswap64(bytes);
+#endif
+        return bytes;
+    }
+    // two squares per multiply: the low two bits of `bits` become 0.0f or 1.0f
+    // in the first and second float of the word
+    uint64_t expandPair(uint64_t bits)
+    {
+        static_assert(std::numeric_limits<float>::is_iec559, "1.0f must be 0x3F800000");
+        constexpr uint64_t ONE_FLOAT = 0x3F800000;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return ((bits & 2) >> 1 | (bits & 1) << 32) * ONE_FLOAT;
+#else
+        return ((bits & 1) | (bits & 2) << 31) * ONE_FLOAT;
+#endif
+    }
+    void encodeBoard(const uint64_t* planes, uint8_t* out)
+    {
+        for (int plane = 0; plane < PLANE_COUNT; ++plane)
+        {
+            for (int rank = 0; rank < 8; ++rank)
+            {
+                uint64_t bytes = expandRank(planes[plane], rank);
+                std::memcpy(out + plane * 64 + rank * 8, &bytes, 8);
+            }
+        }
+    }
+    void encodeBoard(const uint64_t* planes, float* out)
+    {
+        for (int plane = 0; plane < PLANE_COUNT; ++plane)
+        {
+            for (int rank = 0; rank < 8; ++rank)
+            {
+                uint64_t bits = planes[plane] >> (8 * rank);
+                uint64_t words[4] = {expandPair(bits), expandPair(bits >> 2), expandPair(bits >> 4), expandPair(bits >> 6)};
+                std::memcpy(out + plane * 64 + rank * 8, words, sizeof(words));
+            }
+        }
+    }
+
+#ifdef CHESS_PLANES_AVX2
+    // 32 squares per step: shuffle source byte i / 8 into byte i, then keep bit i % 8
+    __attribute__((target("avx2"))) void encodeBoardAvx2(const uint64_t* planes, uint8_t* out)
+    {
+        // shuffles stay inside each 128-bit lane, and every lane holds the whole bitboard
+        const __m256i lowRanks = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                  2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        const __m256i highRanks = _mm256_add_epi8(lowRanks, _mm256_set1_epi8(4));
+        const __m256i fileBits = _mm256_set1_epi64x(static_cast<long long>(FILE_BITS));
+        const __m256i one = _mm256_set1_epi8(1);
+        for (int plane = 0; plane < PLANE_COUNT; ++plane)
+        {
+            __m256i source = _mm256_set1_epi64x(static_cast<long long>(planes[plane]));
+            __m256i low = _mm256_and_si256(_mm256_shuffle_epi8(source, lowRanks), fileBits);
+            __m256i high = _mm256_and_si256(_mm256_shuffle_epi8(source, highRanks), fileBits);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + plane * 64), _mm256_min_epu8(low, one));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + plane * 64 + 32), _mm256_min_epu8(high, one));
+        }
+    }
+    // 8 squares per step: broadcast the rank, test one bit per lane and mask in 1.0f
+    __attribute__((target("avx2"))) void encodeBoardAvx2(const uint64_t* planes, float* out)
+    {
+        const __m256i fileBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m256 ones = _mm256_set1_ps(1.0f);
+        for (int plane = 0; plane < PLANE_COUNT; ++plane)
+        {
+            for (int rank = 0; rank < 8; ++rank)
+            {
+                __m256i bits = _mm256_set1_epi32(static_cast<int>((planes[plane] >> (8 * rank)) & 0xFF));
+                __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(bits, fileBits), fileBits);
+                _mm256_storeu_ps(out + plane * 64 + rank * 8, _mm256_and_ps(_mm256_castsi256_ps(set), ones));
+            }
+        }
+    }
+
+    bool hasAvx2()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#endif
+
+    template<typename T> void encodeAll(const Board* boards, size_t count, T* out, bool flip)
+    {
+        uint64_t planes[PLANE_COUNT];
+#ifdef CHESS_PLANES_AVX2
+        if (hasAvx2())
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                gatherPlanes(boards[i], flip, planes);
+                encodeBoardAvx2(planes, out + i * BOARD_VALUES);
+            }
+            return;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i)
+        {
+            gatherPlanes(boards[i], flip, planes);
+            encodeBoard(planes, out + i * BOARD_VALUES);
+        }
+    }
+}
+
+void Planes::encode(const Board* boards, size_t count, uint8_t* out, bool flip)
+{
+    encodeAll(boards, count, out, flip);
+}
+void Planes::encode(const Board* boards, size_t count, float* out, bool flip)
+{
+    encodeAll(boards, count, out, flip);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "board/board.hpp"
+
+/**
+ * @brief Conversion of boards into dense input planes for neural networks.
+ *
+ * Each board becomes PLANE_COUNT planes of 8x8 values, rank-major with a1
+ * first, written contiguously in [board][plane][rank][file] order:
+ *
+ *     0-5    white pawns, knights, bishops, rooks, queens, king
+ *     6-11   the same for black
+ *     12     all ones if white is to move
+ *     13-16  all ones per castling right: K, Q, k, q
+ *     17     the en passant target square
+ *
+ * With `flip`, positions with black to move are mirrored vertically and the
+ * colours swapped, so planes 0-5 and castling planes 13-14 always belong to the
+ * side to move, which then always plays up the board. Plane 12 still records
+ * who that side really is.
+ *
+ * Every bitboard is expanded to 64 bytes with byte shuffles and compares,
+ * 32 squares per AVX2 instruction when the CPU supports it, and otherwise
+ * with branch-free multiplies, eight squares at a time for bytes and two for
+ * floats; no loop visits squares one by one.
+ */
+namespace Planes {
+    constexpr int PLANE_COUNT = 18;
+    // values written per board
+    constexpr size_t BOARD_VALUES = PLANE_COUNT * 64;
+
+    /**
+     * @brief Writes `count` boards as 0/1 bytes, BOARD_VALUES per board, to `out`.
+     */
+    void encode(const Board* boards, size_t count, uint8_t* out, bool flip = false);
+    /**
+     * @brief Writes `count` boards as 0.0f/1.0f, BOARD_VALUES per board, to `out`.
+     */
+    void encode(const Board* boards, size_t count, float* out, bool flip = false);
+}
@@ -0,0 +1,490 @@
+#include "tuning.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "board/board.hpp"
+#include "evaluation_tables.hpp"
+
+namespace {
+    using namespace Tuning;
+    using Evaluation::MIDDLEGAME;
+    using Evaluation::ENDGAME;
+    using Evaluation::MAX_PHASE;
+
+    const char* const PIECE_NAMES[6] = {"pawn", "knight", "bishop", "rook", "queen", "king"};
+
+    int pieceSquareIndex(int phase, int type, int tableSquare)
+    {
+        return PIECE_SQUARE_OFFSET + (phase * 6 + type) * 64 + tableSquare;
+    }
+    // the tables are written rank 8 first, so white looks them up mirrored
+    int tableSquare(int piece, int square) { return piece < 6 ? square ^ 56 : square; }
+
+    // The parameters folded into one signed value per phase, piece and board
+    // square, so scoring a position is one load per piece and phase. Gradients
+    // are gathered in the same shape and unfolded once per epoch.
+    struct Folded {
+        double table[2][12][64];
+        double bishopPair[2];
+    };
+    constexpr size_t FOLDED_VALUES = sizeof(Folded) / sizeof(double);
+
+    void fold(const Parameters& parameters, Folded& folded)
+    {
+        for (int phase = MIDDLEGAME; phase <= ENDGAME; ++phase)
+        {
+            for (int piece = 0; piece < 12; ++piece)
+            {
+                int type = piece % 6;
+                double sign = piece < 6 ? 1 : -1;
+                for (int square = 0; square < 64; ++square)
+                {
+                    folded.table[phase][piece][square] =
+                        sign * (parameters[MATERIAL_OFFSET + type]
+                                + parameters[pieceSquareIndex(phase, type, tableSquare(piece, square))]);
+                }
+            }
+            folded.bishopPair[phase] = parameters[BISHOP_PAIR_OFFSET + phase];
+        }
+    }
+    void unfold(const Folded& folded, Parameters& parameters)
+    {
+        std::fill(parameters.begin(), parameters.end(), 0.0);
+        for (int phase = MIDDLEGAME; phase <= ENDGAME; ++phase)
+        {
+            for (int piece = 0; piece < 12; ++piece)
+            {
+                int type = piece % 6;
+                double sign = piece < 6 ? 1 : -1;
+                for (int square = 0; square < 64; ++square)
+                {
+                    double value = sign * folded.table[phase][piece][square];
+                    parameters[MATERIAL_OFFSET + type] += value;
+                    parameters[pieceSquareIndex(phase, type, tableSquare(piece, square))] += value;
+                }
+            }
+            parameters[BISHOP_PAIR_OFFSET + phase] = folded.bishopPair[phase];
+        }
+        // the kings cancel out, and their value is fixed at zero
+        parameters[MATERIAL_OFFSET + 5] = 0;
+    }
+
+    int bishopPairs(const Position& position)
+    {
+        return (__builtin_popcountll(position.pieces.piece(Board::WHITE_BISHOP)) >= 2)
+               - (__builtin_popcountll(position.pieces.piece(Board::BLACK_BISHOP)) >= 2);
+    }
+    double score(const Position& position, const Folded& folded)
+    {
+        double phaseScores[2] = {0, 0};
+        for (int piece = 0; piece < 12; ++piece)
+        {
+            for (uint64_t bitboard = position.pieces.piece(piece); bitboard; bitboard &= bitboard - 1)
+            {
+                int square = __builtin_ctzll(bitboard);
+                phaseScores[MIDDLEGAME] += folded.table[MIDDLEGAME][piece][square];
+                phaseScores[ENDGAME] += folded.table[ENDGAME][piece][square];
+            }
+        }
+        int pairs = bishopPairs(position);
+        phaseScores[MIDDLEGAME] += pairs * folded.bishopPair[MIDDLEGAME];
+        phaseScores[ENDGAME] += pairs * folded.bishopPair[ENDGAME];
+        double middlegame = double(position.phase) / MAX_PHASE;
+        return phaseScores[MIDDLEGAME] * middlegame + phaseScores[ENDGAME] * (1 - middlegame);
+    }
+
+    // runs work(begin, end, slice) over `count` items split into `threads` slices
+    template <typename Work>
+    void forSlices(size_t count, int threads, const Work& work)
+    {
+        size_t slices = std::max<size_t>(1, std::min<size_t>(threads, count));
+        std::vector<std::thread> workers;
+        for (size_t slice = 1; slice < slices; ++slice)
+        {
+            workers.emplace_back([&, slice]() { work(count * slice / slices, count * (slice + 1) / slices, slice); });
+        }
+        work(0, count / slices, 0);
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // total[i] += part[i], four doubles per add
+    typedef double Doubles __attribute__((vector_size(32)));
+    void accumulate(double* total, const double* part, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            Doubles sum;
+            Doubles addend;
+            std::memcpy(&sum, total + i, sizeof(sum));
+            std::memcpy(&addend, part + i, sizeof(addend));
+            sum += addend;
+            std::memcpy(total + i, &sum, sizeof(sum));
+        }
+        for (; i < count; ++i)
+        {
+            total[i] += part[i];
+        }
+    }
+
+    std::string_view stripLabel(std::string_view word)
+    {
+        while (!word.empty() && std::strchr("\"[;", word.front()))
+        {
+            word.remove_prefix(1);
+        }
+        while (!word.empty() && std::strchr("\"];", word.back()))
+        {
+            word.remove_suffix(1);
+        }
+        return word;
+    }
+    bool parseResult(std::string_view word, float& result)
+    {
+        word = stripLabel(word);
+        if (word == "1-0" || word == "1.0")
+        {
+            result = 1.0f;
+        }
+        else if (word == "0-1" || word == "0.0")
+        {
+            result = 0.0f;
+        }
+        else if (word == "1/2-1/2" || word == "0.5")
+        {
+            result = 0.5f;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace Tuning {
+    Parameters defaults()
+    {
+        Parameters parameters(PARAMETER_COUNT);
+        for (int type = 0; type < 6; ++type)
+        {
+            parameters[MATERIAL_OFFSET + type] = Evaluation::MATERIAL[type];
+        }
+        for (int phase = MIDDLEGAME; phase <= ENDGAME; ++phase)
+        {
+            for (int type = 0; type < 6; ++type)
+            {
+                for (int square = 0; square < 64; ++square)
+                {
+                    parameters[pieceSquareIndex(phase, type, square)] = Evaluation::PIECE_SQUARE[phase][type][square];
+                }
+            }
+            parameters[BISHOP_PAIR_OFFSET + phase] = Evaluation::BISHOP_PAIR[phase];
+        }
+        return parameters;
+    }
+
+    std::string toSource(const Parameters& parameters)
+    {
+        auto rounded = [&](int index) { return static_cast<int>(std::lround(parameters[index])); };
+        std::string source = "    inline constexpr int MATERIAL[6] = {";
+        for (int type = 0; type < 6; ++type)
+        {
+            source += std::to_string(rounded(MATERIAL_OFFSET + type)) + (type < 5 ? ", " : "};\n");
+        }
+        source += "    inline constexpr int BISHOP_PAIR[2] = {" + std::to_string(rounded(BISHOP_PAIR_OFFSET)) + ", "
+                  + std::to_string(rounded(BISHOP_PAIR_OFFSET + 1)) + "};\n\n";
+        source += "    // piece-square tables as seen by white, written with rank 8 first\n";
+        source += "    inline constexpr int PIECE_SQUARE[2][6][64] = {\n";
+        for (int phase = MIDDLEGAME; phase <= ENDGAME; ++phase)
+        {
+            source += "        {\n";
+            for (int type = 0; type < 6; ++type)
+            {
+                int values[64];
+                int highest = rounded(pieceSquareIndex(phase, type, 0));
+                for (int square = 0; square < 64; ++square)
+                {
+                    values[square] = rounded(pieceSquareIndex(phase, type, square));
+                    highest = std::max(highest, values[square]);
+                }
+                source += std::string("            { // ") + PIECE_NAMES[type] + "\n";
+                for (int rank = 0; rank < 8; ++rank)
+                {
+                    source += "                ";
+                    for (int file = 0; file < 8; ++file)
+                    {
+                        char value[16];
+                        std::snprintf(value, sizeof(value), "%3d", std::max(values[rank * 8 + file], highest - 255));
+                        source += value;
+                        source += rank < 7 || file < 7 ? "," : "";
+                    }
+                    source += "\n";
+                }
+                source += type < 5 ? "            },\n" : "            }\n";
+            }
+            source += phase == MIDDLEGAME ? "        },\n" : "        }\n";
+        }
+        source += "    };\n";
+        return source;
+    }
+
+    bool parseLine(std::string_view line, Position& position)
+    {
+        std::vector<std::string_view> words;
+        while (!line.empty())
+        {
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string_view::npos)
+            {
+                break;
+            }
+            line.remove_prefix(start);
+            size_t end = std::min(line.find_first_of(" \t\r"), line.size());
+            words.push_back(line.substr(0, end));
+            line.remove_prefix(end);
+        }
+        if (words.size() < 5)
+        {
+            return false;
+        }
+        // four position fields, then the move counters if they are there
+        std::string fen;
+        size_t next = 0;
+        for (; next < words.size() && next < 6; ++next)
+        {
+            bool counter = std::all_of(words[next].begin(), words[next].end(), [](unsigned char c) { return std::isdigit(c); });
+            if (next >= 4 && !counter)
+            {
+                break;
+            }
+            fen += (next > 0 ? " " : "") + std::string(words[next]);
+        }
+        bool labelled = false;
+        for (size_t word = next; word < words.size(); ++word)
+        {
+            labelled |= parseResult(words[word], position.result);
+        }
+        if (!labelled)
+        {
+            return false;
+        }
+        try
+        {
+            Board board(fen);
+            position.pieces.clear();
+            int phase = 0;
+            for (int piece = 0; piece < 12; ++piece)
+            {
+                uint64_t bitboard = board.getBitmaskForPiece(static_cast<Board::Piece>(piece));
+                position.pieces.toggle(piece, bitboard);
+                phase += __builtin_popcountll(bitboard) * Evaluation::PHASE_WEIGHT[piece % 6];
+            }
+            position.phase = static_cast<uint8_t>(std::min(phase, MAX_PHASE));
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<Position> load(std::istream& in, int threads, size_t* skipped)
+    {
+        // parsed a block at a time so the text never has to fit in memory at once
+        constexpr size_t BLOCK_LINES = size_t(1) << 18;
+        std::vector<Position> positions;
+        std::vector<std::string> lines;
+        std::vector<Position> parsed(BLOCK_LINES);
+        std::vector<uint8_t> valid(BLOCK_LINES);
+        size_t bad = 0;
+        while (in)
+        {
+            lines.clear();
+            for (std::string line; lines.size() < BLOCK_LINES && std::getline(in, line);)
+            {
+                lines.push_back(std::move(line));
+            }
+            forSlices(lines.size(), threads, [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    valid[i] = parseLine(lines[i], parsed[i]);
+                }
+            });
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                if (valid[i])
+                {
+                    positions.push_back(parsed[i]);
+                }
+                else if (lines[i].find_first_not_of(" \t\r") != std::string::npos)
+                {
+                    bad++;
+                }
+            }
+        }
+        if (skipped)
+        {
+            *skipped = bad;
+        }
+        return positions;
+    }
+
+    double evaluate(const Position& position, const Parameters& parameters)
+    {
+        Folded folded;
+        fold(parameters, folded);
+        return score(position, folded);
+    }
+
+    Tuner::Tuner(const std::vector<Position>& tuningPositions, const Config& tunerConfig)
+        : positions(tuningPositions), config(tunerConfig)
+    {
+        if (positions.empty())
+        {
+            throw std::invalid_argument("Tuner needs at least one position");
+        }
+        if (config.threads < 1 || config.epochs < 0 || !(config.learningRate > 0))
+        {
+            throw std::invalid_argument("Tuner needs at least one thread and a positive learning rate");
+        }
+    }
+
+    double Tuner::fitScale(const Parameters& parameters)
+    {
+        // golden-section search; the loss is unimodal in k
+        const double ratio = (std::sqrt(5.0) - 1) / 2;
+        double low = 0.0;
+        double high = 10.0;
+        for (int step = 0; step < 40; ++step)
+        {
+            double left = high - ratio * (high - low);
+            double right = low + ratio * (high - low);
+            scale = left;
+            double leftLoss = loss(parameters);
+            scale = right;
+            double rightLoss = loss(parameters);
+            if (leftLoss < rightLoss)
+            {
+                high = right;
+            }
+            else
+            {
+                low = left;
+            }
+        }
+        scale = (low + high) / 2;
+        return scale;
+    }
+
+    double Tuner::loss(const Parameters& parameters) const
+    {
+        Folded folded;
+        fold(parameters, folded);
+        const double slope = scale * std::log(10.0) / 400;
+        std::vector<double> sums(config.threads, 0.0);
+        forSlices(positions.size(), config.threads, [&](size_t begin, size_t end, size_t slice) {
+            double sum = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                double error = positions[i].result - 1 / (1 + std::exp(-slope * score(positions[i], folded)));
+                sum += error * error;
+            }
+            sums[slice] = sum;
+        });
+        double total = 0;
+        for (double sum : sums)
+        {
+            total += sum;
+        }
+        return total / positions.size();
+    }
+
+    double Tuner::gradient(const Parameters& parameters, Parameters& gradient) const
+    {
+        Folded folded;
+        fold(parameters, folded);
+        const double slope = scale * std::log(10.0) / 400;
+        std::vector<Folded> partial(config.threads); // zeroed
+        std::vector<double> sums(config.threads, 0.0);
+        forSlices(positions.size(), config.threads, [&](size_t begin, size_t end, size_t slice) {
+            Folded& local = partial[slice];
+            double sum = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Position& position = positions[i];
+                double probability = 1 / (1 + std::exp(-slope * score(position, folded)));
+                double error = probability - position.result;
+                sum += error * error;
+                // d(error^2)/d(score), split between the phases
+                double derivative = 2 * error * slope * probability * (1 - probability);
+                double middlegame = derivative * position.phase / MAX_PHASE;
+                double endgame = derivative - middlegame;
+                for (int piece = 0; piece < 12; ++piece)
+                {
+                    for (uint64_t bitboard = position.pieces.piece(piece); bitboard; bitboard &= bitboard - 1)
+                    {
+                        int square = __builtin_ctzll(bitboard);
+                        local.table[MIDDLEGAME][piece][square] += middlegame;
+                        local.table[ENDGAME][piece][square] += endgame;
+                    }
+                }
+                int pairs = bishopPairs(position);
+                local.bishopPair[MIDDLEGAME] += pairs * middlegame;
+                local.bishopPair[ENDGAME] += pairs * endgame;
+            }
+            sums[slice] = sum;
+        });
+
+        // gradients by folded entry; unfold() applies each piece's sign to turn them into parameter gradients
+        Folded& total = partial[0];
+        double sum = sums[0];
+        for (int slice = 1; slice < config.threads; ++slice)
+        {
+            accumulate(&total.table[0][0][0], &partial[slice].table[0][0][0], FOLDED_VALUES);
+            sum += sums[slice];
+        }
+        double* values = &total.table[0][0][0];
+        for (size_t i = 0; i < FOLDED_VALUES; ++i)
+        {
+            values[i] /= positions.size();
+        }
+        gradient.resize(PARAMETER_COUNT);
+        unfold(total, gradient);
+        return sum / positions.size();
+    }
+
+    void Tuner::tune(Parameters& parameters, const std::function<void(int epoch, double loss)>& progress) const
+    {
+        const double beta1 = 0.9;
+        const double beta2 = 0.999;
+        const double epsilon = 1e-12;
+        Parameters momentum(PARAMETER_COUNT, 0.0);
+        Parameters velocity(PARAMETER_COUNT, 0.0);
+        Parameters step;
+        for (int epoch = 1; epoch <= config.epochs; ++epoch)
+        {
+            double currentLoss = gradient(parameters, step);
+            double correction1 = 1 - std::pow(beta1, epoch);
+            double correction2 = 1 - std::pow(beta2, epoch);
+            for (int i = 0; i < PARAMETER_COUNT; ++i)
+            {
+                momentum[i] = beta1 * momentum[i] + (1 - beta1) * step[i];
+                velocity[i] = beta2 * velocity[i] + (1 - beta2) * step[i] * step[i];
+                parameters[i] -= config.learningRate * (momentum[i] / correction1)
+                                 / (std::sqrt(velocity[i] / correction2) + epsilon);
+            }
+            if (progress)
+            {
+                progress(epoch, currentLoss);
+            }
+        }
+    }
+}
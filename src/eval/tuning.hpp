@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "board/bitboards.hpp"
+
+/**
+ * @brief Texel-style tuning of the evaluation tables against game results.
+ *
+ * Every term of Evaluation::evaluate() is linear in its table entries, so the
+ * score of a position is a weighted sum of parameters, with the phase deciding
+ * how much the middlegame and endgame entries count. The tuner minimises the
+ * mean squared error between each game's result and the win probability
+ * 1 / (1 + 10^(-k * score / 400)) by full-batch Adam over the exact gradient.
+ *
+ * Positions are kept as compact boards (BoardLayout::Compact plus the label,
+ * 80 bytes each), so tens of millions fit in memory. Each thread sums the
+ * gradient of a slice of them, and the per-thread sums are combined with
+ * vector adds.
+ */
+namespace Tuning {
+    // Parameters are flattened in this order, matching evaluation_tables.hpp:
+    // MATERIAL[type], PIECE_SQUARE[phase][type][square, rank 8 first], BISHOP_PAIR[phase]
+    constexpr int MATERIAL_OFFSET = 0;
+    constexpr int PIECE_SQUARE_OFFSET = 6;
+    constexpr int BISHOP_PAIR_OFFSET = PIECE_SQUARE_OFFSET + 2 * 6 * 64;
+    constexpr int PARAMETER_COUNT = BISHOP_PAIR_OFFSET + 2;
+    using Parameters = std::vector<double>;
+
+    /**
+     * @brief The parameters Evaluation::evaluate() currently uses.
+     */
+    Parameters defaults();
+    /**
+     * @brief Writes `parameters`, rounded, as C++ tables laid out like evaluation_tables.hpp.
+     *
+     * The bit-plane evaluators need each piece-square table to span at most
+     * 255, so wider tables are clipped from below.
+     */
+    std::string toSource(const Parameters& parameters);
+
+    /**
+     * @brief One labelled position.
+     */
+    struct Position {
+        BoardLayout::Compact pieces;
+        float result; // 1 white won, 0.5 draw, 0 black won
+        uint8_t phase; // 0 (bare kings and pawns) to MAX_PHASE (all pieces), see evaluation_tables.hpp
+    };
+
+    /**
+     * @brief Reads a FEN or EPD followed by the game result. Non-throwing.
+     *
+     * The result is the last word that reads as one: 1-0, 0-1, 1/2-1/2, 1.0,
+     * 0.5 or 0.0, optionally in quotes or brackets, so `<FEN> [0.5]` and EPD
+     * with `c9 "1-0";` both work.
+     * @return bool False if the line has no position or no result.
+     */
+    bool parseLine(std::string_view line, Position& position);
+    /**
+     * @brief Parses every line of `in` on `threads` threads, in order.
+     * @param skipped If set, receives the number of lines that did not parse.
+     */
+    std::vector<Position> load(std::istream& in, int threads, size_t* skipped = nullptr);
+
+    /**
+     * @brief The score of `position` under `parameters`, from white's point of view.
+     *
+     * Matches Evaluation::evaluate() for the default parameters, except that
+     * the phase blend is not rounded.
+     */
+    double evaluate(const Position& position, const Parameters& parameters);
+
+    struct Config {
+        int threads = 1;
+        int epochs = 500;
+        double learningRate = 1.0; // centipawns per step at full Adam momentum
+    };
+
+    class Tuner {
+        const std::vector<Position>& positions;
+        Config config;
+        double scale = 1.0;
+
+        public:
+        /**
+         * @throws std::invalid_argument If there are no positions or the config is out of range.
+         */
+        Tuner(const std::vector<Position>& positions, const Config& config);
+        /**
+         * @brief Finds the k that fits `parameters` best and uses it from then on.
+         */
+        double fitScale(const Parameters& parameters);
+        double getScale() const { return scale; }
+        void setScale(double k) { scale = k; }
+        double loss(const Parameters& parameters) const;
+        /**
+         * @brief Writes the gradient of the loss to `gradient`.
+         * @return double The loss.
+         */
+        double gradient(const Parameters& parameters, Parameters& gradient) const;
+        /**
+         * @brief Runs config.epochs steps of Adam on `parameters`.
+         * @param progress Called after each epoch with its number and the loss before the step.
+         */
+        void tune(Parameters& parameters, const std::function<void(int epoch, double loss)>& progress = {}) const;
+    };
+}
@@ -0,0 +1,110 @@
+#include "position_index.hpp"
+#include "position_index_file.hpp"
+#include "book/polyglot.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    uint64_t readVarint(const uint8_t*& bytes)
+    {
+        uint64_t value = 0;
+        int shift = 0;
+        while (*bytes & 0x80)
+        {
+            value |= static_cast<uint64_t>(*bytes++ & 0x7f) << shift;
+            shift += 7;
+        }
+        return value | (static_cast<uint64_t>(*bytes++) << shift);
+    }
+}
+
+namespace PositionIndex {
+    Index::Index(const std::string& path) : file(path), keyCount(0), tableOffset(0)
+    {
+        FileHeader header;
+        if (file.size() < sizeof(header))
+        {
+            throw std::runtime_error("Not a position index: " + path);
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "CPI1", 4) != 0)
+        {
+            throw std::runtime_error("Not a position index: " + path);
+        }
+        if (header.tableOffset > file.size() || (file.size() - header.tableOffset) / sizeof(KeyEntry) != header.keyCount)
+        {
+            throw std::runtime_error("Truncated position index: " + path);
+        }
+        keyCount = header.keyCount;
+        tableOffset = header.tableOffset;
+    }
+    uint64_t Index::find(uint64_t key) const
+    {
+        const uint8_t* table = file.data() + tableOffset;
+        uint64_t low = 0;
+        uint64_t high = keyCount;
+        while (low < high)
+        {
+            uint64_t middle = low + (high - low) / 2;
+            uint64_t middleKey;
+            std::memcpy(&middleKey, table + middle * sizeof(KeyEntry), sizeof(middleKey));
+            if (middleKey < key)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        if (low < keyCount)
+        {
+            uint64_t foundKey;
+            std::memcpy(&foundKey, table + low * sizeof(KeyEntry), sizeof(foundKey));
+            if (foundKey == key)
+            {
+                return low;
+            }
+        }
+        return keyCount;
+    }
+    const uint8_t* Index::postings(uint64_t slot) const
+    {
+        KeyEntry entry;
+        std::memcpy(&entry, file.data() + tableOffset + slot * sizeof(KeyEntry), sizeof(entry));
+        return file.data() + entry.offset;
+    }
+    std::vector<uint32_t> Index::games(uint64_t key) const
+    {
+        std::vector<uint32_t> result;
+        uint64_t slot = find(key);
+        if (slot == keyCount)
+        {
+            return result;
+        }
+        const uint8_t* bytes = postings(slot);
+        uint64_t count = readVarint(bytes);
+        result.reserve(count);
+        uint32_t game = 0;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            game += static_cast<uint32_t>(readVarint(bytes));
+            result.push_back(game);
+        }
+        return result;
+    }
+    std::vector<uint32_t> Index::games(const Board& board) const
+    {
+        return games(Polyglot::key(board));
+    }
+    uint32_t Index::gameCount(uint64_t key) const
+    {
+        uint64_t slot = find(key);
+        if (slot == keyCount)
+        {
+            return 0;
+        }
+        const uint8_t* bytes = postings(slot);
+        return static_cast<uint32_t>(readVarint(bytes));
+    }
+}
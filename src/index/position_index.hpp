@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "board/board.hpp"
+#include "util/mapped_file.hpp"
+
+/**
+ * @brief On-disk index from positions to the games that reach them.
+ *
+ * Positions are identified by their Polyglot key. The index file holds, for
+ * every distinct key, the sorted list of game ids reaching it, stored as
+ * varint-encoded gaps. A sorted key table at the end of the file is binary
+ * searched through an mmap, so a query reads a handful of pages no matter how
+ * large the collection is.
+ */
+namespace PositionIndex {
+    /**
+     * @brief Builds an index file from (position, game) pairs.
+     *
+     * Pairs are buffered in memory; whenever `maxBufferedPositions` is reached
+     * the buffer is sorted and spilled to a temporary run file next to the
+     * output, and finish() merges the runs. Memory use therefore stays bounded
+     * however many games are added.
+     */
+    class Writer {
+        struct Posting {
+            uint64_t key;
+            uint32_t game;
+            // run files hold postings byte for byte, so there is no padding to leave uninitialised
+            uint32_t reserved = 0;
+            bool operator<(const Posting& other) const
+            {
+                return key != other.key ? key < other.key : game < other.game;
+            }
+            bool operator==(const Posting& other) const { return key == other.key && game == other.game; }
+        };
+        std::string path;
+        size_t maxBuffered;
+        std::vector<Posting> buffer;
+        std::vector<std::string> runs;
+        bool finished = false;
+
+        void spill();
+        // writes the index and its key table to the two temporary files
+        void write(const std::string& temporary, const std::string& tableTemporary);
+
+        public:
+        explicit Writer(const std::string& path, size_t maxBufferedPositions = 1 << 22);
+        // removes leftover run files if finish() was never reached
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * @brief Records that game `game` reaches the position with key `key`.
+         */
+        void addPosition(uint64_t key, uint32_t game);
+        /**
+         * @brief Records every position of a game, the start position included.
+         */
+        void addGame(uint32_t game, Board board, const std::vector<Board::Move>& moves);
+        /**
+         * @brief Merges everything added so far and writes the index.
+         *
+         * On failure the temporary files are removed and finish() can be retried.
+         * @throws std::runtime_error If a file cannot be written or read back.
+         */
+        void finish();
+    };
+
+    /**
+     * @brief A memory-mapped index file.
+     */
+    class Index {
+        MappedFile file;
+        uint64_t keyCount;
+        uint64_t tableOffset;
+
+        // position of `key` in the key table, or keyCount if absent
+        uint64_t find(uint64_t key) const;
+        const uint8_t* postings(uint64_t slot) const;
+
+        public:
+        /**
+         * @brief Maps `path` and checks its header; postings are read on demand.
+         * @throws std::runtime_error If the file is missing or not an index.
+         */
+        explicit Index(const std::string& path);
+
+        uint64_t positionCount() const { return keyCount; }
+        /**
+         * @brief Returns the ids of every game reaching the position, ascending.
+         */
+        std::vector<uint32_t> games(uint64_t key) const;
+        std::vector<uint32_t> games(const Board& board) const;
+        /**
+         * @brief Returns how many games reach the position without decoding their ids.
+         */
+        uint32_t gameCount(uint64_t key) const;
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of a position index, integers in native byte order:
+//   header
+//   postings: per key, varint game count, then the first game id and the
+//             gaps to each following id as varints
+//   key table: keyCount x {uint64 key, uint64 postings offset}, sorted by key
+// Internal to the index module.
+namespace PositionIndex {
+    struct FileHeader {
+        char magic[4];        // "CPI1"
+        uint32_t reserved;
+        uint64_t keyCount;
+        uint64_t tableOffset; // byte offset of the key table
+        uint64_t gameCount;   // highest game id plus one
+    };
+    static_assert(sizeof(FileHeader) == 32, "index header must stay 32 bytes");
+
+    struct KeyEntry {
+        uint64_t key;
+        uint64_t offset;
+    };
+    static_assert(sizeof(KeyEntry) == 16, "key entries must stay 16 bytes");
+}
@@ -0,0 +1,243 @@
+#include "position_index.hpp"
+#include "position_index_file.hpp"
+#include "book/polyglot.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+    void writeVarint(std::ofstream& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.put(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    // groups sorted postings by key and writes each group as it completes
+    class PostingEncoder {
+        std::ofstream& postings;
+        std::ofstream& table;
+        uint64_t offset;
+        uint64_t currentKey = 0;
+        std::vector<uint32_t> games;
+
+        public:
+        uint64_t keyCount = 0;
+        uint64_t gameCount = 0;
+
+        PostingEncoder(std::ofstream& postings, std::ofstream& table, uint64_t offset)
+            : postings(postings), table(table), offset(offset) {}
+
+        void add(uint64_t key, uint32_t game)
+        {
+            if (!games.empty() && key != currentKey)
+            {
+                flush();
+            }
+            // runs may overlap, so the same pair can arrive twice in a row
+            if (games.empty() || games.back() != game)
+            {
+                games.push_back(game);
+            }
+            currentKey = key;
+            gameCount = std::max<uint64_t>(gameCount, game + 1ULL);
+        }
+        void flush()
+        {
+            if (games.empty())
+            {
+                return;
+            }
+            PositionIndex::KeyEntry entry{currentKey, offset};
+            table.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            std::streampos start = postings.tellp();
+            writeVarint(postings, games.size());
+            uint32_t previous = 0;
+            for (uint32_t game : games)
+            {
+                writeVarint(postings, game - previous);
+                previous = game;
+            }
+            offset += static_cast<uint64_t>(postings.tellp() - start);
+            ++keyCount;
+            games.clear();
+        }
+        uint64_t end() const { return offset; }
+    };
+}
+
+namespace PositionIndex {
+    Writer::Writer(const std::string& path, size_t maxBufferedPositions)
+        : path(path), maxBuffered(std::max<size_t>(1, maxBufferedPositions))
+    {
+        buffer.reserve(std::min<size_t>(maxBuffered, 1 << 16));
+    }
+    Writer::~Writer()
+    {
+        std::error_code error;
+        for (const std::string& run : runs)
+        {
+            std::filesystem::remove(run, error);
+        }
+    }
+    void Writer::addPosition(uint64_t key, uint32_t game)
+    {
+        if (finished)
+        {
+            throw std::logic_error("Position index already written");
+        }
+        buffer.push_back({key, game});
+        if (buffer.size() >= maxBuffered)
+        {
+            spill();
+        }
+    }
+    void Writer::addGame(uint32_t game, Board board, const std::vector<Board::Move>& moves)
+    {
+        addPosition(Polyglot::key(board), game);
+        for (const Board::Move& move : moves)
+        {
+            board.makeMove(move);
+            addPosition(Polyglot::key(board), game);
+        }
+    }
+    void Writer::spill()
+    {
+        std::sort(buffer.begin(), buffer.end());
+        buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+        std::string run = path + ".run" + std::to_string(runs.size());
+        std::ofstream out(run, std::ios::binary | std::ios::trunc);
+        static_assert(sizeof(Posting) == 16, "run files hold postings without padding");
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Posting));
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write " + run);
+        }
+        runs.push_back(run);
+        buffer.clear();
+    }
+    void Writer::finish()
+    {
+        if (finished)
+        {
+            return;
+        }
+        std::string temporary = path + ".tmp";
+        std::string tableTemporary = path + ".keys";
+        try
+        {
+            write(temporary, tableTemporary);
+            std::filesystem::remove(tableTemporary);
+            std::filesystem::rename(temporary, path);
+        }
+        catch (...)
+        {
+            std::error_code error;
+            std::filesystem::remove(temporary, error);
+            std::filesystem::remove(tableTemporary, error);
+            throw;
+        }
+        finished = true;
+        std::error_code error;
+        for (const std::string& run : runs)
+        {
+            std::filesystem::remove(run, error);
+        }
+        runs.clear();
+    }
+    void Writer::write(const std::string& temporary, const std::string& tableTemporary)
+    {
+        FileHeader header{};
+        std::memcpy(header.magic, "CPI1", 4);
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            std::ofstream table(tableTemporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            PostingEncoder encoder(out, table, sizeof(header));
+
+            if (runs.empty())
+            {
+                std::sort(buffer.begin(), buffer.end());
+                for (const Posting& posting : buffer)
+                {
+                    encoder.add(posting.key, posting.game);
+                }
+            }
+            else
+            {
+                if (!buffer.empty())
+                {
+                    spill();
+                }
+                // k-way merge, one buffered reader per run
+                struct Run {
+                    std::ifstream in;
+                    Posting current;
+                };
+                std::vector<std::unique_ptr<Run>> readers;
+                auto later = [&readers](size_t a, size_t b) { return readers[b]->current < readers[a]->current; };
+                std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+                for (const std::string& run : runs)
+                {
+                    readers.push_back(std::make_unique<Run>());
+                    readers.back()->in.open(run, std::ios::binary);
+                    if (readers.back()->in.read(reinterpret_cast<char*>(&readers.back()->current), sizeof(Posting)))
+                    {
+                        heap.push(readers.size() - 1);
+                    }
+                }
+                while (!heap.empty())
+                {
+                    size_t next = heap.top();
+                    heap.pop();
+                    encoder.add(readers[next]->current.key, readers[next]->current.game);
+                    if (readers[next]->in.read(reinterpret_cast<char*>(&readers[next]->current), sizeof(Posting)))
+                    {
+                        heap.push(next);
+                    }
+                }
+            }
+            encoder.flush();
+            buffer.clear();
+            buffer.shrink_to_fit();
+
+            // pad so the key table starts 8-byte aligned, then append it
+            header.tableOffset = (encoder.end() + 7) / 8 * 8;
+            for (uint64_t i = encoder.end(); i < header.tableOffset; ++i)
+            {
+                out.put(0);
+            }
+            header.keyCount = encoder.keyCount;
+            header.gameCount = encoder.gameCount;
+            table.close();
+            if (!table)
+            {
+                throw std::runtime_error("Cannot write " + tableTemporary);
+            }
+            // copying an empty stream buffer sets failbit, so an empty index skips the copy
+            if (header.keyCount > 0)
+            {
+                std::ifstream keys(tableTemporary, std::ios::binary);
+                if (!keys || !(out << keys.rdbuf()))
+                {
+                    throw std::runtime_error("Cannot read back " + tableTemporary);
+                }
+            }
+            out.seekp(0);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error("Cannot write " + temporary);
+            }
+        }
+    }
+}
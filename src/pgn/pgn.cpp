@@ -0,0 +1,119 @@
+#include "pgn.hpp"
+#include <cctype>
+#include <limits>
+
+namespace {
+    bool isResult(const std::string& token)
+    {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+}
+
+namespace Pgn {
+    bool Reader::next(Game& game)
+    {
+        game = Game();
+        bool inMoves = false;
+        int variationDepth = 0;
+        std::string token;
+        char c;
+
+        // flushes the token collected so far into the move list
+        auto endToken = [&]() {
+            if (token.empty())
+            {
+                return false;
+            }
+            std::string text = token;
+            token.clear();
+            if (isResult(text))
+            {
+                game.result = text;
+                return true;
+            }
+            // drop the move number in front of the move, e.g. "12." or "12..."
+            size_t start = 0;
+            while (start < text.size() && (std::isdigit(static_cast<unsigned char>(text[start])) || text[start] == '.'))
+            {
+                ++start;
+            }
+            if (start < text.size() && text[start] != '$')
+            {
+                game.moves.push_back(text.substr(start));
+            }
+            return false;
+        };
+
+        while (in.get(c))
+        {
+            if (c == '[' && inMoves && variationDepth == 0)
+            {
+                // a game without a result: leave the tags for the next call
+                in.unget();
+                break;
+            }
+            if (c == '[')
+            {
+                std::string line;
+                std::getline(in, line);
+                size_t space = line.find(' ');
+                size_t open = line.find('"');
+                size_t close = line.rfind('"');
+                if (space != std::string::npos && open != std::string::npos && close > open)
+                {
+                    game.tags[line.substr(0, space)] = line.substr(open + 1, close - open - 1);
+                }
+                continue;
+            }
+            if (c == '{')
+            {
+                endToken();
+                in.ignore(std::numeric_limits<std::streamsize>::max(), '}');
+                continue;
+            }
+            if (c == ';' && variationDepth == 0)
+            {
+                endToken();
+                in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                continue;
+            }
+            if (c == '(' || c == ')')
+            {
+                // a main line move written right against the bracket, as in "e4(", still counts
+                if (variationDepth == 0 && endToken())
+                {
+                    break;
+                }
+                token.clear();
+                variationDepth += c == '(' ? 1 : -1;
+                continue;
+            }
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                if (variationDepth == 0 && endToken())
+                {
+                    break;
+                }
+                continue;
+            }
+            if (variationDepth > 0)
+            {
+                continue;
+            }
+            inMoves = true;
+            token += c;
+        }
+        endToken();
+
+        auto fen = game.tags.find("FEN");
+        if (fen != game.tags.end())
+        {
+            game.startFen = fen->second;
+        }
+        if (game.result.empty() && game.tags.count("Result"))
+        {
+            game.result = game.tags["Result"];
+        }
+        return inMoves || !game.tags.empty();
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Minimal PGN reading: tag pairs and main-line SAN moves.
+ *
+ * Comments, variations, NAGs and move numbers are skipped. Moves are kept as
+ * text; replay them with Board::parseSAN() from `startFen`.
+ */
+namespace Pgn {
+    struct Game {
+        std::map<std::string, std::string> tags;
+        std::vector<std::string> moves;
+        std::string result; // "1-0", "0-1", "1/2-1/2" or "*"
+        std::string startFen; // the FEN tag, empty for the standard start position
+    };
+
+    /**
+     * @brief Reads games one at a time from a stream.
+     */
+    class Reader {
+        std::istream& in;
+
+        public:
+        explicit Reader(std::istream& in) : in(in) {}
+        /**
+         * @brief Reads the next game into `game`.
+         * @return bool False once the stream holds no more games.
+         */
+        bool next(Game& game);
+    };
+}
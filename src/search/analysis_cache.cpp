@@ -0,0 +1,189 @@
+#include "analysis_cache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using namespace Search;
+
+    // the first 64 bytes of the file; entries follow
+    struct FileHeader {
+        char magic[8];
+        uint64_t version;
+        uint64_t buckets;
+        uint64_t reserved[5];
+    };
+    static_assert(sizeof(FileHeader) == 64, "the cache header fills one bucket");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "entries are shared between processes");
+    constexpr char MAGIC[8] = {'C', 'H', 'E', 'S', 'S', 'A', 'C', '1'};
+    constexpr uint64_t VERSION = 1;
+    constexpr size_t BUCKET_BYTES = 64;
+
+    // data word: score 0-15, from 16-21, to 22-27, promotion 28-31, depth 32-39,
+    // bound 40-41, then flags; an all-zero word is an empty entry
+    constexpr uint64_t VALID = 1ULL << 42;
+    constexpr uint64_t HAS_MOVE = 1ULL << 43;
+
+    uint64_t pack(const CachedResult& result)
+    {
+        uint64_t data = static_cast<uint16_t>(static_cast<int16_t>(std::clamp(result.score, -32767, 32767)));
+        if (result.move.from >= 0)
+        {
+            data |= HAS_MOVE | uint64_t(result.move.from & 63) << 16 | uint64_t(result.move.to & 63) << 22
+                  | uint64_t(result.move.promotion & 15) << 28;
+        }
+        return data | uint64_t(std::clamp(result.depth, 0, 255)) << 32 | uint64_t(result.bound & 3) << 40 | VALID;
+    }
+    CachedResult unpack(uint64_t data)
+    {
+        CachedResult result;
+        result.score = static_cast<int16_t>(data & 0xFFFF);
+        if (data & HAS_MOVE)
+        {
+            result.move = {static_cast<int>((data >> 16) & 63), static_cast<int>((data >> 22) & 63),
+                           static_cast<Board::Piece>((data >> 28) & 15)};
+        }
+        result.depth = static_cast<int>((data >> 32) & 0xFF);
+        result.bound = static_cast<Bound>((data >> 40) & 3);
+        return result;
+    }
+    uint64_t bucketsFor(size_t bytes)
+    {
+        uint64_t buckets = 1;
+        while (buckets * 2 * BUCKET_BYTES <= bytes)
+        {
+            buckets *= 2;
+        }
+        return buckets;
+    }
+    // checks an existing header and returns its bucket count
+    uint64_t validBuckets(const FileHeader& header, uint64_t fileSize, const std::string& path)
+    {
+        uint64_t buckets = header.buckets;
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || buckets == 0
+            || (buckets & (buckets - 1)) != 0 || fileSize != sizeof(FileHeader) + buckets * BUCKET_BYTES)
+        {
+            throw std::runtime_error(path + " is not an analysis cache");
+        }
+        return buckets;
+    }
+}
+
+namespace Search {
+#ifdef _WIN32
+    AnalysisCache::AnalysisCache(const std::string& path, size_t)
+    {
+        throw std::runtime_error("Cannot open " + path + ": analysis caches need a POSIX system");
+    }
+    AnalysisCache::~AnalysisCache() = default;
+#else
+    AnalysisCache::AnalysisCache(const std::string& path, size_t bytes)
+    {
+        int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        // processes starting together must not both initialise a new file
+        flock(fd, LOCK_EX);
+        struct stat info;
+        FileHeader header{};
+        bool ready = fstat(fd, &info) == 0;
+        if (ready && info.st_size == 0)
+        {
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.buckets = bucketsFor(bytes);
+            info.st_size = static_cast<off_t>(sizeof(FileHeader) + header.buckets * BUCKET_BYTES);
+            // the new entries read back as zeros, which is an empty entry
+            ready = ftruncate(fd, info.st_size) == 0
+                 && pwrite(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+        }
+        else if (ready)
+        {
+            ready = pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+                 || info.st_size < static_cast<off_t>(sizeof(header));
+        }
+        flock(fd, LOCK_UN);
+        try
+        {
+            if (!ready)
+            {
+                throw std::runtime_error("Cannot initialise " + path);
+            }
+            bucketMask = validBuckets(header, static_cast<uint64_t>(info.st_size), path) - 1;
+        }
+        catch (...)
+        {
+            close(fd);
+            throw;
+        }
+        mappedBytes = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        // the mapping stays valid after the descriptor is closed
+        close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot map " + path);
+        }
+        entries = reinterpret_cast<Entry*>(static_cast<char*>(mapping) + sizeof(FileHeader));
+    }
+    AnalysisCache::~AnalysisCache()
+    {
+        munmap(mapping, mappedBytes);
+    }
+#endif
+
+    bool AnalysisCache::probe(uint64_t hash, CachedResult& result) const
+    {
+        Entry* bucket = bucketFor(hash);
+        for (int i = 0; i < BUCKET_SIZE; ++i)
+        {
+            uint64_t data = bucket[i].data.load(std::memory_order_acquire);
+            uint64_t check = bucket[i].check.load(std::memory_order_acquire);
+            if ((data & VALID) && (check ^ data) == hash)
+            {
+                result = unpack(data);
+                return true;
+            }
+        }
+        return false;
+    }
+    void AnalysisCache::store(uint64_t hash, const CachedResult& result)
+    {
+        Entry* bucket = bucketFor(hash);
+        Entry* target = nullptr;
+        int shallowest = 256;
+        for (int i = 0; i < BUCKET_SIZE; ++i)
+        {
+            uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+            uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+            int depth = (data & VALID) ? static_cast<int>((data >> 32) & 0xFF) : -1;
+            if ((data & VALID) && (check ^ data) == hash)
+            {
+                if (depth > result.depth)
+                {
+                    return;
+                }
+                target = &bucket[i];
+                break;
+            }
+            if (depth < shallowest)
+            {
+                shallowest = depth;
+                target = &bucket[i];
+            }
+        }
+        uint64_t data = pack(result);
+        target->data.store(data, std::memory_order_release);
+        target->check.store(hash ^ data, std::memory_order_release);
+    }
+}
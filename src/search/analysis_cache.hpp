@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "board/board.hpp"
+
+namespace Search {
+    enum Bound : uint8_t {
+        EXACT, // the score is the position's value at that depth
+        LOWER, // the true score is at least this
+        UPPER  // the true score is at most this
+    };
+    /**
+     * @brief One stored search result.
+     */
+    struct CachedResult {
+        int depth = 0;
+        int score = 0; // centipawns for the side to move
+        Board::Move move = {-1, -1};
+        Bound bound = EXACT;
+    };
+
+    /**
+     * @brief File-backed table of search results that outlives the process.
+     *
+     * The file is mapped shared, so every process that opens the same path
+     * sees the others' results as soon as they are written, and the OS writes
+     * them back to disk. Entries are two 64-bit words, the packed result and
+     * the key XOR the result, each written with a single atomic store. A
+     * reader whose words come from two different writes gets a key mismatch
+     * and treats the entry as missing, so no locks are needed between
+     * processes.
+     *
+     * Results are keyed by Board::getHash() alone, so the position's history
+     * (repetitions) is not part of the key. Four entries share a 64-byte
+     * bucket; a new result replaces the same position if it is at least as
+     * deep, and otherwise the shallowest entry of the bucket.
+     *
+     * POSIX only: a new file is set up under flock() so that processes
+     * starting together agree on its size, and then mapped with mmap(). On
+     * Windows the constructor always throws.
+     */
+    class AnalysisCache {
+        struct Entry {
+            std::atomic<uint64_t> check; // key ^ data
+            std::atomic<uint64_t> data;
+        };
+        static constexpr int BUCKET_SIZE = 4;
+        Entry* entries = nullptr;
+        uint64_t bucketMask = 0;
+        void* mapping = nullptr;
+        size_t mappedBytes = 0;
+
+        Entry* bucketFor(uint64_t hash) const { return entries + (hash & bucketMask) * BUCKET_SIZE; }
+
+        public:
+        /**
+         * @brief Opens the cache at `path`, creating it with about `bytes` of
+         * entries if it does not exist. An existing cache keeps its size.
+         * @throws std::runtime_error If the file cannot be created or mapped, is
+         * not an analysis cache, or this is not a POSIX system.
+         */
+        explicit AnalysisCache(const std::string& path, size_t bytes = size_t(64) << 20);
+        ~AnalysisCache();
+        AnalysisCache(const AnalysisCache&) = delete;
+        AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+        /**
+         * @brief Looks up `hash`; returns false if no intact entry holds it.
+         */
+        bool probe(uint64_t hash, CachedResult& result) const;
+        /**
+         * @brief Stores a result for `hash`. Safe to call from any thread or process.
+         */
+        void store(uint64_t hash, const CachedResult& result);
+        /**
+         * @brief Number of entries the file holds.
+         */
+        size_t capacity() const { return (bucketMask + 1) * BUCKET_SIZE; }
+    };
+}
@@ -0,0 +1,238 @@
+#include "mate.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // proof numbers saturate here; a value of INFINITE settles a node
+    constexpr uint32_t INFINITE = 100000000;
+
+    uint32_t saturate(uint64_t value)
+    {
+        return static_cast<uint32_t>(std::min<uint64_t>(value, INFINITE));
+    }
+}
+
+namespace Mate {
+    Solver::Solver(size_t tableBytes)
+    {
+        size_t buckets = 1;
+        while (buckets * 2 * BUCKET_SIZE * sizeof(Entry) <= tableBytes)
+        {
+            buckets *= 2;
+        }
+        table.resize(buckets * BUCKET_SIZE);
+        bucketMask = buckets - 1;
+    }
+    void Solver::clear()
+    {
+        std::fill(table.begin(), table.end(), Entry{});
+    }
+    uint64_t Solver::entryKey(uint64_t hash, int remaining)
+    {
+        // the same position with fewer plies left is a different problem
+        return hash ^ ((remaining + 1) * 0x9E3779B97F4A7C15ULL);
+    }
+    bool Solver::lookup(uint64_t key, uint32_t& phi, uint32_t& delta) const
+    {
+        const Entry* bucket = &table[(key & bucketMask) * BUCKET_SIZE];
+        for (int i = 0; i < BUCKET_SIZE; ++i)
+        {
+            if (bucket[i].key == key)
+            {
+                phi = bucket[i].phi;
+                delta = bucket[i].delta;
+                return true;
+            }
+        }
+        return false;
+    }
+    void Solver::store(uint64_t key, uint32_t phi, uint32_t delta, uint64_t work)
+    {
+        Entry* bucket = &table[(key & bucketMask) * BUCKET_SIZE];
+        Entry* victim = bucket;
+        for (int i = 0; i < BUCKET_SIZE; ++i)
+        {
+            if (bucket[i].key == key)
+            {
+                victim = &bucket[i];
+                break;
+            }
+            // settled entries are what the principal variation is read from, keep them longest
+            auto worth = [](const Entry& entry) {
+                bool settled = entry.phi == 0 || entry.delta == 0;
+                return (uint64_t(settled) << 32) + entry.work;
+            };
+            if (worth(bucket[i]) < worth(*victim))
+            {
+                victim = &bucket[i];
+            }
+        }
+        *victim = {key, phi, delta, saturate(work)};
+    }
+    void Solver::search(Board& board, int remaining, bool attacker, uint32_t thresholdPhi, uint32_t thresholdDelta)
+    {
+        uint64_t startNodes = nodes++;
+        if (nodeLimit && nodes >= nodeLimit)
+        {
+            stopped = true;
+        }
+        uint64_t key = entryKey(board.getHash(), remaining);
+        Board::MoveList moves = board.generateMoves();
+        if (moves.size() == 0 || remaining == 0)
+        {
+            bool mated = moves.size() == 0 && board.inCheck();
+            // mate is a win for the attacker; stalemate or running out of plies is a win for the defender
+            bool sideToMoveWins = !mated && !attacker;
+            store(key, sideToMoveWins ? 0 : INFINITE, sideToMoveWins ? INFINITE : 0, 1);
+            return;
+        }
+
+        uint64_t childKeys[256];
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            Board::UndoInfo undo = board.makeMove(moves[i]);
+            childKeys[i] = entryKey(board.getHash(), remaining - 1);
+            board.unmakeMove(moves[i], undo);
+        }
+
+        while (true)
+        {
+            // phi is the smallest child delta and delta the sum of child phis
+            uint32_t phi = INFINITE;
+            uint32_t secondDelta = INFINITE;
+            uint64_t delta = 0;
+            uint32_t bestPhi = 0;
+            int best = 0;
+            for (int i = 0; i < moves.size(); ++i)
+            {
+                uint32_t childPhi = 1;
+                uint32_t childDelta = 1;
+                lookup(childKeys[i], childPhi, childDelta);
+                delta += childPhi;
+                if (childDelta < phi)
+                {
+                    secondDelta = phi;
+                    phi = childDelta;
+                    bestPhi = childPhi;
+                    best = i;
+                }
+                else if (childDelta < secondDelta)
+                {
+                    secondDelta = childDelta;
+                }
+            }
+            uint32_t nodeDelta = saturate(delta);
+            if (phi >= thresholdPhi || nodeDelta >= thresholdDelta || stopped)
+            {
+                store(key, phi, nodeDelta, nodes - startNodes);
+                return;
+            }
+            uint32_t childPhiThreshold = saturate(uint64_t(thresholdDelta) + bestPhi - nodeDelta);
+            uint32_t childDeltaThreshold = std::min<uint32_t>(thresholdPhi, secondDelta + 1);
+            Board::UndoInfo undo = board.makeMove(moves[best]);
+            search(board, remaining - 1, !attacker, childPhiThreshold, childDeltaThreshold);
+            board.unmakeMove(moves[best], undo);
+        }
+    }
+    Status Solver::prove(Board& board, int remaining, bool attacker)
+    {
+        search(board, remaining, attacker, INFINITE, INFINITE);
+        uint32_t phi = 1;
+        uint32_t delta = 1;
+        lookup(entryKey(board.getHash(), remaining), phi, delta);
+        if (phi != 0 && delta != 0)
+        {
+            return UNKNOWN;
+        }
+        // phi == 0 means the side to move wins
+        return (phi == 0) == attacker ? MATE : NO_MATE;
+    }
+    std::vector<Board::Move> Solver::principalVariation(Board board, int remaining)
+    {
+        std::vector<Board::Move> line;
+        for (bool attacker = true; remaining > 0; attacker = !attacker, --remaining)
+        {
+            // the attacker needs a reply that loses for the defender, the defender
+            // only has replies that lose; either way the child's delta is 0
+            bool found = false;
+            for (const Board::Move& move : board.generateMoves())
+            {
+                Board::UndoInfo undo = board.makeMove(move);
+                uint32_t phi = 1;
+                uint32_t delta = 1;
+                bool settled = lookup(entryKey(board.getHash(), remaining - 1), phi, delta) && (attacker ? delta == 0 : phi == 0);
+                if (settled)
+                {
+                    line.push_back(move);
+                    found = true;
+                    break;
+                }
+                board.unmakeMove(move, undo);
+            }
+            if (!found)
+            {
+                break;
+            }
+        }
+        return line;
+    }
+    Result Solver::solve(const Board& board, const Limits& limits)
+    {
+        if (limits.maxPly < 1 || limits.maxPly > 255)
+        {
+            throw std::invalid_argument("Mate search needs between 1 and 255 plies");
+        }
+        nodes = 0;
+        nodeLimit = limits.nodes;
+        stopped = false;
+
+        Result result;
+        Board position = board;
+        for (int plies = 1; plies <= limits.maxPly && result.status != MATE; plies += 2)
+        {
+            result.status = prove(position, plies, true);
+            if (result.status == UNKNOWN)
+            {
+                break;
+            }
+            if (result.status == MATE)
+            {
+                result.mateIn = (plies + 1) / 2;
+                result.pv = principalVariation(position, plies);
+                result.move = result.pv.empty() ? Board::Move{-1, -1} : result.pv[0];
+            }
+        }
+        result.nodes = nodes;
+        return result;
+    }
+    std::vector<Board::Move> Solver::matingMoves(const Board& board, const Limits& limits, bool* complete)
+    {
+        if (limits.maxPly < 1 || limits.maxPly > 255)
+        {
+            throw std::invalid_argument("Mate search needs between 1 and 255 plies");
+        }
+        nodes = 0;
+        nodeLimit = limits.nodes;
+        stopped = false;
+
+        std::vector<Board::Move> mating;
+        bool resolved = true;
+        Board position = board;
+        for (const Board::Move& move : position.generateMoves())
+        {
+            Board::UndoInfo undo = position.makeMove(move);
+            Status status = prove(position, limits.maxPly - 1, false);
+            position.unmakeMove(move, undo);
+            if (status == MATE)
+            {
+                mating.push_back(move);
+            }
+            resolved = resolved && status != UNKNOWN;
+        }
+        if (complete)
+        {
+            *complete = resolved;
+        }
+        return mating;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "board/board.hpp"
+
+/**
+ * @brief Forced mate solver using depth-first proof-number search (df-pn).
+ *
+ * The side to move at the root is the attacker. A position is proven when
+ * the attacker can force mate within the ply limit and disproven when the
+ * defender can avoid it. Proof-number search always expands the line that is
+ * cheapest to settle: a single mating reply is enough at attacker nodes and
+ * a single escape is enough at defender nodes. It therefore proves mates far
+ * faster than a full-width alpha-beta search.
+ *
+ * Proof and disproof numbers live in a dedicated hash table. Entries are
+ * keyed by position and remaining plies, so transpositions are shared and
+ * there are no cycles to handle.
+ */
+namespace Mate {
+    enum Status {
+        MATE,    // forced mate within the limit
+        NO_MATE, // the defender escapes every line within the limit
+        UNKNOWN  // the node limit was hit first
+    };
+    /**
+     * @brief Search limits. `maxPly` counts the plies of the mating line, so
+     * mate in N needs 2N - 1; `nodes` of 0 means no node limit.
+     */
+    struct Limits {
+        int maxPly = 15;
+        uint64_t nodes = 0;
+    };
+    struct Result {
+        Status status = UNKNOWN;
+        Board::Move move = {-1, -1};
+        int mateIn = 0; // moves by the attacker, including the mating move
+        // one mating line; may stop early if table entries were overwritten
+        std::vector<Board::Move> pv;
+        uint64_t nodes = 0;
+    };
+
+    class Solver {
+        struct Entry {
+            uint64_t key; // position hash mixed with the remaining plies
+            uint32_t phi; // proof number for the side to move
+            uint32_t delta; // disproof number for the side to move
+            uint32_t work; // nodes spent below the entry, for replacement
+        };
+        static constexpr int BUCKET_SIZE = 4;
+        std::vector<Entry> table;
+        uint64_t bucketMask;
+        uint64_t nodes = 0;
+        uint64_t nodeLimit = 0;
+        bool stopped = false;
+
+        static uint64_t entryKey(uint64_t hash, int remaining);
+        bool lookup(uint64_t key, uint32_t& phi, uint32_t& delta) const;
+        void store(uint64_t key, uint32_t phi, uint32_t delta, uint64_t work);
+        // multiple iterative deepening: expands `board` until its numbers reach the thresholds
+        void search(Board& board, int remaining, bool attacker, uint32_t thresholdPhi, uint32_t thresholdDelta);
+        // runs df-pn from `board` until it is proven, disproven or out of nodes
+        Status prove(Board& board, int remaining, bool attacker);
+        std::vector<Board::Move> principalVariation(Board board, int remaining);
+
+        public:
+        /**
+         * @brief Allocates a table of about `tableBytes`.
+         */
+        explicit Solver(size_t tableBytes = size_t(16) << 20);
+        /**
+         * @brief Looks for the shortest forced mate for the side to move.
+         *
+         * Tries mate in 1, 2, ... up to the ply limit, so the first mate found is
+         * the shortest. The table is kept between calls; see clear().
+         */
+        Result solve(const Board& board, const Limits& limits);
+        /**
+         * @brief Returns every root move that forces mate within `limits.maxPly`.
+         *
+         * Meant for checking that a puzzle has a unique solution.
+         * @param complete Set to false if the node limit left some move unresolved.
+         */
+        std::vector<Board::Move> matingMoves(const Board& board, const Limits& limits, bool* complete = nullptr);
+        /**
+         * @brief Empties the table.
+         */
+        void clear();
+    };
+}
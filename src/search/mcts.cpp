@@ -0,0 +1,376 @@
+#include "mcts.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include "eval/evaluation.hpp"
+
+namespace {
+    // values are summed as fixed point so the sums can be plain atomic integers
+    constexpr double VALUE_SCALE = 65536.0;
+    // longest line a playout follows; deeper leaves are scored as draws
+    constexpr int MAX_PATH = 512;
+
+    bool sameMove(const Board::Move& a, const Board::Move& b)
+    {
+        return a.from == b.from && a.to == b.to && a.promotion == b.promotion;
+    }
+}
+
+namespace Mcts {
+    float heuristicEvaluator(const Board& board, const Board::MoveList& moves, float* priors)
+    {
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            const Board::Move& move = moves[i];
+            float logit = 0;
+            if (move.promotion != Board::EMPTY)
+            {
+                logit += move.promotion == Board::WHITE_QUEEN || move.promotion == Board::BLACK_QUEEN ? 2.0f : -1.0f;
+            }
+            if (board.getPieceAtSquare(move.to) != Board::EMPTY)
+            {
+                logit += board.see(move) ? 1.5f : -0.5f;
+            }
+            priors[i] = std::exp(logit);
+        }
+        int score = Evaluation::evaluate(board);
+        return static_cast<float>(std::tanh((board.getTurn() ? score : -score) / 400.0));
+    }
+
+    Tree::Tree(const Config& config)
+        : config(config), current(0), rootBoard(), root(nullptr), outOfMemory(false)
+    {
+        arenas[0] = std::make_unique<Arena>(config.memoryBytes / 2);
+        arenas[1] = std::make_unique<Arena>(config.memoryBytes / 2);
+        root = newNode();
+    }
+    void Tree::setPosition(const Board& board, const GameHistory& played)
+    {
+        arenas[current]->reset();
+        rootBoard = board;
+        rootHistory = played;
+        root = newNode();
+    }
+    Tree::Node* Tree::newNode()
+    {
+        return arenas[current]->create<Node>();
+    }
+    float Tree::meanValue(const Node* node)
+    {
+        uint32_t visits = node->visits.load(std::memory_order_relaxed);
+        return visits ? static_cast<float>(node->valueSum.load(std::memory_order_relaxed) / VALUE_SCALE / visits) : 0.0f;
+    }
+    Tree::Edge* Tree::select(Node* node)
+    {
+        uint32_t parentVisits = node->visits.load(std::memory_order_relaxed)
+                              + node->virtualLoss.load(std::memory_order_relaxed);
+        float explore = config.cpuct * std::sqrt(static_cast<float>(std::max<uint32_t>(parentVisits, 1)));
+        // the node's own value is stored for the side that moved into it
+        float firstPlayValue = -meanValue(node) - config.fpuReduction;
+
+        Edge* best = nullptr;
+        float bestScore = -1e9f;
+        for (int i = 0; i < node->edgeCount; ++i)
+        {
+            Edge& edge = node->edges[i];
+            const Node* child = edge.child.load(std::memory_order_acquire);
+            float q = firstPlayValue;
+            uint32_t total = 0;
+            if (child)
+            {
+                uint32_t visits = child->visits.load(std::memory_order_relaxed);
+                int32_t virtualLoss = child->virtualLoss.load(std::memory_order_relaxed);
+                total = visits + virtualLoss;
+                if (total > 0)
+                {
+                    // every in-flight playout counts as a loss until it reports back
+                    double sum = child->valueSum.load(std::memory_order_relaxed) / VALUE_SCALE - virtualLoss;
+                    q = static_cast<float>(sum / total);
+                }
+            }
+            float score = q + explore * edge.prior / (1 + total);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = &edge;
+            }
+        }
+        return best;
+    }
+    float Tree::expand(Node* node, const Board& board, const GameHistory& history)
+    {
+        Board::MoveList moves = board.generateMoves();
+        // the root is searched even if it repeats, there has to be a move to play
+        bool drawn = node != root && (history.isRepetition(board) || board.isFiftyMoveRule());
+        if (moves.size() == 0 || drawn)
+        {
+            node->terminal = true;
+            node->terminalValue = moves.size() == 0 && board.inCheck() ? -1.0f : 0.0f;
+            node->state.store(Node::EXPANDED, std::memory_order_release);
+            return node->terminalValue;
+        }
+
+        float priors[256];
+        float value = config.evaluator(board, moves, priors);
+        Edge* edges = arenas[current]->create<Edge>(moves.size());
+        if (!edges)
+        {
+            node->state.store(Node::UNEXPANDED, std::memory_order_release);
+            outOfMemory = true;
+            return 0;
+        }
+        float sum = 0;
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            priors[i] = std::max(priors[i], 0.0f);
+            sum += priors[i];
+        }
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            edges[i].move = moves[i];
+            edges[i].prior = sum > 0 ? priors[i] / sum : 1.0f / moves.size();
+        }
+        node->edges = edges;
+        node->edgeCount = static_cast<uint16_t>(moves.size());
+        node->state.store(Node::EXPANDED, std::memory_order_release);
+        return std::clamp(value, -1.0f, 1.0f);
+    }
+    bool Tree::playout(GameHistory& history)
+    {
+        Node* path[MAX_PATH];
+        int length = 0;
+        Board board = rootBoard;
+        Node* node = root;
+        float value = 0; // for the side to move at the last node on the path
+        bool completed = true;
+        while (true)
+        {
+            path[length++] = node;
+            node->virtualLoss.fetch_add(config.virtualLoss, std::memory_order_relaxed);
+
+            uint8_t state = node->state.load(std::memory_order_acquire);
+            if (state == Node::EXPANDED)
+            {
+                if (node->terminal)
+                {
+                    value = node->terminalValue;
+                    break;
+                }
+                if (length == MAX_PATH)
+                {
+                    value = 0;
+                    break;
+                }
+                Edge* edge = select(node);
+                Node* child = edge->child.load(std::memory_order_acquire);
+                if (!child)
+                {
+                    Node* created = newNode();
+                    if (!created)
+                    {
+                        outOfMemory = true;
+                        completed = false;
+                        break;
+                    }
+                    // another thread may have created it first; its node wins and ours is wasted
+                    child = edge->child.compare_exchange_strong(child, created, std::memory_order_acq_rel) ? created : child;
+                }
+                history.push(board);
+                board.makeMove(edge->move);
+                node = child;
+                continue;
+            }
+            if (state == Node::UNEXPANDED
+                && node->state.compare_exchange_strong(state, Node::EXPANDING, std::memory_order_acquire))
+            {
+                value = expand(node, board, history);
+                completed = node->state.load(std::memory_order_relaxed) == Node::EXPANDED;
+                break;
+            }
+            // another thread is expanding this node
+            completed = false;
+            break;
+        }
+
+        // every node after the first pushed one position; a path longer than the
+        // ring overwrote positions before the root, which only a fresh copy restores
+        if (rootHistory.size() + length - 1 > GameHistory::CAPACITY)
+        {
+            history = rootHistory;
+        }
+        else
+        {
+            for (int i = 1; i < length; ++i)
+            {
+                history.pop();
+            }
+        }
+        for (int i = length - 1; i >= 0; --i)
+        {
+            path[i]->virtualLoss.fetch_sub(config.virtualLoss, std::memory_order_relaxed);
+            if (completed)
+            {
+                value = -value;
+                path[i]->valueSum.fetch_add(std::llround(value * VALUE_SCALE), std::memory_order_relaxed);
+                path[i]->visits.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return completed;
+    }
+    Result Tree::search(uint64_t playouts)
+    {
+        outOfMemory = false;
+        std::atomic<uint64_t> claimed(0);
+        int threadCount = std::max(config.threads, 1);
+        std::vector<std::exception_ptr> errors(threadCount);
+        std::atomic<bool> failed(false);
+        auto worker = [&](int thread) {
+            try
+            {
+                GameHistory history = rootHistory;
+                while (!outOfMemory && !failed && claimed.fetch_add(1, std::memory_order_relaxed) < playouts)
+                {
+                    // a collision with another thread's expansion is retried
+                    while (!playout(history) && !outOfMemory && !failed)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            catch (...)
+            {
+                errors[thread] = std::current_exception();
+                failed = true;
+            }
+        };
+        uint32_t before = rootVisits();
+        std::vector<std::thread> threads;
+        for (int thread = 1; thread < threadCount; ++thread)
+        {
+            threads.emplace_back(worker, thread);
+        }
+        worker(0);
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        Result result;
+        result.playouts = rootVisits() - before;
+        result.outOfMemory = outOfMemory;
+        if (root->terminal)
+        {
+            result.value = root->terminalValue;
+        }
+        for (const MoveStats& stats : rootMoves())
+        {
+            if (result.move.from < 0 || stats.visits > result.visits)
+            {
+                result.move = stats.move;
+                result.visits = stats.visits;
+                result.value = stats.value;
+            }
+        }
+        return result;
+    }
+    uint32_t Tree::rootVisits() const
+    {
+        return root->visits.load(std::memory_order_relaxed);
+    }
+    std::vector<MoveStats> Tree::rootMoves() const
+    {
+        std::vector<MoveStats> stats;
+        if (root->state.load(std::memory_order_acquire) != Node::EXPANDED)
+        {
+            return stats;
+        }
+        for (int i = 0; i < root->edgeCount; ++i)
+        {
+            const Edge& edge = root->edges[i];
+            const Node* child = edge.child.load(std::memory_order_acquire);
+            stats.push_back({edge.move, edge.prior, child ? child->visits.load() : 0, child ? meanValue(child) : 0.0f});
+        }
+        return stats;
+    }
+    Tree::Node* Tree::copySubtree(const Node* node, Arena& arena)
+    {
+        Node* copy = arena.create<Node>();
+        if (!copy)
+        {
+            return nullptr;
+        }
+        copy->visits.store(node->visits.load());
+        copy->valueSum.store(node->valueSum.load());
+        copy->terminal = node->terminal;
+        copy->terminalValue = node->terminalValue;
+        if (node->state.load() != Node::EXPANDED)
+        {
+            return copy;
+        }
+        copy->edges = arena.create<Edge>(node->edgeCount);
+        if (!copy->edges)
+        {
+            return nullptr;
+        }
+        for (int i = 0; i < node->edgeCount; ++i)
+        {
+            copy->edges[i].move = node->edges[i].move;
+            copy->edges[i].prior = node->edges[i].prior;
+            const Node* child = node->edges[i].child.load();
+            if (child)
+            {
+                Node* childCopy = copySubtree(child, arena);
+                if (!childCopy)
+                {
+                    return nullptr;
+                }
+                copy->edges[i].child.store(childCopy);
+            }
+        }
+        copy->edgeCount = node->edgeCount;
+        copy->state.store(Node::EXPANDED);
+        return copy;
+    }
+    bool Tree::advance(Board::Move move)
+    {
+        const Node* kept = nullptr;
+        if (root->state.load() == Node::EXPANDED)
+        {
+            for (int i = 0; i < root->edgeCount; ++i)
+            {
+                if (sameMove(root->edges[i].move, move))
+                {
+                    kept = root->edges[i].child.load();
+                }
+            }
+        }
+        rootHistory.play(rootBoard, move);
+
+        // a child scored as a repetition draw has to be searched again as the root
+        Node* copied = nullptr;
+        Arena& spare = *arenas[1 - current];
+        spare.reset();
+        if (kept && kept->state.load() == Node::EXPANDED && !kept->terminal)
+        {
+            copied = copySubtree(kept, spare);
+        }
+        arenas[current]->reset();
+        current = 1 - current;
+        if (!copied)
+        {
+            arenas[current]->reset();
+            root = newNode();
+            return false;
+        }
+        root = copied;
+        return true;
+    }
+}
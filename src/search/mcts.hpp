@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "board/board.hpp"
+#include "board/game_history.hpp"
+#include "util/arena.hpp"
+
+/**
+ * @brief Monte Carlo tree search with PUCT selection.
+ *
+ * Every playout walks from the root picking the child with the highest
+ * Q + U, where U = cpuct * prior * sqrt(parent visits) / (1 + child visits),
+ * expands the leaf with an Evaluator and backs its value up the path.
+ *
+ * Nodes and their edge arrays live in an Arena, so expanding a node never
+ * touches the heap and a whole tree is released in O(1). Several threads
+ * search one tree at a time. Visit counts and value sums are atomics, and a
+ * thread adds a virtual loss to every node on its path until its playout
+ * finishes, which steers the other threads towards different lines.
+ */
+namespace Mcts {
+    /**
+     * @brief Scores a position for the side to move and fills in move priors.
+     *
+     * Returns a value in [-1, 1] and writes one prior per move in `moves` to
+     * `priors`; priors are normalised by the search. Called concurrently from
+     * every search thread, so it must be thread-safe.
+     */
+    using Evaluator = std::function<float(const Board& board, const Board::MoveList& moves, float* priors)>;
+    /**
+     * @brief Default evaluator: the static evaluation squashed into [-1, 1] and
+     * priors that favour promotions and captures that win material by SEE.
+     */
+    float heuristicEvaluator(const Board& board, const Board::MoveList& moves, float* priors);
+
+    struct Config {
+        float cpuct = 1.5f;
+        // phantom losses added per in-flight playout through a node
+        int virtualLoss = 3;
+        // value assumed for unvisited children, below the parent's own value
+        float fpuReduction = 0.2f;
+        // memory for the tree; half is kept free to compact reused subtrees into
+        size_t memoryBytes = size_t(64) << 20;
+        int threads = 1;
+        Evaluator evaluator = heuristicEvaluator;
+    };
+    struct Result {
+        Board::Move move = {-1, -1};
+        float value = 0;          // expected result for the side to move, in [-1, 1]
+        uint32_t visits = 0;      // visits of the chosen move
+        uint64_t playouts = 0;    // playouts completed by this call
+        bool outOfMemory = false; // stopped early because the arena filled up
+    };
+    /**
+     * @brief Visit statistics of one root move.
+     */
+    struct MoveStats {
+        Board::Move move;
+        float prior;
+        uint32_t visits;
+        float value; // for the side to move at the root
+    };
+
+    class Tree {
+        struct Node;
+        struct Edge {
+            Board::Move move;
+            float prior;
+            std::atomic<Node*> child;
+        };
+        struct Node {
+            enum State : uint8_t { UNEXPANDED, EXPANDING, EXPANDED };
+            std::atomic<uint32_t> visits;
+            std::atomic<int32_t> virtualLoss;
+            // sum of values from the point of view of the side that moved into this node
+            std::atomic<int64_t> valueSum;
+            std::atomic<uint8_t> state;
+            bool terminal;
+            float terminalValue; // for the side to move, when terminal
+            uint16_t edgeCount;
+            Edge* edges;
+        };
+
+        Config config;
+        // the tree lives in `arenas[current]`; the other one receives the subtree kept by advance()
+        std::unique_ptr<Arena> arenas[2];
+        int current;
+        Board rootBoard;
+        GameHistory rootHistory; // positions before the root
+        Node* root;
+        std::atomic<bool> outOfMemory;
+
+        Node* newNode();
+        // one playout from the thread's copy of `rootHistory`, which it leaves as
+        // it found it; false if it collided with another thread's expansion or
+        // ran out of memory
+        bool playout(GameHistory& history);
+        // fills in `node` for `board`, returning the value for the side to move
+        float expand(Node* node, const Board& board, const GameHistory& history);
+        Edge* select(Node* node);
+        Node* copySubtree(const Node* node, Arena& arena);
+        static float meanValue(const Node* node);
+
+        public:
+        /**
+         * @brief Creates an empty tree for the start position.
+         */
+        explicit Tree(const Config& config = Config());
+        /**
+         * @brief Discards the tree, in O(1), and starts over from `board`.
+         * @param played The positions before `board`, so that repeating one
+         * of them is scored as a draw.
+         */
+        void setPosition(const Board& board, const GameHistory& played = GameHistory());
+        /**
+         * @brief Plays `move` at the root, keeping the subtree below it.
+         *
+         * The kept subtree is copied compactly into the spare arena and the old
+         * arena is reset, so the rest of the tree costs nothing to drop.
+         * @return bool True if a searched subtree was reused.
+         */
+        bool advance(Board::Move move);
+        /**
+         * @brief Runs `playouts` more playouts on `config.threads` threads and
+         * returns the most visited root move.
+         *
+         * If the root has no legal moves the result's move has from == -1.
+         */
+        Result search(uint64_t playouts);
+
+        const Board& position() const { return rootBoard; }
+        uint32_t rootVisits() const;
+        std::vector<MoveStats> rootMoves() const;
+        size_t memoryUsed() const { return arenas[current]->used(); }
+    };
+}
@@ -0,0 +1,211 @@
+#include "search.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "eval/evaluation.hpp"
+
+namespace {
+    constexpr int ORDER_VALUES[6] = {1, 3, 3, 5, 9, 0};
+
+    // higher sorts first: the hinted move, then captures by victim and attacker
+    int orderScore(const Board& board, const Board::Move& move, const Board::Move& hint)
+    {
+        if (move.from == hint.from && move.to == hint.to && move.promotion == hint.promotion)
+        {
+            return 1000;
+        }
+        Board::Piece victim = board.getPieceAtSquare(move.to);
+        int score = move.promotion != Board::EMPTY ? ORDER_VALUES[move.promotion % 6] * 10 : 0;
+        if (victim != Board::EMPTY)
+        {
+            score += 100 + ORDER_VALUES[victim % 6] * 10 - ORDER_VALUES[board.getPieceAtSquare(move.from) % 6];
+        }
+        return score;
+    }
+    // sorts `moves` into `ordered`, best candidates first
+    int orderMoves(const Board& board, const Board::MoveList& moves, const Board::Move& hint, Board::Move* ordered,
+                   bool capturesOnly)
+    {
+        int scores[256];
+        int count = 0;
+        uint64_t enemy = 0;
+        for (int piece = board.getTurn() ? Board::BLACK_PAWN : Board::WHITE_PAWN, last = piece + 6; piece < last; ++piece)
+        {
+            enemy |= board.getBitmaskForPiece(static_cast<Board::Piece>(piece));
+        }
+        for (const Board::Move& move : moves)
+        {
+            if (capturesOnly && !(enemy & (1ULL << move.to)) && move.promotion == Board::EMPTY)
+            {
+                continue;
+            }
+            int score = orderScore(board, move, hint);
+            // insertion sort, move lists are short
+            int i = count++;
+            while (i > 0 && scores[i - 1] < score)
+            {
+                scores[i] = scores[i - 1];
+                ordered[i] = ordered[i - 1];
+                --i;
+            }
+            scores[i] = score;
+            ordered[i] = move;
+        }
+        return count;
+    }
+    int staticScore(const Board& board)
+    {
+        int score = Evaluation::evaluate(board);
+        return board.getTurn() ? score : -score;
+    }
+}
+
+namespace Search {
+    bool Searcher::outOfNodes()
+    {
+        if (nodeLimit && nodes >= nodeLimit)
+        {
+            stopped = true;
+        }
+        return stopped;
+    }
+    int Searcher::quiescence(Board& board, int alpha, int beta)
+    {
+        ++nodes;
+        int standPat = staticScore(board);
+        if (standPat >= beta)
+        {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+
+        Board::MoveList moves = board.generateMoves();
+        Board::Move ordered[256];
+        int count = orderMoves(board, moves, {-1, -1}, ordered, true);
+        for (int i = 0; i < count && !outOfNodes(); ++i)
+        {
+            // losing captures cannot raise alpha above the stand-pat score
+            if (ordered[i].promotion == Board::EMPTY && !board.see(ordered[i]))
+            {
+                continue;
+            }
+            Board::UndoInfo undo = board.makeMove(ordered[i]);
+            int score = -quiescence(board, -beta, -alpha);
+            board.unmakeMove(ordered[i], undo);
+            if (score >= beta)
+            {
+                return score;
+            }
+            alpha = std::max(alpha, score);
+        }
+        return alpha;
+    }
+    int Searcher::negamax(Board& board, int depth, int ply, int alpha, int beta, Board::Move* best)
+    {
+        Board::MoveList moves = board.generateMoves();
+        if (moves.size() == 0)
+        {
+            return board.inCheck() ? -(MATE_SCORE - ply) : 0;
+        }
+        // a single repetition is scored as a draw, as repeating again is always possible
+        if (ply > 0 && (history.isRepetition(board) || board.isFiftyMoveRule()))
+        {
+            return 0;
+        }
+        if (depth == 0)
+        {
+            return quiescence(board, alpha, beta);
+        }
+        ++nodes;
+
+        Board::Move ordered[256];
+        int count = orderMoves(board, moves, best ? *best : Board::Move{-1, -1}, ordered, false);
+        int bestScore = -INFINITE_SCORE;
+        for (int i = 0; i < count; ++i)
+        {
+            history.push(board);
+            Board::UndoInfo undo = board.makeMove(ordered[i]);
+            int score = -negamax(board, depth - 1, ply + 1, -beta, -alpha, nullptr);
+            board.unmakeMove(ordered[i], undo);
+            history.pop();
+            if (outOfNodes())
+            {
+                return bestScore;
+            }
+            if (score > bestScore)
+            {
+                bestScore = score;
+                if (best)
+                {
+                    *best = ordered[i];
+                }
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta)
+            {
+                break;
+            }
+        }
+        return bestScore;
+    }
+    Result Searcher::search(const Board& board, const Limits& limits, const GameHistory& played)
+    {
+        if (limits.depth <= 0 && limits.nodes == 0)
+        {
+            throw std::invalid_argument("Search needs a depth or node limit");
+        }
+        nodes = 0;
+        nodeLimit = limits.nodes;
+        stopped = false;
+        history = played;
+
+        Result result;
+        Board position = board;
+        if (!position.hasLegalMoves())
+        {
+            result.score = position.inCheck() ? -MATE_SCORE : 0;
+            return result;
+        }
+        CachedResult cached;
+        if (cache && limits.depth > 0 && cache->probe(position.getHash(), cached) && cached.bound == EXACT
+            && cached.depth >= limits.depth
+            && position.validateMove(cached.move) == Board::MOVE_OK)
+        {
+            // the move is checked as another process may have written a colliding key
+            result.move = cached.move;
+            result.score = cached.score;
+            result.depth = cached.depth;
+            return result;
+        }
+        int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_DEPTH) : MAX_DEPTH;
+        Board::Move best = {-1, -1};
+        for (int depth = 1; depth <= maxDepth; ++depth)
+        {
+            Board::Move iterationBest = best;
+            int score = negamax(position, depth, 0, -INFINITE_SCORE, INFINITE_SCORE, &iterationBest);
+            if (stopped)
+            {
+                // an unfinished iteration is only used when there is nothing better
+                if (result.move.from < 0)
+                {
+                    result.move = iterationBest.from >= 0 ? iterationBest : position.generateMoves()[0];
+                    result.score = score > -INFINITE_SCORE ? score : staticScore(position);
+                }
+                break;
+            }
+            best = iterationBest;
+            result.move = iterationBest;
+            result.score = score;
+            result.depth = depth;
+            if (score >= MATE_SCORE - MAX_DEPTH)
+            {
+                break;
+            }
+        }
+        result.nodes = nodes;
+        if (cache && result.depth > 0)
+        {
+            cache->store(position.getHash(), {result.depth, result.score, result.move, EXACT});
+        }
+        return result;
+    }
+}
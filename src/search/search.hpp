@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include "board/board.hpp"
+#include "board/game_history.hpp"
+#include "analysis_cache.hpp"
+
+/**
+ * @brief Alpha-beta search used to pick moves for self-play and analysis.
+ *
+ * Iterative deepening negamax with a capture-only quiescence search at the
+ * leaves and Evaluation::evaluate() as the static score. Moves are ordered
+ * with the previous iteration's best move first, then captures by most
+ * valuable victim. There is no transposition table, so a Searcher holds no
+ * memory beyond its counters and is cheap to keep one per thread. Root
+ * results can be shared across runs and processes through an AnalysisCache.
+ */
+namespace Search {
+    // mate scores are MATE_SCORE minus the plies to mate
+    constexpr int MATE_SCORE = 30000;
+    constexpr int INFINITE_SCORE = 32000;
+    constexpr int MAX_DEPTH = 64;
+
+    /**
+     * @brief When to stop. A search ends at `depth` plies or once `nodes` nodes
+     * have been visited, whichever is set and comes first; 0 means no limit.
+     */
+    struct Limits {
+        int depth = 0;
+        uint64_t nodes = 0;
+    };
+    struct Result {
+        Board::Move move = {-1, -1};
+        int score = 0; // centipawns for the side to move
+        int depth = 0; // deepest fully searched iteration
+        uint64_t nodes = 0;
+    };
+
+    class Searcher {
+        uint64_t nodes = 0;
+        uint64_t nodeLimit = 0;
+        bool stopped = false;
+        AnalysisCache* cache = nullptr;
+        GameHistory history; // the game so far, then the moves on the current search path
+
+        int negamax(Board& board, int depth, int ply, int alpha, int beta, Board::Move* best);
+        int quiescence(Board& board, int alpha, int beta);
+        bool outOfNodes();
+
+        public:
+        /**
+         * @brief Searches `board` and returns the best move found.
+         *
+         * If the side to move has no legal moves the result's move has
+         * from == -1 and the score is the mate or stalemate score.
+         * @param played The positions before `board`, so that repeating one
+         * of them is scored as a draw.
+         * @throws std::invalid_argument If neither limit is set.
+         */
+        Result search(const Board& board, const Limits& limits, const GameHistory& played = GameHistory());
+        /**
+         * @brief Answers depth-limited searches from `cache` when it already holds
+         * the position at least that deep, and stores every finished search in
+         * it. The cache must outlive the searcher; nullptr detaches it.
+         */
+        void setCache(AnalysisCache* analysisCache) { cache = analysisCache; }
+    };
+}
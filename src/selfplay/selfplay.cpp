@@ -0,0 +1,270 @@
+#include "selfplay.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <fstream>
+#include <mutex>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /**
+     * Output file shared by the workers. append() claims a byte range with a
+     * single atomic add and then writes into it with pwrite, so concurrent
+     * flushes never overlap and never block each other.
+     */
+    class RecordFile {
+        std::atomic<uint64_t> end;
+#ifdef _WIN32
+        // no positional writes through the C++ streams, so Windows takes a lock
+        std::ofstream out;
+        std::mutex mutex;
+#else
+        int descriptor;
+#endif
+
+        public:
+        explicit RecordFile(const std::string& path) : end(0)
+        {
+#ifdef _WIN32
+            out.open(path, std::ios::binary | std::ios::app);
+            out.seekp(0, std::ios::end);
+            end = static_cast<uint64_t>(out.tellp());
+            if (!out)
+#else
+            descriptor = open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+            if (descriptor >= 0)
+            {
+                end = static_cast<uint64_t>(lseek(descriptor, 0, SEEK_END));
+            }
+            if (descriptor < 0)
+#endif
+            {
+                throw std::runtime_error("Cannot open " + path);
+            }
+        }
+        ~RecordFile()
+        {
+#ifndef _WIN32
+            close(descriptor);
+#endif
+        }
+        void append(const std::vector<SelfPlay::Record>& records)
+        {
+            size_t bytes = records.size() * sizeof(SelfPlay::Record);
+            if (bytes == 0)
+            {
+                return;
+            }
+#ifdef _WIN32
+            std::lock_guard<std::mutex> lock(mutex);
+            out.write(reinterpret_cast<const char*>(records.data()), bytes);
+            if (!out)
+            {
+                throw std::runtime_error("Cannot write self-play records");
+            }
+#else
+            uint64_t offset = end.fetch_add(bytes);
+            const char* data = reinterpret_cast<const char*>(records.data());
+            while (bytes > 0)
+            {
+                ssize_t written = pwrite(descriptor, data, bytes, static_cast<off_t>(offset));
+                if (written <= 0)
+                {
+                    throw std::runtime_error("Cannot write self-play records");
+                }
+                data += written;
+                offset += written;
+                bytes -= written;
+            }
+#endif
+        }
+    };
+
+    bool onlyKings(const Board& board)
+    {
+        return board.getBitmaskForBoard() == (board.getBitmaskForPiece(Board::WHITE_KING) | board.getBitmaskForPiece(Board::BLACK_KING));
+    }
+}
+
+namespace SelfPlay {
+    Record Record::pack(const Board& board)
+    {
+        Record record{};
+        record.occupancy = board.getBitmaskForBoard();
+        int index = 0;
+        for (uint64_t occupied = record.occupancy; occupied && index < 32; occupied &= occupied - 1, ++index)
+        {
+            int piece = board.getPieceAtSquare(__builtin_ctzll(occupied));
+            record.pieces[index / 2] |= static_cast<uint8_t>(piece << (4 * (index % 2)));
+        }
+        record.flags = static_cast<uint8_t>((board.getTurn() ? 1 : 0) | (board.getCastlingRights() << 1));
+        record.enPassant = board.getEnPassantSquare() < 0 ? 255 : static_cast<uint8_t>(board.getEnPassantSquare());
+        return record;
+    }
+    Board Record::unpack() const
+    {
+        // castling and en passant have no setters, so the empty board comes from FEN
+        std::string castling;
+        const char letters[4] = {'K', 'Q', 'k', 'q'};
+        for (int right = 0; right < 4; ++right)
+        {
+            if ((flags >> 1) & (0b1000 >> right))
+            {
+                castling += letters[right];
+            }
+        }
+        std::string enPassantSquare = "-";
+        if (enPassant != 255)
+        {
+            enPassantSquare = {static_cast<char>('a' + enPassant % 8), static_cast<char>('1' + enPassant / 8)};
+        }
+        Board board(std::string("8/8/8/8/8/8/8/8") + ((flags & 1) ? " w " : " b ") + (castling.empty() ? "-" : castling) + " "
+                    + enPassantSquare);
+        int index = 0;
+        for (uint64_t occupied = occupancy; occupied && index < 32; occupied &= occupied - 1, ++index)
+        {
+            int piece = (pieces[index / 2] >> (4 * (index % 2))) & 0xf;
+            board.placePiece(static_cast<Board::Piece>(piece), __builtin_ctzll(occupied));
+        }
+        return board;
+    }
+    Board::Move Record::unpackMove() const
+    {
+        Board::Move decoded = {(move >> 6) & 63, move & 63};
+        int promotion = (move >> 12) & 7;
+        if (promotion)
+        {
+            decoded.promotion = static_cast<Board::Piece>(promotion + ((flags & 1) ? 0 : 6));
+        }
+        return decoded;
+    }
+
+    Stats generate(const Config& config, const std::string& path)
+    {
+        if (config.limits.depth <= 0 && config.limits.nodes == 0)
+        {
+            throw std::invalid_argument("Self-play needs a depth or node limit");
+        }
+        std::vector<Board> openings;
+        for (const std::string& fen : config.openings)
+        {
+            openings.emplace_back(fen);
+        }
+        if (openings.empty())
+        {
+            openings.emplace_back();
+        }
+
+        RecordFile file(path);
+        std::atomic<int> nextGame(0);
+        std::atomic<bool> failed(false);
+        int threads = std::max(1, std::min(config.threads, config.games));
+        std::vector<Stats> stats(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+
+        for (int thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread]() {
+                try
+                {
+                    Search::Searcher searcher;
+                    GameHistory history;
+                    std::vector<Record> buffer;
+                    buffer.reserve(config.bufferRecords + config.maxPlies);
+                    std::vector<Record> game;
+                    Stats& local = stats[thread];
+
+                    for (int index = nextGame++; index < config.games && !failed; index = nextGame++)
+                    {
+                        std::mt19937_64 random(config.seed * 0x9e3779b97f4a7c15ULL + index);
+                        Board board = openings[index % openings.size()];
+                        history.clear();
+                        for (int ply = 0; ply < config.randomPlies; ++ply)
+                        {
+                            Board::MoveList moves = board.generateMoves();
+                            if (moves.size() == 0)
+                            {
+                                break;
+                            }
+                            history.play(board, moves[random() % moves.size()]);
+                        }
+
+                        // +1 white won, -1 black won, 0 drawn
+                        int whiteResult = 0;
+                        game.clear();
+                        for (int ply = 0; ply < config.maxPlies; ++ply)
+                        {
+                            if (!board.hasLegalMoves())
+                            {
+                                whiteResult = board.inCheck() ? (board.getTurn() ? -1 : 1) : 0;
+                                break;
+                            }
+                            if (onlyKings(board) || history.isThreefoldRepetition(board) || board.isFiftyMoveRule())
+                            {
+                                break;
+                            }
+                            Search::Result result = searcher.search(board, config.limits, history);
+                            Record record = Record::pack(board);
+                            int promotion = result.move.promotion == Board::EMPTY ? 0 : result.move.promotion % 6;
+                            record.move = static_cast<uint16_t>(result.move.to | (result.move.from << 6) | (promotion << 12));
+                            record.score = static_cast<int16_t>(std::clamp(result.score, -Search::MATE_SCORE, Search::MATE_SCORE));
+                            game.push_back(record);
+                            history.play(board, result.move);
+                        }
+
+                        for (Record& record : game)
+                        {
+                            record.result = static_cast<int8_t>((record.flags & 1) ? whiteResult : -whiteResult);
+                            buffer.push_back(record);
+                        }
+                        ++local.games;
+                        local.positions += game.size();
+                        (whiteResult > 0 ? local.whiteWins : whiteResult < 0 ? local.blackWins : local.draws)++;
+                        if (buffer.size() >= config.bufferRecords)
+                        {
+                            file.append(buffer);
+                            buffer.clear();
+                        }
+                    }
+                    file.append(buffer);
+                }
+                catch (...)
+                {
+                    errors[thread] = std::current_exception();
+                    failed = true;
+                }
+            });
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        Stats total;
+        for (const Stats& local : stats)
+        {
+            total.games += local.games;
+            total.positions += local.positions;
+            total.whiteWins += local.whiteWins;
+            total.blackWins += local.blackWins;
+            total.draws += local.draws;
+        }
+        return total;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "board/board.hpp"
+#include "search/search.hpp"
+
+/**
+ * @brief Self-play game generation for training data.
+ *
+ * Games are spread over worker threads. Each position a search was run on is
+ * written as a fixed 32-byte Record. Every thread collects records in its own
+ * buffer and flushes it by atomically reserving a region at the end of the
+ * output file and writing there, so threads never wait on each other or on a
+ * shared lock.
+ */
+namespace SelfPlay {
+    /**
+     * @brief One training position, stored in native byte order.
+     *
+     * Pieces are stored as one nibble (the Board::Piece value) per occupied
+     * square, in ascending square order, which fits the 32 pieces of any legal
+     * position in 16 bytes.
+     */
+    struct Record {
+        uint64_t occupancy;
+        uint8_t pieces[16];
+        uint8_t flags;      // bit 0 white to move, bits 1-4 castling rights
+        uint8_t enPassant;  // square, or 255 for none
+        uint16_t move;      // to | from << 6 | promotion piece type << 12
+        int16_t score;      // centipawns for the side to move
+        int8_t result;      // 1 the side to move won, 0 draw, -1 lost
+        uint8_t reserved;
+
+        /**
+         * @brief Packs a board; move, score and result are left zero.
+         */
+        static Record pack(const Board& board);
+        Board unpack() const;
+        Board::Move unpackMove() const;
+    };
+    static_assert(sizeof(Record) == 32, "self-play records must stay 32 bytes");
+
+    struct Config {
+        // FENs to start from, used round robin; the standard start position if empty
+        std::vector<std::string> openings;
+        int games = 1000;
+        int threads = 1;
+        Search::Limits limits = {4, 0};
+        // random moves played after the opening so games from one opening differ
+        int randomPlies = 8;
+        // games still running after this many plies are scored as draws
+        int maxPlies = 400;
+        uint64_t seed = 1;
+        // records per thread buffer between flushes
+        size_t bufferRecords = 1 << 14;
+    };
+    struct Stats {
+        uint64_t games = 0;
+        uint64_t positions = 0;
+        uint64_t whiteWins = 0;
+        uint64_t blackWins = 0;
+        uint64_t draws = 0;
+    };
+
+    /**
+     * @brief Plays `config.games` games and appends their records to `path`.
+     *
+     * Each game draws its random moves from a generator seeded by the seed and
+     * the game number, so a game plays out the same on any number of threads;
+     * only the order of games in the file varies.
+     * @throws std::runtime_error If the output cannot be written.
+     * @throws std::invalid_argument If an opening FEN or the limits are invalid.
+     */
+    Stats generate(const Config& config, const std::string& path);
+}
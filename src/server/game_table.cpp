@@ -0,0 +1,159 @@
+#include "server.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    void writeSquare(char* out, int square)
+    {
+        out[0] = static_cast<char>('a' + square % 8);
+        out[1] = static_cast<char>('1' + square / 8);
+    }
+    // writes a move in coordinate notation ("e2e4", "e7e8q") and returns its length
+    int writeMove(char* out, const Board::Move& move)
+    {
+        writeSquare(out, move.from);
+        writeSquare(out + 2, move.to);
+        if (move.promotion == Board::EMPTY)
+        {
+            return 4;
+        }
+        out[4] = "pnbrqk"[move.promotion % 6];
+        return 5;
+    }
+    int readSquare(std::string_view text)
+    {
+        if (text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8')
+        {
+            return -1;
+        }
+        return (text[1] - '1') * 8 + (text[0] - 'a');
+    }
+    // the promotion piece takes the colour of the side to move; unknown letters give INVALID_PIECE
+    Board::Piece readPromotion(std::string_view text, bool white)
+    {
+        if (text.size() == 4)
+        {
+            return Board::EMPTY;
+        }
+        Board::Piece piece = Board::pieceForSymbol(text[4]);
+        if (text.size() != 5 || piece == Board::EMPTY)
+        {
+            return Board::INVALID_PIECE;
+        }
+        return static_cast<Board::Piece>(piece % 6 + (white ? Board::WHITE_PAWN : Board::BLACK_PAWN));
+    }
+    template<typename... Args> void setText(Server::Reply& reply, const char* format, Args... args)
+    {
+        int length = std::snprintf(reply.text, Server::REPLY_SIZE, format, args...);
+        reply.length = static_cast<uint16_t>(std::min<int>(std::max(length, 0), Server::REPLY_SIZE - 1));
+    }
+    const char* gameState(const Board& board, const GameHistory& history)
+    {
+        if (!board.hasLegalMoves())
+        {
+            return board.inCheck() ? "checkmate" : "stalemate";
+        }
+        if (history.isThreefoldRepetition(board))
+        {
+            return "threefold";
+        }
+        return board.isFiftyMoveRule() ? "fifty" : "ongoing";
+    }
+}
+
+namespace Server {
+    GameTable::GameTable(size_t capacity)
+        : games(capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("A game table needs at least one slot");
+        }
+    }
+    void GameTable::handle(const Request& request, Reply& reply)
+    {
+        reply.connection = request.connection;
+        reply.connectionGeneration = request.connectionGeneration;
+        reply.gameId = request.gameId;
+        reply.freed = false;
+        Game& game = games[slotFor(request.gameId)];
+        std::string_view argument(request.argument, request.length);
+
+        if (request.command == NEW)
+        {
+            // movegen trusts the position it is given, so anything it could not handle is refused outright
+            Board::FENError error = Board::FEN_OK;
+            if (argument.empty())
+            {
+                game.board = Board();
+            }
+            else
+            {
+                error = Board::tryFromFEN(argument, game.board);
+            }
+            if (error != Board::FEN_OK)
+            {
+                game.active = false;
+                reply.freed = true;
+                setText(reply, "error invalid FEN");
+                return;
+            }
+            game.history.clear();
+            game.id = request.gameId;
+            game.active = true;
+            setText(reply, "%u ok", request.gameId);
+            return;
+        }
+        if (!game.active || game.id != request.gameId)
+        {
+            setText(reply, "%u error unknown game", request.gameId);
+            return;
+        }
+
+        switch (request.command)
+        {
+        case MOVE:
+        {
+            if (argument.size() < 4)
+            {
+                setText(reply, "%u error malformed move", request.gameId);
+                return;
+            }
+            Board::Move move = {readSquare(argument), readSquare(argument.substr(2)),
+                readPromotion(argument, game.board.getTurn())};
+            Board::MoveError error = game.board.validateMove(move);
+            if (error != Board::MOVE_OK)
+            {
+                setText(reply, "%u error %s", request.gameId, Board::describeMoveError(error));
+                return;
+            }
+            game.history.play(game.board, move);
+            setText(reply, "%u ok %s", request.gameId, gameState(game.board, game.history));
+            return;
+        }
+        case MOVES:
+        {
+            setText(reply, "%u ok", request.gameId);
+            for (const Board::Move& move : game.board.generateMoves())
+            {
+                reply.text[reply.length++] = ' ';
+                reply.length += writeMove(reply.text + reply.length, move);
+            }
+            return;
+        }
+        case FEN:
+            setText(reply, "%u ok %s", request.gameId, game.board.generateFEN().c_str());
+            return;
+        case CLOSE:
+            game.active = false;
+            reply.freed = true;
+            setText(reply, "%u ok", request.gameId);
+            return;
+        default:
+            setText(reply, "%u error unknown command", request.gameId);
+            return;
+        }
+    }
+}
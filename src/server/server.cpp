@@ -0,0 +1,566 @@
+#include "server.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "util/socket.hpp"
+#include "util/spsc_queue.hpp"
+
+namespace {
+    constexpr size_t INPUT_SIZE = 4096;
+    // a client that stops reading is dropped rather than buffered forever
+    constexpr size_t OUTPUT_LIMIT = size_t(1) << 20;
+    constexpr int MAX_EVENTS = 64;
+
+    // epoll user data: what kind of descriptor fired, and which one
+    enum Source : uint32_t {
+        LISTENER,
+        REPLIES,
+        STOP,
+        CONNECTION
+    };
+    uint64_t eventData(Source source, uint32_t index) { return (uint64_t(source) << 32) | index; }
+
+    void notify(int fd)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(fd, &one, sizeof(one));
+        (void)written;
+    }
+    void consume(int fd)
+    {
+        uint64_t count;
+        ssize_t read = ::read(fd, &count, sizeof(count));
+        (void)read;
+    }
+    std::string_view nextWord(std::string_view& line)
+    {
+        size_t start = line.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+        {
+            line = {};
+            return {};
+        }
+        line.remove_prefix(start);
+        size_t end = std::min(line.find(' '), line.size());
+        std::string_view word = line.substr(0, end);
+        line.remove_prefix(end);
+        return word;
+    }
+    std::string_view trim(std::string_view text)
+    {
+        size_t start = text.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+        {
+            return {};
+        }
+        return text.substr(start, text.find_last_not_of(' ') - start + 1);
+    }
+}
+
+namespace Server {
+    struct SessionServer::Impl {
+        struct Worker {
+            SpscQueue<Request> requests; // written by the socket loop
+            SpscQueue<Reply> replies;    // read by the socket loop
+            int wakeFd;
+            std::atomic<bool> sleeping{false};
+            std::thread thread;
+
+            explicit Worker(size_t capacity)
+                : requests(capacity), replies(capacity), wakeFd(eventfd(0, EFD_CLOEXEC))
+            {
+                if (wakeFd < 0)
+                {
+                    Socket::fail("eventfd");
+                }
+            }
+            ~Worker() { close(wakeFd); }
+        };
+        struct Connection {
+            int fd = -1;
+            uint32_t generation = 0; // bumped on close so late replies are dropped
+            size_t inputLength = 0;
+            char input[INPUT_SIZE];
+            std::string output;
+            size_t written = 0;
+            bool writeWatched = false;
+            bool dirty = false;
+        };
+
+        Config config;
+        GameTable games;
+        std::vector<std::unique_ptr<Worker>> workers;
+        // game slots are owned by the socket loop, which hands out ids
+        std::vector<uint32_t> freeSlots;
+        std::vector<uint32_t> slotGenerations;
+        uint32_t generationLimit;
+        std::vector<std::unique_ptr<Connection>> connections;
+        std::vector<uint32_t> freeConnections;
+        std::vector<uint32_t> dirtyConnections;
+        std::vector<int> listeners;
+        std::vector<std::string> socketPaths;
+        int epollFd;
+        int repliesFd; // workers signal here when replies are waiting
+        int stopFd;
+        std::atomic<bool> repliesSignalled{false};
+        std::atomic<bool> stopping{false};
+
+        explicit Impl(const Config& config)
+            : config(config), games(config.maxGames), slotGenerations(config.maxGames, 0),
+              generationLimit(static_cast<uint32_t>(UINT32_MAX / config.maxGames))
+        {
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
+            repliesFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epollFd < 0 || repliesFd < 0 || stopFd < 0)
+            {
+                Socket::fail("epoll setup");
+            }
+            watch(repliesFd, EPOLLIN, eventData(REPLIES, 0));
+            watch(stopFd, EPOLLIN, eventData(STOP, 0));
+            for (int i = 0; i < std::max(1, config.workers); ++i)
+            {
+                workers.push_back(std::make_unique<Worker>(config.queueCapacity));
+            }
+            freeSlots.reserve(config.maxGames);
+            for (size_t slot = config.maxGames; slot > 0; --slot)
+            {
+                freeSlots.push_back(static_cast<uint32_t>(slot - 1));
+            }
+        }
+        ~Impl()
+        {
+            for (const std::unique_ptr<Connection>& connection : connections)
+            {
+                if (connection->fd >= 0)
+                {
+                    close(connection->fd);
+                }
+            }
+            for (int listener : listeners)
+            {
+                close(listener);
+            }
+            for (const std::string& path : socketPaths)
+            {
+                unlink(path.c_str());
+            }
+            close(epollFd);
+            close(repliesFd);
+            close(stopFd);
+        }
+
+        void watch(int fd, uint32_t events, uint64_t data, int operation = EPOLL_CTL_ADD)
+        {
+            epoll_event event{};
+            event.events = events;
+            event.data.u64 = data;
+            if (epoll_ctl(epollFd, operation, fd, &event) < 0)
+            {
+                Socket::fail("epoll_ctl");
+            }
+        }
+        void addListener(int fd)
+        {
+            listeners.push_back(fd);
+            watch(fd, EPOLLIN, eventData(LISTENER, static_cast<uint32_t>(fd)));
+        }
+
+        // === Workers ===
+
+        void work(Worker& worker)
+        {
+            while (!stopping.load(std::memory_order_acquire))
+            {
+                Request* request = worker.requests.front();
+                if (!request)
+                {
+                    // paired with the fence in enqueue(): either the loop sees
+                    // `sleeping` and signals, or we see its request here
+                    worker.sleeping.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (!worker.requests.front() && !stopping.load(std::memory_order_acquire))
+                    {
+                        consume(worker.wakeFd);
+                    }
+                    worker.sleeping.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                Reply* reply;
+                while (!(reply = worker.replies.claim()))
+                {
+                    if (stopping.load(std::memory_order_acquire))
+                    {
+                        return;
+                    }
+                    signalReplies();
+                    std::this_thread::yield();
+                }
+                games.handle(*request, *reply);
+                worker.replies.publish();
+                worker.requests.pop();
+                signalReplies();
+            }
+        }
+        void signalReplies()
+        {
+            if (!repliesSignalled.exchange(true))
+            {
+                notify(repliesFd);
+            }
+        }
+        // false if the worker's queue is full
+        bool enqueue(uint32_t connection, Command command, uint32_t gameId, std::string_view argument)
+        {
+            Worker& worker = *workers[games.slotFor(gameId) % workers.size()];
+            Request* request = worker.requests.claim();
+            if (!request)
+            {
+                return false;
+            }
+            request->connection = connection;
+            request->connectionGeneration = connections[connection]->generation;
+            request->command = command;
+            request->gameId = gameId;
+            request->length = static_cast<uint16_t>(argument.size());
+            std::memcpy(request->argument, argument.data(), argument.size());
+            worker.requests.publish();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (worker.sleeping.load(std::memory_order_relaxed))
+            {
+                notify(worker.wakeFd);
+            }
+            return true;
+        }
+
+        // === Socket loop ===
+
+        void run()
+        {
+            for (const std::unique_ptr<Worker>& worker : workers)
+            {
+                worker->thread = std::thread([this, &worker] { work(*worker); });
+            }
+            epoll_event events[MAX_EVENTS];
+            while (!stopping.load(std::memory_order_acquire))
+            {
+                int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+                if (count < 0 && errno != EINTR)
+                {
+                    stopping.store(true);
+                }
+                for (int i = 0; i < count; ++i)
+                {
+                    uint32_t index = static_cast<uint32_t>(events[i].data.u64);
+                    switch (static_cast<Source>(events[i].data.u64 >> 32))
+                    {
+                    case LISTENER:
+                        accept(static_cast<int>(index));
+                        break;
+                    case REPLIES:
+                        consume(repliesFd);
+                        repliesSignalled.store(false);
+                        deliverReplies();
+                        break;
+                    case STOP:
+                        stopping.store(true, std::memory_order_release);
+                        break;
+                    case CONNECTION:
+                        if (events[i].events & EPOLLOUT)
+                        {
+                            flush(index);
+                        }
+                        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                        {
+                            receive(index);
+                        }
+                        break;
+                    }
+                }
+            }
+            for (const std::unique_ptr<Worker>& worker : workers)
+            {
+                notify(worker->wakeFd);
+            }
+            for (const std::unique_ptr<Worker>& worker : workers)
+            {
+                worker->thread.join();
+            }
+        }
+        void accept(int listener)
+        {
+            while (true)
+            {
+                int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    return;
+                }
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // fails harmlessly on Unix sockets
+                uint32_t index;
+                if (freeConnections.empty())
+                {
+                    index = static_cast<uint32_t>(connections.size());
+                    connections.push_back(std::make_unique<Connection>());
+                }
+                else
+                {
+                    index = freeConnections.back();
+                    freeConnections.pop_back();
+                }
+                connections[index]->fd = fd;
+                watch(fd, EPOLLIN | EPOLLRDHUP, eventData(CONNECTION, index));
+            }
+        }
+        void disconnect(uint32_t index)
+        {
+            Connection& connection = *connections[index];
+            if (connection.fd < 0)
+            {
+                return;
+            }
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+            close(connection.fd);
+            connection.fd = -1;
+            connection.generation++;
+            connection.inputLength = 0;
+            connection.output.clear();
+            connection.written = 0;
+            connection.writeWatched = false;
+            freeConnections.push_back(index);
+        }
+        void receive(uint32_t index)
+        {
+            Connection& connection = *connections[index];
+            while (connection.fd >= 0)
+            {
+                ssize_t count = read(connection.fd, connection.input + connection.inputLength,
+                    INPUT_SIZE - connection.inputLength);
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    break;
+                }
+                if (count <= 0)
+                {
+                    disconnect(index);
+                    return;
+                }
+                connection.inputLength += static_cast<size_t>(count);
+                size_t start = 0;
+                for (size_t i = 0; i < connection.inputLength; ++i)
+                {
+                    if (connection.input[i] == '\n')
+                    {
+                        size_t end = (i > start && connection.input[i - 1] == '\r') ? i - 1 : i;
+                        handleLine(index, std::string_view(connection.input + start, end - start));
+                        start = i + 1;
+                    }
+                }
+                std::memmove(connection.input, connection.input + start, connection.inputLength - start);
+                connection.inputLength -= start;
+                if (connection.inputLength == INPUT_SIZE)
+                {
+                    disconnect(index);
+                    return;
+                }
+            }
+            flush(index);
+        }
+        void respond(uint32_t index, std::string_view text)
+        {
+            Connection& connection = *connections[index];
+            connection.output.append(text);
+            connection.output.push_back('\n');
+        }
+        void handleLine(uint32_t index, std::string_view line)
+        {
+            std::string_view command = nextWord(line);
+            if (command.empty())
+            {
+                return;
+            }
+            if (command == "new")
+            {
+                std::string_view fen = trim(line);
+                if (fen.size() > ARGUMENT_SIZE)
+                {
+                    respond(index, "error invalid FEN");
+                    return;
+                }
+                if (freeSlots.empty())
+                {
+                    respond(index, "error no free games");
+                    return;
+                }
+                uint32_t slot = freeSlots.back();
+                if (!enqueue(index, NEW, slotGenerations[slot] * static_cast<uint32_t>(games.capacity()) + slot, fen))
+                {
+                    respond(index, "error busy");
+                    return;
+                }
+                freeSlots.pop_back();
+                return;
+            }
+
+            Command parsed;
+            if (command == "move")
+            {
+                parsed = MOVE;
+            }
+            else if (command == "moves")
+            {
+                parsed = MOVES;
+            }
+            else if (command == "fen")
+            {
+                parsed = FEN;
+            }
+            else if (command == "close")
+            {
+                parsed = CLOSE;
+            }
+            else
+            {
+                respond(index, "error unknown command");
+                return;
+            }
+            std::string_view id = nextWord(line);
+            uint32_t gameId;
+            auto [end, error] = std::from_chars(id.data(), id.data() + id.size(), gameId);
+            if (id.empty() || error != std::errc() || end != id.data() + id.size())
+            {
+                respond(index, "error missing game id");
+                return;
+            }
+            std::string_view move = parsed == MOVE ? nextWord(line) : std::string_view();
+            if (move.size() > ARGUMENT_SIZE)
+            {
+                move = move.substr(0, ARGUMENT_SIZE);
+            }
+            if (!enqueue(index, parsed, gameId, move))
+            {
+                char text[32];
+                int length = std::snprintf(text, sizeof(text), "%u error busy", gameId);
+                respond(index, std::string_view(text, length));
+            }
+        }
+        void deliverReplies()
+        {
+            for (const std::unique_ptr<Worker>& worker : workers)
+            {
+                while (Reply* reply = worker->replies.front())
+                {
+                    if (reply->freed)
+                    {
+                        // the next game in this slot gets a new id
+                        uint32_t slot = games.slotFor(reply->gameId);
+                        slotGenerations[slot] = (slotGenerations[slot] + 1) % generationLimit;
+                        freeSlots.push_back(slot);
+                    }
+                    if (reply->connection < connections.size())
+                    {
+                        Connection& connection = *connections[reply->connection];
+                        if (connection.fd >= 0 && connection.generation == reply->connectionGeneration)
+                        {
+                            respond(reply->connection, std::string_view(reply->text, reply->length));
+                            if (!connection.dirty)
+                            {
+                                connection.dirty = true;
+                                dirtyConnections.push_back(reply->connection);
+                            }
+                        }
+                    }
+                    worker->replies.pop();
+                }
+            }
+            for (uint32_t index : dirtyConnections)
+            {
+                connections[index]->dirty = false;
+                flush(index);
+            }
+            dirtyConnections.clear();
+        }
+        void flush(uint32_t index)
+        {
+            Connection& connection = *connections[index];
+            while (connection.fd >= 0 && connection.written < connection.output.size())
+            {
+                ssize_t count = send(connection.fd, connection.output.data() + connection.written,
+                    connection.output.size() - connection.written, MSG_NOSIGNAL);
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    if (connection.output.size() > OUTPUT_LIMIT)
+                    {
+                        disconnect(index);
+                        return;
+                    }
+                    if (!connection.writeWatched)
+                    {
+                        connection.writeWatched = true;
+                        watch(connection.fd, EPOLLIN | EPOLLRDHUP | EPOLLOUT, eventData(CONNECTION, index), EPOLL_CTL_MOD);
+                    }
+                    return;
+                }
+                if (count < 0)
+                {
+                    disconnect(index);
+                    return;
+                }
+                connection.written += static_cast<size_t>(count);
+            }
+            if (connection.fd < 0)
+            {
+                return;
+            }
+            // clear() keeps the capacity, so steady traffic stops allocating
+            connection.output.clear();
+            connection.written = 0;
+            if (connection.writeWatched)
+            {
+                connection.writeWatched = false;
+                watch(connection.fd, EPOLLIN | EPOLLRDHUP, eventData(CONNECTION, index), EPOLL_CTL_MOD);
+            }
+        }
+    };
+
+    SessionServer::SessionServer(const Config& config)
+    {
+        if (config.maxGames == 0 || config.maxGames > UINT32_MAX / 2)
+        {
+            throw std::invalid_argument("maxGames must be between 1 and 2^31");
+        }
+        impl = std::make_unique<Impl>(config);
+    }
+    SessionServer::~SessionServer() = default;
+
+    uint16_t SessionServer::listenTcp(uint16_t port, const std::string& address)
+    {
+        impl->addListener(Socket::listenTcp(address, port));
+        return port;
+    }
+    void SessionServer::listenUnix(const std::string& path)
+    {
+        int fd = Socket::listenUnix(path);
+        impl->socketPaths.push_back(path);
+        impl->addListener(fd);
+    }
+    void SessionServer::run()
+    {
+        impl->run();
+    }
+    void SessionServer::stop()
+    {
+        notify(impl->stopFd);
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "board/board.hpp"
+#include "board/game_history.hpp"
+
+/**
+ * @brief A server hosting many live games in one process.
+ *
+ * Clients connect over TCP or a Unix socket and send one command per line:
+ *
+ *     new [FEN]           -> <id> ok
+ *     move <id> <move>    -> <id> ok <ongoing|checkmate|stalemate|threefold|fifty>
+ *     moves <id>          -> <id> ok e2e4 g1f3 ...
+ *     fen <id>            -> <id> ok <FEN>
+ *     close <id>          -> <id> ok
+ *
+ * Moves are in coordinate notation (e2e4, e7e8q). Failures reply
+ * "<id> error <reason>", or "error <reason>" when no game is involved. Any
+ * connection may address any game. Replies for one game come back in order,
+ * but replies for different games may overtake each other, so every reply
+ * starts with its game id.
+ *
+ * One thread runs an epoll loop over all sockets. Each game belongs to one of
+ * a fixed pool of workers, and the loop hands it requests through a lock-free
+ * single-producer queue per worker. Games live in a table of preallocated
+ * boards and fixed-size histories, and requests and replies use fixed-size
+ * queue slots, so playing a move allocates nothing. Linux only.
+ */
+namespace Server {
+    enum Command : uint8_t {
+        NEW,
+        MOVE,
+        MOVES,
+        FEN,
+        CLOSE
+    };
+    constexpr size_t ARGUMENT_SIZE = 112;
+    // enough for the longest move list in coordinate notation
+    constexpr size_t REPLY_SIZE = 1536;
+
+    /**
+     * @brief A parsed command on its way from the socket loop to a worker.
+     */
+    struct Request {
+        uint32_t connection;
+        uint32_t connectionGeneration;
+        Command command;
+        uint32_t gameId;
+        uint16_t length;
+        char argument[ARGUMENT_SIZE]; // the FEN for NEW, the move for MOVE
+    };
+    /**
+     * @brief A worker's reply, routed back to the connection that asked.
+     */
+    struct Reply {
+        uint32_t connection;
+        uint32_t connectionGeneration;
+        uint32_t gameId;
+        bool freed; // the game was closed and its slot can be reused
+        uint16_t length;
+        char text[REPLY_SIZE];
+    };
+
+    /**
+     * @brief Fixed table of games, one preallocated Board and GameHistory per slot.
+     *
+     * Game ids are generation * capacity + slot, so an id stays invalid once
+     * its game is closed even after the slot is reused. handle() is safe to
+     * call from several threads as long as each slot is only ever handled by
+     * one of them.
+     */
+    class GameTable {
+        struct Game {
+            Board board;
+            GameHistory history;
+            uint32_t id;
+            bool active;
+        };
+        std::vector<Game> games;
+
+        public:
+        explicit GameTable(size_t capacity);
+        size_t capacity() const { return games.size(); }
+        uint32_t slotFor(uint32_t gameId) const { return gameId % games.size(); }
+        /**
+         * @brief Applies `request` and writes the reply text; never allocates for moves.
+         */
+        void handle(const Request& request, Reply& reply);
+    };
+
+    struct Config {
+        size_t maxGames = 10000;
+        int workers = 4;
+        // requests and replies each worker can have in flight
+        size_t queueCapacity = 4096;
+    };
+
+    class SessionServer {
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+
+        public:
+        explicit SessionServer(const Config& config = Config());
+        ~SessionServer();
+        SessionServer(const SessionServer&) = delete;
+        SessionServer& operator=(const SessionServer&) = delete;
+        /**
+         * @brief Listens on a TCP port; port 0 picks a free one.
+         * @return uint16_t The port actually bound.
+         * @throws std::runtime_error If the socket cannot be bound.
+         */
+        uint16_t listenTcp(uint16_t port, const std::string& address = "127.0.0.1");
+        /**
+         * @brief Listens on a Unix socket at `path`, replacing any stale socket file.
+         * @throws std::runtime_error If the socket cannot be bound.
+         */
+        void listenUnix(const std::string& path);
+        /**
+         * @brief Serves clients until stop() is called.
+         */
+        void run();
+        /**
+         * @brief Makes run() return. Safe to call from any thread.
+         */
+        void stop();
+    };
+}
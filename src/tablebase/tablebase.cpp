@@ -0,0 +1,287 @@
+#include "tablebase.hpp"
+#include "tablebase_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <stdexcept>
+
+namespace {
+    const std::string PIECE_ORDER = "KQRBNP";
+
+    int pieceValue(char piece)
+    {
+        switch (piece)
+        {
+        case 'Q':
+            return 9;
+        case 'R':
+            return 5;
+        case 'B':
+        case 'N':
+            return 3;
+        case 'P':
+            return 1;
+        default:
+            return 0;
+        }
+    }
+    int sideValue(const std::string& side)
+    {
+        int value = 0;
+        for (char piece : side)
+        {
+            value += pieceValue(piece);
+        }
+        return value;
+    }
+    // true if `first` should be stored as the first (white) side of a table
+    bool storedFirst(const std::string& first, const std::string& second)
+    {
+        int firstValue = sideValue(first);
+        int secondValue = sideValue(second);
+        return firstValue != secondValue ? firstValue > secondValue : first >= second;
+    }
+    // validates one side of a material name and sorts it into KQRBNP order
+    std::string normaliseSide(std::string side)
+    {
+        if (std::count(side.begin(), side.end(), 'K') != 1)
+        {
+            throw std::invalid_argument("Invalid material: each side needs exactly one king");
+        }
+        for (char piece : side)
+        {
+            if (PIECE_ORDER.find(piece) == std::string::npos)
+            {
+                throw std::invalid_argument("Invalid material: unknown piece");
+            }
+        }
+        std::sort(side.begin(), side.end(), [](char a, char b) {
+            return PIECE_ORDER.find(a) < PIECE_ORDER.find(b);
+        });
+        return side;
+    }
+    Board::Piece pieceForLetter(char piece, bool white)
+    {
+        Board::Piece pieces[6] = {Board::WHITE_KING, Board::WHITE_QUEEN, Board::WHITE_ROOK,
+                                  Board::WHITE_BISHOP, Board::WHITE_KNIGHT, Board::WHITE_PAWN};
+        Board::Piece result = pieces[PIECE_ORDER.find(piece)];
+        return white ? result : static_cast<Board::Piece>(result + 6);
+    }
+    Board::Piece swapColour(Board::Piece piece)
+    {
+        return static_cast<Board::Piece>(piece < Board::BLACK_PAWN ? piece + 6 : piece - 6);
+    }
+    std::string sideForBoard(const Board& board, bool white)
+    {
+        std::string side;
+        for (char letter : PIECE_ORDER)
+        {
+            int count = __builtin_popcountll(board.getBitmaskForPiece(pieceForLetter(letter, white)));
+            side.append(count, letter);
+        }
+        return side;
+    }
+}
+
+namespace Tablebase {
+    Material::Material(const std::string& name)
+    {
+        size_t separator = name.find('v');
+        if (separator == std::string::npos)
+        {
+            throw std::invalid_argument("Invalid material: expected a name like KQvK");
+        }
+        std::string first = normaliseSide(name.substr(0, separator));
+        std::string second = normaliseSide(name.substr(separator + 1));
+        if (!storedFirst(first, second))
+        {
+            std::swap(first, second);
+        }
+        if (first.size() + second.size() > MAX_PIECES)
+        {
+            throw std::invalid_argument("Invalid material: too many pieces");
+        }
+        materialName = first + "v" + second;
+        for (char piece : first)
+        {
+            pieceList.push_back(pieceForLetter(piece, true));
+        }
+        for (char piece : second)
+        {
+            pieceList.push_back(pieceForLetter(piece, false));
+        }
+    }
+    std::string Material::nameForBoard(const Board& board, bool& flipped)
+    {
+        std::string white = sideForBoard(board, true);
+        std::string black = sideForBoard(board, false);
+        flipped = !storedFirst(white, black);
+        return flipped ? black + "v" + white : white + "v" + black;
+    }
+    uint64_t Material::size() const
+    {
+        return 2ULL << (6 * pieceList.size());
+    }
+    uint64_t Material::index(const Board& board, bool flipped) const
+    {
+        // a flipped board is mirrored top to bottom, which is a byte swap of each bitboard
+        uint64_t index = board.getTurn() != flipped ? 0 : 1;
+        uint64_t multiplier = 2;
+        size_t i = 0;
+        while (i < pieceList.size())
+        {
+            Board::Piece piece = pieceList[i];
+            uint64_t bitboard = board.getBitmaskForPiece(flipped ? swapColour(piece) : piece);
+            if (flipped)
+            {
+                bitboard = __builtin_bswap64(bitboard);
+            }
+            // identical pieces are listed together and take their squares in ascending order
+            for (; i < pieceList.size() && pieceList[i] == piece; ++i)
+            {
+                index += __builtin_ctzll(bitboard) * multiplier;
+                bitboard &= bitboard - 1;
+                multiplier *= 64;
+            }
+        }
+        return index;
+    }
+    bool Material::decode(uint64_t index, Board& board) const
+    {
+        board.setTurn((index & 1) == 0);
+        index >>= 1;
+        uint64_t occupied = 0;
+        Board::Piece previous = Board::EMPTY;
+        int previousSquare = -1;
+        for (Board::Piece piece : pieceList)
+        {
+            int square = index & 63;
+            index >>= 6;
+            uint64_t bit = 1ULL << square;
+            if ((occupied & bit)
+                || ((piece == Board::WHITE_PAWN || piece == Board::BLACK_PAWN) && (square < 8 || square >= 56))
+                || (piece == previous && square <= previousSquare))
+            {
+                return false;
+            }
+            board.placePiece(piece, square);
+            occupied |= bit;
+            previous = piece;
+            previousSquare = square;
+        }
+        return true;
+    }
+    std::vector<std::string> Material::successors() const
+    {
+        size_t separator = materialName.find('v');
+        std::string sides[2] = {materialName.substr(0, separator), materialName.substr(separator + 1)};
+        std::set<std::string> result;
+        for (int side = 0; side < 2; ++side)
+        {
+            std::string& own = sides[side];
+            std::string& other = sides[1 - side];
+            for (size_t i = 1; i < own.size(); ++i)
+            {
+                // the opponent captures this piece
+                std::string captured = own;
+                captured.erase(i, 1);
+                result.insert(Material(side == 0 ? captured + "v" + other : other + "v" + captured).name());
+                if (own[i] != 'P')
+                {
+                    continue;
+                }
+                for (char promotion : std::string("QRBN"))
+                {
+                    std::string promoted = own;
+                    promoted[i] = promotion;
+                    result.insert(Material(side == 0 ? promoted + "v" + other : other + "v" + promoted).name());
+                    // promoting with a capture
+                    for (size_t j = 1; j < other.size(); ++j)
+                    {
+                        std::string remaining = other;
+                        remaining.erase(j, 1);
+                        result.insert(Material(side == 0 ? promoted + "v" + remaining : remaining + "v" + promoted).name());
+                    }
+                }
+            }
+        }
+        return std::vector<std::string>(result.begin(), result.end());
+    }
+
+    int Tablebases::addDirectory(const std::string& directory)
+    {
+        int added = 0;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (entry.path().extension() == ".ctb")
+            {
+                addFile(entry.path().string());
+                ++added;
+            }
+        }
+        return added;
+    }
+    void Tablebases::addFile(const std::string& path)
+    {
+        auto file = std::make_unique<MappedFile>(path);
+        FileHeader header;
+        if (file->size() < sizeof(header))
+        {
+            throw std::runtime_error("Not a tablebase file: " + path);
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        std::string name(header.material, strnlen(header.material, sizeof(header.material)));
+        if (std::memcmp(header.magic, "CTB1", 4) != 0)
+        {
+            throw std::runtime_error("Not a tablebase file: " + path);
+        }
+        Material material(name);
+        if (header.entryCount != material.size() || file->size() != sizeof(header) + header.entryCount)
+        {
+            throw std::runtime_error("Truncated tablebase file: " + path);
+        }
+        tables.erase(material.name());
+        tables.emplace(material.name(), Table{material, file->data() + sizeof(header)});
+        files.push_back(std::move(file));
+    }
+    bool Tablebases::hasTable(const std::string& name) const
+    {
+        return tables.count(name) != 0;
+    }
+    uint8_t Tablebases::probeEntry(const Board& board) const
+    {
+        bool flipped;
+        auto table = tables.find(Material::nameForBoard(board, flipped));
+        if (table == tables.end())
+        {
+            return ENTRY_INVALID;
+        }
+        return table->second.entries[table->second.material.index(board, flipped)];
+    }
+    bool Tablebases::probe(const Board& board, ProbeResult& result) const
+    {
+        uint8_t entry = probeEntry(board);
+        if (entry == ENTRY_INVALID)
+        {
+            return false;
+        }
+        result = decodeEntry(entry);
+        return true;
+    }
+
+    ProbeResult decodeEntry(uint8_t entry)
+    {
+        if (entry == ENTRY_DRAW || entry == ENTRY_INVALID)
+        {
+            return {DRAW, 0};
+        }
+        int plies = entry - 1;
+        return {plies % 2 == 1 ? WIN : LOSS, plies};
+    }
+    std::string fileName(const std::string& material)
+    {
+        return Material(material).name() + ".ctb";
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "board/board.hpp"
+#include "util/mapped_file.hpp"
+
+/**
+ * @brief Endgame tablebases: exact win/draw/loss and distance to mate for small
+ * material configurations.
+ *
+ * Every table covers one material configuration such as "KQvK" and holds one
+ * byte per indexed position:
+ * - 0 means a draw,
+ * - 255 marks an index that is not a legal position,
+ * - anything else is the number of plies to mate plus one. Odd plies mean the
+ *   side to move mates, even plies mean the side to move gets mated.
+ *
+ * Positions are indexed without castling or en passant rights.
+ */
+namespace Tablebase {
+    constexpr uint8_t ENTRY_DRAW = 0;
+    constexpr uint8_t ENTRY_INVALID = 255;
+    // five pieces already mean 2 * 64^5 entries; more would not fit in memory
+    constexpr int MAX_PIECES = 5;
+
+    enum Outcome {
+        LOSS = -1,
+        DRAW = 0,
+        WIN = 1
+    };
+    /**
+     * @brief A decoded table entry, from the side to move's point of view.
+     */
+    struct ProbeResult {
+        Outcome outcome;
+        int pliesToMate; // 0 for draws
+    };
+
+    /**
+     * @brief A material configuration and the position index over it.
+     *
+     * Names list white's pieces, a 'v', then black's, each side starting with its
+     * king (e.g. "KRvKN"). The side with more material is always stored first;
+     * positions where black has it are probed with colours swapped and the board
+     * mirrored.
+     *
+     * The index is side to move plus one square per piece, so a table has
+     * 2 * 64^pieces entries. Identical pieces are indexed in ascending square
+     * order, other orderings are marked invalid.
+     */
+    class Material {
+        std::string materialName;
+        // WHITE_* pieces of the first side, then BLACK_* pieces of the second
+        std::vector<Board::Piece> pieceList;
+
+        public:
+        /**
+         * @brief Parses a material name, swapping the sides if the second is stronger.
+         * @throws std::invalid_argument If the name is malformed or has too many pieces.
+         */
+        explicit Material(const std::string& name);
+        /**
+         * @brief Returns the table name of a board's material and whether the board
+         * has to be probed colour-flipped.
+         */
+        static std::string nameForBoard(const Board& board, bool& flipped);
+
+        const std::string& name() const { return materialName; }
+        const std::vector<Board::Piece>& pieces() const { return pieceList; }
+        uint64_t size() const;
+        /**
+         * @brief Returns the index of `board`, which must have exactly this material.
+         */
+        uint64_t index(const Board& board, bool flipped) const;
+        /**
+         * @brief Places the pieces for `index` on `board`, which must be empty.
+         * @return bool False if the index does not describe a placeable position
+         * (shared squares, pawns on the back ranks or unsorted identical pieces).
+         */
+        bool decode(uint64_t index, Board& board) const;
+        /**
+         * @brief Names of the tables this one converts into by a capture or promotion.
+         */
+        std::vector<std::string> successors() const;
+    };
+
+    /**
+     * @brief A set of memory-mapped tables, probed by Board.
+     */
+    class Tablebases {
+        struct Table {
+            Material material;
+            const uint8_t* entries;
+        };
+        std::map<std::string, Table> tables;
+        std::vector<std::unique_ptr<MappedFile>> files;
+
+        public:
+        /**
+         * @brief Maps every table file (*.ctb) in `directory`.
+         * @return int The number of tables added.
+         */
+        int addDirectory(const std::string& directory);
+        /**
+         * @brief Maps a single table file.
+         * @throws std::runtime_error If the file is missing or is not a table.
+         */
+        void addFile(const std::string& path);
+        bool hasTable(const std::string& name) const;
+        /**
+         * @brief Returns the raw entry for `board`, or ENTRY_INVALID if no table covers it.
+         */
+        uint8_t probeEntry(const Board& board) const;
+        /**
+         * @brief Looks up `board`.
+         * @return bool False if no table covers the board's material.
+         */
+        bool probe(const Board& board, ProbeResult& result) const;
+    };
+
+    /**
+     * @brief Decodes a raw table entry.
+     */
+    ProbeResult decodeEntry(uint8_t entry);
+    /**
+     * @brief Returns the file name used for a table, e.g. "KQvK.ctb".
+     */
+    std::string fileName(const std::string& material);
+
+    /**
+     * @brief Generates the table for `material` by retrograde analysis.
+     *
+     * Tables it converts into are generated first unless `directory` already has
+     * them. Every table is written to `directory` and work is spread over
+     * `threads` threads.
+     *
+     * @param log Optional stream for progress messages.
+     * @throws std::invalid_argument If the material name is invalid.
+     * @throws std::runtime_error If a table cannot be written.
+     */
+    void generate(const std::string& material, const std::string& directory, int threads,
+                  std::ostream* log = nullptr);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of a table: this header followed by one byte per index.
+// Internal to the tablebase module.
+namespace Tablebase {
+    struct FileHeader {
+        char magic[4];       // "CTB1"
+        uint32_t pieceCount;
+        uint64_t entryCount;
+        char material[16];   // NUL padded material name
+    };
+    static_assert(sizeof(FileHeader) == 32, "table header must stay 32 bytes");
+}
@@ -0,0 +1,398 @@
+#include "tablebase.hpp"
+#include "tablebase_file.hpp"
+#include "board/attacks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    using namespace Tablebase;
+
+    // value of a position that is legal but not (yet) known to be won or lost
+    constexpr uint8_t UNKNOWN = 254;
+    // `remaining` marker for positions with a drawn or losing child, which can never be lost
+    constexpr uint8_t CANNOT_LOSE = 255;
+    // entries store plies + 1 and must stay below UNKNOWN
+    constexpr int MAX_LEVEL = 252;
+
+    // runs body(begin, end, thread) over [0, count) split into one slice per thread
+    template <typename Body>
+    void parallelFor(uint64_t count, int threads, Body body)
+    {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(threads);
+        uint64_t slice = (count + threads - 1) / threads;
+        for (int thread = 0; thread < threads; ++thread)
+        {
+            uint64_t begin = thread * slice;
+            uint64_t end = std::min(count, begin + slice);
+            if (begin >= end)
+            {
+                break;
+            }
+            workers.emplace_back([&, begin, end, thread]() {
+                try
+                {
+                    body(begin, end, thread);
+                }
+                catch (...)
+                {
+                    errors[thread] = std::current_exception();
+                }
+            });
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    /**
+     * Retrograde analysis of one table.
+     *
+     * Every position is generated forward once to count its moves and to look up
+     * captures and promotions in the smaller tables. After that, positions are
+     * resolved in order of distance to mate: mates first, then for each resolved
+     * position its predecessors are found by un-moving the side that just moved.
+     * A predecessor of a lost position is won one ply later; a predecessor whose
+     * children have all turned out to be won is lost one ply after the last one.
+     */
+    class Generator {
+        const Material& material;
+        const Tablebases& tables;
+        int threads;
+        uint64_t size;
+        std::unique_ptr<std::atomic<uint8_t>[]> values;
+        // children in this table not yet known to be won for the opponent
+        std::unique_ptr<std::atomic<uint8_t>[]> remaining;
+        // longest win the opponent has after a capture or promotion into another table
+        std::unique_ptr<uint8_t[]> conversionWins;
+        // positions to resolve at each level, kept per thread until a phase ends
+        std::vector<std::vector<uint32_t>> buckets;
+        std::vector<std::vector<std::vector<uint32_t>>> threadBuckets;
+        Board empty;
+
+        void schedule(int thread, int level, uint64_t index)
+        {
+            if (level > MAX_LEVEL)
+            {
+                throw std::runtime_error("Distance to mate too long for " + material.name());
+            }
+            threadBuckets[thread][level].push_back(static_cast<uint32_t>(index));
+        }
+        void mergeBuckets()
+        {
+            for (auto& local : threadBuckets)
+            {
+                for (int level = 0; level <= MAX_LEVEL; ++level)
+                {
+                    buckets[level].insert(buckets[level].end(), local[level].begin(), local[level].end());
+                    local[level].clear();
+                }
+            }
+        }
+
+        void initialise(uint64_t begin, uint64_t end, int thread)
+        {
+            for (uint64_t index = begin; index < end; ++index)
+            {
+                values[index].store(ENTRY_INVALID, std::memory_order_relaxed);
+                remaining[index].store(CANNOT_LOSE, std::memory_order_relaxed);
+                conversionWins[index] = 0;
+
+                Board board = empty;
+                if (!material.decode(index, board))
+                {
+                    continue;
+                }
+                // the side that just moved may not have left its king in check
+                bool white = board.getTurn();
+                uint64_t theirKing = board.getBitmaskForPiece(white ? Board::BLACK_KING : Board::WHITE_KING);
+                if (board.isSquareAttacked(__builtin_ctzll(theirKing), white ? Board::WHITE : Board::BLACK))
+                {
+                    continue;
+                }
+                values[index].store(UNKNOWN, std::memory_order_relaxed);
+
+                Board::MoveList moves = board.generateMoves();
+                if (moves.size() == 0)
+                {
+                    if (board.inCheck())
+                    {
+                        schedule(thread, 0, index);
+                    }
+                    continue;
+                }
+
+                int sameTable = 0;
+                int fastestWin = -1;
+                int slowestLoss = 0;
+                bool cannotLose = false;
+                uint64_t occupancy = board.getBitmaskForBoard();
+                for (const Board::Move& move : moves)
+                {
+                    if (move.promotion == Board::EMPTY && !(occupancy & (1ULL << move.to)))
+                    {
+                        ++sameTable;
+                        continue;
+                    }
+                    Board::UndoInfo undo = board.makeMove(move);
+                    uint8_t entry = tables.probeEntry(board);
+                    board.unmakeMove(move, undo);
+                    if (entry == ENTRY_INVALID)
+                    {
+                        throw std::runtime_error("Missing table for a conversion from " + material.name());
+                    }
+                    ProbeResult child = decodeEntry(entry);
+                    if (child.outcome == WIN)
+                    {
+                        slowestLoss = std::max(slowestLoss, child.pliesToMate);
+                        continue;
+                    }
+                    cannotLose = true;
+                    if (child.outcome == LOSS && (fastestWin < 0 || child.pliesToMate + 1 < fastestWin))
+                    {
+                        fastestWin = child.pliesToMate + 1;
+                    }
+                }
+
+                conversionWins[index] = static_cast<uint8_t>(slowestLoss);
+                if (fastestWin >= 0)
+                {
+                    schedule(thread, fastestWin, index);
+                }
+                if (!cannotLose)
+                {
+                    remaining[index].store(static_cast<uint8_t>(sameTable), std::memory_order_relaxed);
+                    if (sameTable == 0)
+                    {
+                        schedule(thread, slowestLoss + 1, index);
+                    }
+                }
+            }
+        }
+
+        // calls visit(index) for every position that reaches `board` with a non-capturing move
+        template <typename Visit>
+        void forEachPredecessor(const Board& board, Visit visit) const
+        {
+            bool moverWhite = !board.getTurn();
+            uint64_t occupancy = board.getBitmaskForBoard();
+            int first = moverWhite ? Board::WHITE_PAWN : Board::BLACK_PAWN;
+            for (int type = 0; type < 6; ++type)
+            {
+                Board::Piece piece = static_cast<Board::Piece>(first + type);
+                uint64_t squares = board.getBitmaskForPiece(piece);
+                while (squares)
+                {
+                    int square = __builtin_ctzll(squares);
+                    squares &= squares - 1;
+
+                    uint64_t origins = 0;
+                    switch (type)
+                    {
+                    case 0:
+                    {
+                        // pawns step back one square, or two from their double-push rank
+                        int back = moverWhite ? -8 : 8;
+                        int origin = square + back;
+                        if (origin >= 8 && origin < 56 && !(occupancy & (1ULL << origin)))
+                        {
+                            origins |= 1ULL << origin;
+                            if (square / 8 == (moverWhite ? 3 : 4) && !(occupancy & (1ULL << (origin + back))))
+                            {
+                                origins |= 1ULL << (origin + back);
+                            }
+                        }
+                        break;
+                    }
+                    case 1:
+                        origins = Attacks::knight(square);
+                        break;
+                    case 2:
+                        origins = Attacks::bishop(square, occupancy);
+                        break;
+                    case 3:
+                        origins = Attacks::rook(square, occupancy);
+                        break;
+                    case 4:
+                        origins = Attacks::queen(square, occupancy);
+                        break;
+                    default:
+                        origins = Attacks::king(square);
+                        break;
+                    }
+                    origins &= ~occupancy;
+
+                    while (origins)
+                    {
+                        int origin = __builtin_ctzll(origins);
+                        origins &= origins - 1;
+                        Board predecessor = board;
+                        predecessor.placePiece(Board::EMPTY, square);
+                        predecessor.placePiece(piece, origin);
+                        predecessor.setTurn(moverWhite);
+                        visit(material.index(predecessor, false));
+                    }
+                }
+            }
+        }
+
+        void resolveLevel(const std::vector<uint32_t>& positions, int level, uint64_t begin, uint64_t end, int thread)
+        {
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                uint32_t index = positions[i];
+                uint8_t expected = UNKNOWN;
+                if (!values[index].compare_exchange_strong(expected, static_cast<uint8_t>(level + 1)))
+                {
+                    // already resolved at a lower level
+                    continue;
+                }
+                Board board = empty;
+                material.decode(index, board);
+                forEachPredecessor(board, [&](uint64_t predecessor) {
+                    if (values[predecessor].load(std::memory_order_relaxed) != UNKNOWN)
+                    {
+                        return;
+                    }
+                    if (level % 2 == 0)
+                    {
+                        // moving into a lost position wins
+                        schedule(thread, level + 1, predecessor);
+                    }
+                    else if (remaining[predecessor].load(std::memory_order_relaxed) != CANNOT_LOSE
+                             && remaining[predecessor].fetch_sub(1) == 1)
+                    {
+                        // this was the last child left that was not a win for the opponent
+                        schedule(thread, std::max(level, static_cast<int>(conversionWins[predecessor])) + 1, predecessor);
+                    }
+                });
+            }
+        }
+
+        public:
+        Generator(const Material& material, const Tablebases& tables, int threads)
+            : material(material), tables(tables), threads(std::max(1, threads)), size(material.size()),
+              values(new std::atomic<uint8_t>[size]), remaining(new std::atomic<uint8_t>[size]),
+              conversionWins(new uint8_t[size]), buckets(MAX_LEVEL + 1),
+              threadBuckets(this->threads, std::vector<std::vector<uint32_t>>(MAX_LEVEL + 1)),
+              empty("8/8/8/8/8/8/8/8 w - -")
+        {
+        }
+
+        std::vector<uint8_t> run()
+        {
+            parallelFor(size, threads, [this](uint64_t begin, uint64_t end, int thread) {
+                initialise(begin, end, thread);
+            });
+            mergeBuckets();
+
+            for (int level = 0; level <= MAX_LEVEL; ++level)
+            {
+                std::vector<uint32_t> positions;
+                positions.swap(buckets[level]);
+                parallelFor(positions.size(), threads, [&](uint64_t begin, uint64_t end, int thread) {
+                    resolveLevel(positions, level, begin, end, thread);
+                });
+                mergeBuckets();
+            }
+
+            std::vector<uint8_t> entries(size);
+            for (uint64_t index = 0; index < size; ++index)
+            {
+                uint8_t value = values[index].load(std::memory_order_relaxed);
+                entries[index] = value == UNKNOWN ? ENTRY_DRAW : value;
+            }
+            return entries;
+        }
+    };
+
+    void writeTable(const std::string& path, const Material& material, const std::vector<uint8_t>& entries)
+    {
+        FileHeader header{};
+        std::memcpy(header.magic, "CTB1", 4);
+        header.pieceCount = static_cast<uint32_t>(material.pieces().size());
+        header.entryCount = entries.size();
+        // the header is zeroed, so copying at most one byte less keeps the name terminated
+        const std::string& name = material.name();
+        std::memcpy(header.material, name.data(), std::min(name.size(), sizeof(header.material) - 1));
+
+        // write under a temporary name so an interrupted run never leaves a truncated table behind
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(entries.data()), entries.size());
+            if (!out)
+            {
+                throw std::runtime_error("Cannot write " + temporary);
+            }
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    void generateWithSuccessors(const Material& material, const std::string& directory, int threads,
+                                Tablebases& tables, std::ostream* log)
+    {
+        if (tables.hasTable(material.name()))
+        {
+            return;
+        }
+        for (const std::string& successor : material.successors())
+        {
+            generateWithSuccessors(Material(successor), directory, threads, tables, log);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint8_t> entries = Generator(material, tables, threads).run();
+        std::string path = (std::filesystem::path(directory) / fileName(material.name())).string();
+        writeTable(path, material, entries);
+        tables.addFile(path);
+
+        if (log)
+        {
+            uint64_t wins = 0, losses = 0, draws = 0;
+            int longest = 0;
+            for (uint8_t entry : entries)
+            {
+                if (entry == ENTRY_INVALID)
+                {
+                    continue;
+                }
+                ProbeResult result = decodeEntry(entry);
+                wins += result.outcome == WIN;
+                losses += result.outcome == LOSS;
+                draws += result.outcome == DRAW;
+                longest = std::max(longest, result.pliesToMate);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            *log << material.name() << ": " << wins << " wins, " << draws << " draws, " << losses
+                 << " losses, longest mate " << longest << " plies (" << seconds << "s)" << std::endl;
+        }
+    }
+}
+
+namespace Tablebase {
+    void generate(const std::string& material, const std::string& directory, int threads, std::ostream* log)
+    {
+        Material requested(material);
+        std::filesystem::create_directories(directory);
+        Tablebases tables;
+        tables.addDirectory(directory);
+        generateWithSuccessors(requested, directory, threads, tables, log);
+    }
+}
@@ -0,0 +1,24 @@
+#include "arena.hpp"
+#include <algorithm>
+
+Arena::Arena(size_t bytes)
+    : memory(new std::byte[bytes]), length(bytes), offset(0)
+{
+}
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+    // reserve enough for the worst-case padding, then align inside the reservation
+    size_t start = offset.fetch_add(bytes + alignment - 1, std::memory_order_relaxed);
+    if (start + bytes + alignment - 1 > length)
+    {
+        return nullptr;
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory.get()) + start;
+    address = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    return reinterpret_cast<void*>(address);
+}
+size_t Arena::used() const
+{
+    // failed allocations still advance the offset, so clamp to what exists
+    return std::min(offset.load(std::memory_order_relaxed), length);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Fixed-size bump allocator shared by several threads.
+ *
+ * Allocation is a single atomic add on the fill offset, so threads never take
+ * a lock or touch the heap, and everything handed out is released at once by
+ * reset(). Nothing is ever destroyed individually, so only trivially
+ * destructible types may be created in an arena.
+ */
+class Arena {
+    std::unique_ptr<std::byte[]> memory;
+    size_t length;
+    std::atomic<size_t> offset;
+
+    public:
+    /**
+     * @brief Reserves `bytes` of memory up front.
+     */
+    explicit Arena(size_t bytes);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Returns `bytes` of memory aligned to `alignment`, or nullptr once the arena is full.
+     */
+    void* allocate(size_t bytes, size_t alignment);
+    /**
+     * @brief Default-constructs `count` objects of type T, or returns nullptr if they do not fit.
+     */
+    template<typename T> T* create(size_t count = 1)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        void* block = allocate(sizeof(T) * count, alignof(T));
+        if (!block)
+        {
+            return nullptr;
+        }
+        T* objects = static_cast<T*>(block);
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (objects + i) T();
+        }
+        return objects;
+    }
+    /**
+     * @brief Releases every allocation in O(1). Not safe while other threads allocate.
+     */
+    void reset() { offset.store(0, std::memory_order_relaxed); }
+
+    size_t used() const;
+    size_t capacity() const { return length; }
+};
@@ -0,0 +1,155 @@
+#include "instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+    const char* const COUNTER_NAMES[Instrumentation::COUNTER_COUNT] = {
+        "move_generation", "move_count", "make_move", "unmake_move", "fen_parse", "fen_emit", "hash",
+    };
+
+    // one thread's counters; only the owner writes, snapshot() reads
+    struct alignas(64) ThreadCounters {
+        std::atomic<uint64_t> calls[Instrumentation::COUNTER_COUNT] = {};
+        std::atomic<uint64_t> ticks[Instrumentation::COUNTER_COUNT] = {};
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters*> live;
+        // totals of threads that have exited
+        uint64_t retiredCalls[Instrumentation::COUNTER_COUNT] = {};
+        uint64_t retiredTicks[Instrumentation::COUNTER_COUNT] = {};
+    };
+    Registry& registry()
+    {
+        // never destroyed, so threads exiting during shutdown can still retire
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    // registers the thread's counters on first use and folds them into the
+    // retired totals when the thread exits
+    struct ThreadSlot {
+        ThreadCounters counters;
+
+        ThreadSlot()
+        {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            registry().live.push_back(&counters);
+        }
+        ~ThreadSlot()
+        {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            for (int i = 0; i < Instrumentation::COUNTER_COUNT; ++i)
+            {
+                shared.retiredCalls[i] += counters.calls[i].load(std::memory_order_relaxed);
+                shared.retiredTicks[i] += counters.ticks[i].load(std::memory_order_relaxed);
+            }
+            shared.live.erase(std::find(shared.live.begin(), shared.live.end(), &counters));
+        }
+    };
+    ThreadCounters& threadCounters()
+    {
+        thread_local ThreadSlot slot;
+        return slot.counters;
+    }
+}
+
+namespace Instrumentation {
+    double ticksPerNanosecond()
+    {
+        static const double rate = []() {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t startTicks = now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            uint64_t ticks = now() - startTicks;
+            double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            return ticks > 0 && nanoseconds > 0 ? ticks / nanoseconds : 1.0;
+        }();
+        return rate;
+    }
+    const char* counterName(Counter counter)
+    {
+        return COUNTER_NAMES[counter];
+    }
+    void record(Counter counter, uint64_t ticks)
+    {
+        // single writer per thread, so a relaxed load and store is enough and avoids a locked add
+        ThreadCounters& counters = threadCounters();
+        counters.calls[counter].store(counters.calls[counter].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counters.ticks[counter].store(counters.ticks[counter].load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    }
+
+    std::vector<Stat> snapshot()
+    {
+        std::vector<Stat> stats;
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (int i = 0; i < COUNTER_COUNT; ++i)
+        {
+            Stat stat{COUNTER_NAMES[i], shared.retiredCalls[i], shared.retiredTicks[i], 0.0};
+            for (ThreadCounters* counters : shared.live)
+            {
+                stat.calls += counters->calls[i].load(std::memory_order_relaxed);
+                stat.ticks += counters->ticks[i].load(std::memory_order_relaxed);
+            }
+            stats.push_back(stat);
+        }
+        if (enabled)
+        {
+            for (Stat& stat : stats)
+            {
+                stat.nanoseconds = stat.ticks / ticksPerNanosecond();
+            }
+        }
+        return stats;
+    }
+    void reset()
+    {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (int i = 0; i < COUNTER_COUNT; ++i)
+        {
+            shared.retiredCalls[i] = 0;
+            shared.retiredTicks[i] = 0;
+            for (ThreadCounters* counters : shared.live)
+            {
+                counters->calls[i].store(0, std::memory_order_relaxed);
+                counters->ticks[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    std::string toJson()
+    {
+        std::ostringstream out;
+        out << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"counters\": {";
+        std::vector<Stat> stats = snapshot();
+        for (size_t i = 0; i < stats.size(); ++i)
+        {
+            out << (i ? ", " : "") << "\"" << stats[i].name << "\": {\"calls\": " << stats[i].calls
+                << ", \"ticks\": " << stats[i].ticks << ", \"ns\": " << std::fixed << std::setprecision(0)
+                << stats[i].nanoseconds << "}";
+        }
+        out << "}}";
+        return out.str();
+    }
+    std::string toTable()
+    {
+        std::ostringstream out;
+        out << std::left << std::setw(18) << "counter" << std::right << std::setw(14) << "calls" << std::setw(16)
+            << "total ms" << std::setw(12) << "ns/call" << "\n";
+        for (const Stat& stat : snapshot())
+        {
+            out << std::left << std::setw(18) << stat.name << std::right << std::setw(14) << stat.calls << std::fixed
+                << std::setprecision(3) << std::setw(16) << stat.nanoseconds / 1e6 << std::setprecision(1)
+                << std::setw(12) << (stat.calls ? stat.nanoseconds / stat.calls : 0.0) << "\n";
+        }
+        return out.str();
+    }
+}
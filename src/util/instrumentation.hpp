@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Call counters and cycle timers for the library's hot paths.
+ *
+ * Compiled in with the CHESS_INSTRUMENTATION CMake option. Without it the
+ * CHESS_TIMED() and CHESS_COUNTED() macros expand to nothing and the hot
+ * paths carry no extra code; the reporting functions below still exist and
+ * simply report zeros.
+ *
+ * Every thread records into its own counters, so instrumented code never
+ * shares a cache line with another thread. snapshot() adds up all live
+ * threads plus every thread that has already exited.
+ */
+namespace Instrumentation {
+    enum Counter {
+        MOVE_GENERATION,
+        MOVE_COUNT, // countMoves(), which perft uses instead of generating the last ply
+        MAKE_MOVE,
+        UNMAKE_MOVE,
+        FEN_PARSE,
+        FEN_EMIT,
+        HASH,
+        COUNTER_COUNT
+    };
+#ifdef CHESS_INSTRUMENTATION
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    struct Stat {
+        const char* name;
+        uint64_t calls;
+        uint64_t ticks;
+        double nanoseconds; // ticks converted with ticksPerNanosecond()
+    };
+
+    /**
+     * @brief Reads the timer: the TSC on x86, steady_clock nanoseconds elsewhere.
+     */
+    inline uint64_t now();
+    /**
+     * @brief Timer ticks per nanosecond, measured once on first use.
+     */
+    double ticksPerNanosecond();
+    const char* counterName(Counter counter);
+    /**
+     * @brief Adds one call taking `ticks` to the calling thread's counters.
+     */
+    void record(Counter counter, uint64_t ticks);
+
+    /**
+     * @brief Totals over every thread, one entry per counter.
+     */
+    std::vector<Stat> snapshot();
+    /**
+     * @brief Zeroes the counters of every thread.
+     */
+    void reset();
+    std::string toJson();
+    std::string toTable();
+
+    /**
+     * @brief Records the lifetime of the enclosing scope against a counter.
+     */
+    class ScopedTimer {
+        Counter counter;
+        uint64_t start;
+
+        public:
+        explicit ScopedTimer(Counter counter) : counter(counter), start(now()) {}
+        ~ScopedTimer() { record(counter, now() - start); }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+inline uint64_t Instrumentation::now() { return __rdtsc(); }
+#else
+inline uint64_t Instrumentation::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#ifdef CHESS_INSTRUMENTATION
+#define CHESS_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define CHESS_INSTRUMENTATION_CONCAT(a, b) CHESS_INSTRUMENTATION_CONCAT_(a, b)
+// times the rest of the enclosing scope
+#define CHESS_TIMED(counter) \
+    Instrumentation::ScopedTimer CHESS_INSTRUMENTATION_CONCAT(chessTimer, __LINE__)(Instrumentation::counter)
+// counts a call without timing it
+#define CHESS_COUNTED(counter) Instrumentation::record(Instrumentation::counter, 0)
+#else
+#define CHESS_TIMED(counter) ((void)0)
+#define CHESS_COUNTED(counter) ((void)0)
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Pages are loaded by the OS on first access, so opening even a large file is
+ * cheap and several processes mapping the same file share one copy in memory.
+ */
+class MappedFile {
+    const uint8_t* mapping;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    public:
+    /**
+     * @brief Maps `path` into memory.
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return mapping; }
+    size_t size() const { return length; }
+};
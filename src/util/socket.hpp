@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Socket helpers shared by the session server and the distributed module.
+ *
+ * Listening sockets are non-blocking and close on exec; failures throw
+ * std::runtime_error naming the call and errno. Linux only.
+ */
+namespace Socket {
+    [[noreturn]] inline void fail(const std::string& what)
+    {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    /**
+     * @brief Listens on `address`:`port`, where port 0 picks a free one; `port` receives the port bound.
+     */
+    inline int listenTcp(const std::string& address, uint16_t& port)
+    {
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &socketAddress.sin_addr) != 1)
+        {
+            throw std::runtime_error("Invalid IPv4 address: " + address);
+        }
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            fail("socket");
+        }
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        socklen_t length = sizeof(socketAddress);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&socketAddress), length) < 0
+            || getsockname(fd, reinterpret_cast<sockaddr*>(&socketAddress), &length) < 0)
+        {
+            close(fd);
+            fail("bind " + address + ":" + std::to_string(port));
+        }
+        if (listen(fd, SOMAXCONN) < 0)
+        {
+            close(fd);
+            fail("listen");
+        }
+        port = ntohs(socketAddress.sin_port);
+        return fd;
+    }
+
+    /**
+     * @brief Listens on the Unix socket at `path`, replacing a file left there by an earlier run.
+     */
+    inline int listenUnix(const std::string& path)
+    {
+        sockaddr_un socketAddress{};
+        if (path.size() >= sizeof(socketAddress.sun_path))
+        {
+            throw std::runtime_error("Unix socket path too long: " + path);
+        }
+        socketAddress.sun_family = AF_UNIX;
+        std::memcpy(socketAddress.sun_path, path.c_str(), path.size() + 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            fail("socket");
+        }
+        unlink(path.c_str());
+        if (bind(fd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0)
+        {
+            close(fd);
+            fail("bind " + path);
+        }
+        if (listen(fd, SOMAXCONN) < 0)
+        {
+            close(fd);
+            fail("listen");
+        }
+        return fd;
+    }
+
+    /**
+     * @brief Opens a blocking connection to `address`:`port` with Nagle off; -1 if it is refused.
+     */
+    inline int connectTcp(const std::string& address, uint16_t port)
+    {
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &socketAddress.sin_addr) != 1)
+        {
+            throw std::runtime_error("Invalid IPv4 address: " + address);
+        }
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0)
+        {
+            close(fd);
+            return -1;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        return fd;
+    }
+
+    /**
+     * @brief Opens a blocking connection to the Unix socket at `path`; -1 if nobody listens there.
+     */
+    inline int connectUnix(const std::string& path)
+    {
+        sockaddr_un socketAddress{};
+        if (path.size() >= sizeof(socketAddress.sun_path))
+        {
+            throw std::runtime_error("Unix socket path too long: " + path);
+        }
+        socketAddress.sun_family = AF_UNIX;
+        std::memcpy(socketAddress.sun_path, path.c_str(), path.size() + 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0)
+        {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    /**
+     * @brief Writes all of `text` to a blocking socket; false once the peer is gone.
+     */
+    inline bool sendAll(int fd, const std::string& text)
+    {
+        size_t sent = 0;
+        while (sent < text.size())
+        {
+            ssize_t count = send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                return false;
+            }
+            sent += count;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Splits the next complete line off `buffer`, without its "\n" or "\r\n".
+     */
+    inline bool takeLine(std::string& buffer, size_t& start, std::string& line)
+    {
+        size_t end = buffer.find('\n', start);
+        if (end == std::string::npos)
+        {
+            return false;
+        }
+        line.assign(buffer, start, end - start);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        start = end + 1;
+        return true;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread.
+ *
+ * Slots are allocated once and reused in place: the producer fills the slot
+ * returned by claim() and makes it visible with publish(), and the consumer
+ * reads front() and hands the slot back with pop(). Nothing is copied or
+ * allocated per element, and neither side ever takes a lock.
+ */
+template<typename T> class SpscQueue {
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+    // producer and consumer indices on separate cache lines so they do not bounce
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+    public:
+    /**
+     * @brief Creates a queue holding at least `capacity` elements (rounded up to a power of two).
+     */
+    explicit SpscQueue(size_t capacity)
+        : head(0), tail(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+        slots.reset(new T[size]);
+        mask = size - 1;
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Producer: returns the next free slot, or nullptr if the queue is full.
+     */
+    T* claim()
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) > mask)
+        {
+            return nullptr;
+        }
+        return &slots[position & mask];
+    }
+    /**
+     * @brief Producer: makes the slot from claim() visible to the consumer.
+     */
+    void publish() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    /**
+     * @brief Consumer: returns the oldest element, or nullptr if the queue is empty.
+     */
+    T* front()
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &slots[position & mask];
+    }
+    /**
+     * @brief Consumer: releases the element from front() back to the producer.
+     */
+    void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    size_t capacity() const { return mask + 1; }
+};
@@ -0,0 +1,130 @@
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "chess.hpp"
+#include "search/analysis_cache.hpp"
+#include "search/search.hpp"
+
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(analysis_cache_stores_and_probes) {
+    std::string path = tempPath("chess_analysis_store.cache");
+    std::filesystem::remove(path);
+    {
+        Search::AnalysisCache cache(path, 1 << 16);
+        ASSERT_EQ(size_t(4096), cache.capacity());
+        Search::CachedResult result;
+        ASSERT_FALSE(cache.probe(12345, result));
+
+        cache.store(12345, {7, -250, {12, 28, Board::EMPTY}, Search::LOWER});
+        cache.store(999, {3, Search::MATE_SCORE - 5, {52, 60, Board::BLACK_QUEEN}, Search::EXACT});
+        ASSERT_TRUE(cache.probe(12345, result));
+        ASSERT_EQ(7, result.depth);
+        ASSERT_EQ(-250, result.score);
+        ASSERT_EQ(12, result.move.from);
+        ASSERT_EQ(28, result.move.to);
+        ASSERT_EQ(Board::EMPTY, result.move.promotion);
+        ASSERT_EQ(Search::LOWER, result.bound);
+        ASSERT_TRUE(cache.probe(999, result));
+        ASSERT_EQ(Search::MATE_SCORE - 5, result.score);
+        ASSERT_EQ(Board::BLACK_QUEEN, result.move.promotion);
+
+        // a shallower result does not replace a deeper one for the same position
+        cache.store(12345, {2, 40, {1, 18, Board::EMPTY}, Search::EXACT});
+        ASSERT_TRUE(cache.probe(12345, result));
+        ASSERT_EQ(7, result.depth);
+        cache.store(12345, {9, 40, {-1, -1}, Search::EXACT});
+        ASSERT_TRUE(cache.probe(12345, result));
+        ASSERT_EQ(9, result.depth);
+        ASSERT_EQ(-1, result.move.from);
+    }
+    {
+        // results survive reopening, and the existing size wins over the requested one
+        Search::AnalysisCache cache(path, 1 << 20);
+        ASSERT_EQ(size_t(4096), cache.capacity());
+        Search::CachedResult result;
+        ASSERT_TRUE(cache.probe(12345, result));
+        ASSERT_EQ(9, result.depth);
+        ASSERT_TRUE(cache.probe(999, result));
+        ASSERT_EQ(3, result.depth);
+    }
+    std::filesystem::remove(path);
+}
+TEST(analysis_cache_rejects_other_files) {
+    std::string path = tempPath("chess_analysis_bogus.cache");
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a cache, just some text that is long enough to hold a header............";
+    }
+    ASSERT_THROWS(std::runtime_error, [&path]() {
+        Search::AnalysisCache cache(path);
+    });
+    std::filesystem::remove(path);
+}
+TEST(analysis_cache_shares_between_mappings) {
+    std::string path = tempPath("chess_analysis_shared.cache");
+    std::filesystem::remove(path);
+    // two mappings of one file stand in for two processes
+    Search::AnalysisCache writer(path, 1 << 12);
+    Search::AnalysisCache reader(path);
+    constexpr uint64_t KEYS = 20000;
+    bool consistent = true;
+    std::thread writing([&writer]() {
+        for (uint64_t key = 1; key <= KEYS; ++key)
+        {
+            int value = static_cast<int>(key % 1000);
+            writer.store(key * 0x9E3779B97F4A7C15ULL, {value % 64, value, {value % 64, (value + 1) % 64}, Search::EXACT});
+        }
+    });
+    std::thread reading([&reader, &consistent]() {
+        for (int pass = 0; pass < 20; ++pass)
+        {
+            for (uint64_t key = 1; key <= KEYS; ++key)
+            {
+                Search::CachedResult result;
+                int value = static_cast<int>(key % 1000);
+                // whatever is found must be exactly what was stored under that key
+                if (reader.probe(key * 0x9E3779B97F4A7C15ULL, result)
+                    && (result.score != value || result.depth != value % 64 || result.move.to != (value + 1) % 64))
+                {
+                    consistent = false;
+                }
+            }
+        }
+    });
+    writing.join();
+    reading.join();
+    ASSERT_TRUE(consistent);
+    Search::CachedResult result;
+    ASSERT_TRUE(reader.probe(KEYS * 0x9E3779B97F4A7C15ULL, result));
+    std::filesystem::remove(path);
+}
+TEST(search_answers_from_analysis_cache) {
+    std::string path = tempPath("chess_analysis_search.cache");
+    std::filesystem::remove(path);
+    Board board("4k3/8/8/3q4/8/8/3R4/4K3 w - -");
+    Search::Result searched;
+    {
+        Search::AnalysisCache cache(path, 1 << 16);
+        Search::Searcher searcher;
+        searcher.setCache(&cache);
+        searched = searcher.search(board, {3, 0});
+        ASSERT_GT(searched.nodes, 0u);
+    }
+    Search::AnalysisCache cache(path);
+    Search::Searcher searcher;
+    searcher.setCache(&cache);
+    Search::Result cached = searcher.search(board, {2, 0});
+    ASSERT_EQ(0u, cached.nodes);
+    ASSERT_EQ(3, cached.depth);
+    ASSERT_EQ(searched.move.to, cached.move.to);
+    ASSERT_EQ(searched.score, cached.score);
+    // deeper than the cache holds: search again and store the deeper result
+    Search::Result deeper = searcher.search(board, {4, 0});
+    ASSERT_GT(deeper.nodes, 0u);
+    ASSERT_EQ(0u, searcher.search(board, {4, 0}).nodes);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,65 @@
+#include "test.h"
+#include "chess.hpp"
+#include "board/attacks.hpp"
+
+static int sq(std::string position) {
+    return Board::getSquareForPosition(position);
+}
+static uint64_t bit(std::string position) {
+    return 1ULL << sq(position);
+}
+
+TEST(attackersTo_initial_board) {
+    Board board;
+    // f3 is covered by the g1 knight and the e2 and g2 pawns
+    ASSERT_EQ(bit("g1") | bit("e2") | bit("g2"), board.attackersTo(sq("f3"), board.getBitmaskForBoard()));
+    ASSERT_TRUE(board.isSquareAttacked(sq("f6"), Board::BLACK));
+    ASSERT_FALSE(board.isSquareAttacked(sq("e4"), Board::WHITE));
+}
+TEST(attackersTo_custom_occupancy) {
+    Board board("4k3/8/8/4p3/8/8/4R3/4K3 w - -");
+    uint64_t occupancy = board.getBitmaskForBoard();
+    ASSERT_EQ(0ULL, board.attackersTo(sq("e8"), occupancy));
+    // removing the e5 pawn from the occupancy uncovers the rook
+    ASSERT_EQ(bit("e2"), board.attackersTo(sq("e8"), occupancy ^ bit("e5")));
+}
+TEST(inCheck_initial_board) {
+    Board board;
+    ASSERT_FALSE(board.inCheck());
+    ASSERT_EQ(0ULL, board.checkers());
+}
+TEST(checkers_double_check) {
+    Board board("4k3/8/3N4/8/8/8/8/4RK2 b - -");
+    ASSERT_TRUE(board.inCheck());
+    ASSERT_EQ(bit("d6") | bit("e1"), board.checkers());
+}
+TEST(checkers_only_side_to_move) {
+    // black gives check, but it is black's turn so black is not in check
+    Board board("4k3/8/8/8/8/8/8/r3K3 b - -");
+    ASSERT_FALSE(board.inCheck());
+    ASSERT_TRUE(board.isSquareAttacked(sq("e1"), Board::BLACK));
+}
+TEST(pinned_pieces) {
+    Board board("4r1k1/8/8/b7/8/2N5/4B3/4K3 w - -");
+    // e2 is pinned by the rook and c3 by the bishop on a5
+    ASSERT_EQ(bit("e2") | bit("c3"), board.pinned(Board::WHITE));
+    ASSERT_EQ(0ULL, board.pinned(Board::BLACK));
+}
+TEST(pinned_requires_single_blocker) {
+    // two pieces between the rook and the king means neither is pinned
+    Board board("4r1k1/8/8/8/4N3/8/4B3/4K3 w - -");
+    ASSERT_EQ(0ULL, board.pinned(Board::WHITE));
+    // an enemy piece in the way is not pinned to our king
+    Board blocked("4r1k1/8/8/8/4n3/8/8/4K3 w - -");
+    ASSERT_EQ(0ULL, blocked.pinned(Board::WHITE));
+}
+TEST(attack_tables_constant_expression) {
+    // the tables are generated at compile time, so these are checked by the compiler
+    static_assert(Attacks::knight(0) == ((1ULL << 10) | (1ULL << 17)), "knight on a1");
+    static_assert(Attacks::king(63) == ((1ULL << 62) | (1ULL << 55) | (1ULL << 54)), "king on h8");
+    static_assert(Attacks::pawn(true, 12) == ((1ULL << 19) | (1ULL << 21)), "white pawn on e2");
+    static_assert(Attacks::between[0][63] == 0x0040201008040200ULL, "a1-h8 diagonal interior");
+    static_assert(Attacks::line[0][7] == 0xFFULL && Attacks::line[0][10] == 0, "first rank, no line a1-c2");
+    static_assert(Attacks::rook(0, 1ULL << 16) == ((1ULL << 8) | (1ULL << 16) | 0xFEULL), "rook blocked on a3");
+    ASSERT_EQ(bit("b1") | bit("c1") | bit("d1"), Attacks::between[sq("a1")][sq("e1")]);
+}
@@ -0,0 +1,67 @@
+#include "test.h"
+#include "chess.hpp"
+#include "board/batch.hpp"
+#include "positions.h"
+
+// en passant that would expose the king along the rank, and a king-less side
+static const char* EDGE_POSITIONS[] = {
+    "8/8/8/K2pP2r/8/8/8/7k w - d6",
+    "8/8/8/8/3Pp3/8/8/4k3 b - d3",
+};
+
+TEST(batch_lanes) {
+    int lanes = Batch::lanes();
+    ASSERT_TRUE(lanes == 1 || lanes == 4 || lanes == 8);
+}
+TEST(batch_countMoves_matches_countMoves) {
+    // every position two plies deep covers castling, promotions, pins and checks for both sides
+    std::vector<Board> boards;
+    auto collect = [&](Board& board) { boards.push_back(board); };
+    for (const char* fen : POSITIONS) {
+        Board board(fen);
+        forEachNode(board, 2, collect);
+    }
+    for (const char* fen : EDGE_POSITIONS) {
+        Board board(fen);
+        forEachNode(board, 2, collect);
+    }
+    std::vector<int> counts(boards.size(), -1);
+    Batch::countMoves(boards.data(), boards.size(), counts.data());
+    int mismatches = 0;
+    for (size_t i = 0; i < boards.size(); ++i) {
+        if (counts[i] != boards[i].countMoves()) {
+            mismatches++;
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+}
+TEST(batch_countMoves_checks_and_pins) {
+    std::vector<Board> boards = {
+        Board("4k3/8/8/8/1b6/8/4r3/4K3 w - -"),   // double check
+        Board("4k3/8/8/8/8/8/4r3/R3K2R w KQ -"),  // no castling out of check
+        Board("4k3/4r3/8/8/8/8/4R3/4K3 w - -"),   // rook pinned along the file
+        Board("4k3/8/8/8/8/2b5/3P4/4K3 w - -"),   // pawn pinned on a diagonal can only capture the pinner
+        Board("4k3/8/8/8/8/8/8/R3K1rR w KQ -"),   // rook on g1 blocks kingside castling
+        Board("r3k3/1P6/8/8/8/8/8/4K3 w q -"),    // capture and push promotions
+    };
+    int counts[6];
+    Batch::countMoves(boards.data(), boards.size(), counts);
+    for (size_t i = 0; i < boards.size(); ++i) {
+        ASSERT_EQ(boards[i].countMoves(), counts[i]);
+    }
+}
+TEST(batch_perft) {
+    // node counts from https://www.chessprogramming.org/Perft_Results
+    ASSERT_EQ(197281ULL, Batch::perft(Board(), 4));
+    ASSERT_EQ(97862ULL, Batch::perft(Board(POSITIONS[1]), 3));
+    ASSERT_EQ(43238ULL, Batch::perft(Board(POSITIONS[2]), 4));
+    ASSERT_EQ(1ULL, Batch::perft(Board(), 0));
+
+    // several roots share blocks but keep their own totals
+    std::vector<Board> roots = {Board(POSITIONS[3]), Board(POSITIONS[4]), Board(POSITIONS[3])};
+    uint64_t nodes[3];
+    Batch::perft(roots.data(), roots.size(), 3, nodes);
+    ASSERT_EQ(9467ULL, nodes[0]);
+    ASSERT_EQ(62379ULL, nodes[1]);
+    ASSERT_EQ(9467ULL, nodes[2]);
+}
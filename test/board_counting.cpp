@@ -0,0 +1,61 @@
+#include "test.h"
+#include "chess.hpp"
+#include "positions.h"
+
+// compares the counts with the generated moves
+static void checkCounts(Board& board) {
+    Board::MoveList moves = board.generateMoves();
+    ASSERT_EQ(moves.size(), board.countMoves());
+    ASSERT_EQ(moves.size() > 0, board.hasLegalMoves());
+    int perSquare = 0;
+    for (int square = 0; square < 64; ++square) {
+        perSquare += board.countMovesFrom(square);
+    }
+    ASSERT_EQ(moves.size(), perSquare);
+}
+
+TEST(countMoves_matches_generateMoves) {
+    for (const char* fen : POSITIONS) {
+        Board board(fen);
+        forEachNode(board, 2, checkCounts);
+    }
+}
+TEST(countMoves_checks_and_pins) {
+    // double check leaves only king moves
+    Board doubleCheck("4k3/8/8/8/1b6/8/4r3/4K3 w - -");
+    ASSERT_EQ(doubleCheck.generateMoves().size(), doubleCheck.countMoves());
+    ASSERT_EQ(0, doubleCheck.countMovesFrom(Board::getSquareForPosition("e2")));
+    // the en passant capture would expose the king along the rank
+    Board enPassant("8/8/8/K2pP2r/8/8/8/7k w - d6");
+    ASSERT_EQ(enPassant.generateMoves().size(), enPassant.countMoves());
+    ASSERT_EQ(1, enPassant.countMovesFrom(Board::getSquareForPosition("e5")));
+}
+TEST(checkmate_and_stalemate) {
+    Board mated("R5k1/5ppp/8/8/8/8/8/6K1 b - -");
+    ASSERT_TRUE(mated.isCheckmate());
+    ASSERT_FALSE(mated.isStalemate());
+    Board stalemate("k7/8/1Q6/8/8/8/8/K7 b - -");
+    ASSERT_TRUE(stalemate.isStalemate());
+    ASSERT_FALSE(stalemate.isCheckmate());
+    ASSERT_FALSE(Board().isCheckmate() || Board().isStalemate());
+}
+TEST(mobility_and_attacked_squares) {
+    Board board;
+    ASSERT_EQ(2, board.mobility(Board::getSquareForPosition("g1")));
+    ASSERT_EQ(0, board.mobility(Board::getSquareForPosition("c1")));
+    ASSERT_EQ(2, board.mobility(Board::getSquareForPosition("e2")));
+    ASSERT_EQ(2, board.mobility(Board::getSquareForPosition("e7")));
+    ASSERT_EQ(0, board.mobility(Board::getSquareForPosition("e4")));
+    // all of ranks 2 and 3 plus b1-g1
+    ASSERT_EQ(22, board.countAttackedSquares(Board::WHITE));
+
+    for (const char* fen : POSITIONS) {
+        Board position(fen);
+        for (Board::Color color : {Board::WHITE, Board::BLACK}) {
+            uint64_t attacked = position.attackedSquares(color);
+            for (int square = 0; square < 64; ++square) {
+                ASSERT_EQ(position.isSquareAttacked(square, color), ((attacked >> square) & 1) != 0);
+            }
+        }
+    }
+}
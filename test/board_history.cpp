@@ -0,0 +1,130 @@
+#include "test.h"
+#include "chess.hpp"
+
+static void play(Board& board, std::initializer_list<const char*> moves) {
+    for (const char* move : moves) {
+        board.move(move);
+    }
+}
+static void play(Board& board, GameHistory& history, std::initializer_list<const char*> moves) {
+    for (const char* move : moves) {
+        history.push(board);
+        board.move(move);
+    }
+}
+
+TEST(fen_clock_fields) {
+    Board board("4k3/8/8/8/8/8/8/4K2R w K - 37 61");
+    ASSERT_EQ(37, board.getHalfmoveClock());
+    ASSERT_EQ(61, board.getFullmoveNumber());
+    Board noClocks("4k3/8/8/8/8/8/8/4K2R w K -");
+    ASSERT_EQ(0, noClocks.getHalfmoveClock());
+    ASSERT_EQ(1, noClocks.getFullmoveNumber());
+}
+TEST(clocks_follow_moves) {
+    Board board;
+    play(board, {"g1 f3", "g8 f6"});
+    ASSERT_EQ(2, board.getHalfmoveClock());
+    ASSERT_EQ(2, board.getFullmoveNumber());
+    Board::Move push = Board::parseMove("e2 e4");
+    Board::UndoInfo undo = board.makeMove(push);
+    ASSERT_EQ(0, board.getHalfmoveClock());
+    board.unmakeMove(push, undo);
+    ASSERT_EQ(2, board.getHalfmoveClock());
+    ASSERT_EQ(2, board.getFullmoveNumber());
+}
+TEST(hash_matches_recomputed_position) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    uint64_t start = board.getHash();
+    // castling, a double push creating an en passant square, then the capture
+    play(board, {"e1 g1", "c7 c5", "d5 c6", "h3 g2", "g1 g2"});
+    ASSERT_EQ(Board(board.generateFEN()).getHash(), board.getHash());
+    ASSERT_TRUE(board.getHash() != start);
+
+    Board sideToMove("4k3/8/8/8/8/8/8/4K3 w - -");
+    uint64_t white = sideToMove.getHash();
+    sideToMove.setTurn(false);
+    ASSERT_EQ(Board("4k3/8/8/8/8/8/8/4K3 b - -").getHash(), sideToMove.getHash());
+    ASSERT_TRUE(white != sideToMove.getHash());
+}
+TEST(unmake_restores_hash) {
+    Board board;
+    play(board, {"g1 f3", "g8 f6", "f3 g1"});
+    uint64_t before = board.getHash();
+    for (const Board::Move& move : board.generateMoves()) {
+        Board::UndoInfo undo = board.makeMove(move);
+        board.unmakeMove(move, undo);
+        ASSERT_EQ(before, board.getHash());
+    }
+}
+TEST(repetition_by_knight_shuffle) {
+    Board board;
+    GameHistory history;
+    ASSERT_FALSE(history.isRepetition(board));
+    play(board, history, {"g1 f3", "g8 f6", "f3 g1"});
+    ASSERT_FALSE(history.isRepetition(board));
+    play(board, history, {"f6 g8"});
+    ASSERT_TRUE(history.isRepetition(board));
+    ASSERT_EQ(1, history.repetitionCount(board));
+    ASSERT_FALSE(history.isThreefoldRepetition(board));
+    play(board, history, {"g1 f3", "g8 f6", "f3 g1", "f6 g8"});
+    ASSERT_EQ(2, history.repetitionCount(board));
+    ASSERT_TRUE(history.isThreefoldRepetition(board));
+    // a fresh history knows nothing of the earlier positions
+    ASSERT_FALSE(GameHistory().isRepetition(board));
+}
+TEST(repetition_stops_at_irreversible_move) {
+    Board board;
+    GameHistory history;
+    play(board, history, {"g1 f3", "g8 f6", "f3 g1", "f6 g8", "e2 e4"});
+    // the positions before e4 are gone for good; only those after it can repeat
+    play(board, history, {"g8 f6", "g1 f3", "f6 g8", "f3 g1", "g8 f6"});
+    ASSERT_EQ(1, history.repetitionCount(board));
+}
+TEST(repetition_follows_push_and_pop) {
+    // many plies made and taken back like a search
+    Board board("4k3/8/8/8/8/8/8/R3K3 w - -");
+    GameHistory history;
+    std::vector<std::pair<Board::Move, Board::UndoInfo>> line;
+    const char* shuffle[] = {"a1 a2", "e8 d8", "a2 a1", "d8 e8"};
+    for (int i = 0; i < 200; ++i) {
+        Board::Move move = Board::parseMove(shuffle[i % 4]);
+        history.push(board);
+        line.push_back({move, board.makeMove(move)});
+    }
+    ASSERT_TRUE(history.isRepetition(board));
+    while (line.size() > 2) {
+        board.unmakeMove(line.back().first, line.back().second);
+        history.pop();
+        line.pop_back();
+    }
+    ASSERT_EQ(2u, history.size());
+    ASSERT_FALSE(history.isRepetition(board));
+    play(board, history, {"a2 a1", "d8 e8"});
+    ASSERT_TRUE(history.isRepetition(board));
+}
+TEST(repetition_past_history_capacity) {
+    Board board("4k3/8/8/8/8/8/P7/R3K3 w - -");
+    GameHistory history;
+    const char* shuffle[] = {"a1 b1", "e8 d8", "b1 a1", "d8 e8"};
+    for (int i = 0; i < 600; ++i) {
+        history.play(board, Board::parseMove(shuffle[i % 4]));
+    }
+    // the ring keeps the last CAPACITY positions, one in four of them this one
+    ASSERT_EQ(GameHistory::CAPACITY, history.size());
+    ASSERT_EQ(static_cast<int>(GameHistory::CAPACITY / 4), history.repetitionCount(board));
+    // a pawn move makes every earlier position unrepeatable
+    history.play(board, Board::parseMove("a2 a3"));
+    ASSERT_EQ(0u, history.size());
+    play(board, history, {"e8 d8", "a1 b1", "d8 e8", "b1 a1"});
+    ASSERT_EQ(1, history.repetitionCount(board));
+}
+TEST(fifty_move_rule) {
+    Board board("4k3/8/8/8/8/8/8/R3K3 w - - 99 80");
+    ASSERT_FALSE(board.isFiftyMoveRule());
+    board.move("a1 a2");
+    ASSERT_TRUE(board.isFiftyMoveRule());
+    Board reset("4k3/8/8/8/8/8/P7/R3K3 w - - 99 80");
+    reset.move("a2 a3");
+    ASSERT_FALSE(reset.isFiftyMoveRule());
+}
@@ -70,4 +70,33 @@ TEST(fen_notation_2_Nf3) {
     ASSERT_EQ(Board::Piece::BLACK_PAWN, board.getPieceAtPosition("c5"));
     ASSERT_EQ(Board::Piece::EMPTY, board.getPieceAtPosition("g1"));
     ASSERT_EQ(Board::Piece::WHITE_KNIGHT, board.getPieceAtPosition("f3"));
-}
\ No newline at end of file
+}
+TEST(fromFEN_constant_expression) {
+    // built by the compiler; a parser regression fails the build rather than the test
+    constexpr Board initial;
+    constexpr Board kiwipete = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    constexpr Board enPassant = Board::fromFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6");
+    static_assert(initial.getBitmaskForBoard() == 0xFFFF00000000FFFFULL, "start position occupancy");
+    static_assert(Board::fromFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -").getBitmaskForBoard()
+                  == initial.getBitmaskForBoard(), "start FEN matches Board()");
+    static_assert(kiwipete.getPieceAtSquare(Board::getSquareForPosition("e2")) == Board::WHITE_BISHOP, "kiwipete e2");
+    static_assert(kiwipete.getCastlingRights() == 0b1111 && kiwipete.getTurn(), "kiwipete rights");
+    static_assert(enPassant.getEnPassantSquare() == Board::getSquareForPosition("d6"), "en passant square");
+
+    // the runtime constructor goes through the same parser
+    Board runtime("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    ASSERT_EQ(runtime.generateFEN(), Board(kiwipete).generateFEN());
+    ASSERT_EQ(std::string("4k3/8/8/3pP3/8/8/8/4K3 w - d6"), Board(enPassant).generateFEN());
+}
+TEST(fromFEN_rejects_out_of_bounds) {
+    // a ninth rank, an overlong rank and unknown letters would put pieces off the board
+    ASSERT_THROWS(std::invalid_argument, [] { Board::fromFEN("4k3/8/8/8/8/8/8/4K3/q7 w - -"); });
+    ASSERT_THROWS(std::invalid_argument, [] { Board::fromFEN("4k3/8/8/8/8/8/8/4KPPPPPPPP w - -"); });
+    ASSERT_THROWS(std::invalid_argument, [] { Board::fromFEN("4k3/8/8/8/8/8/8/4K4 w - -"); });
+    ASSERT_THROWS(std::invalid_argument, [] { Board::fromFEN("4k3/8/8/8/8/8/8/4X3 w - -"); });
+    // en passant targets only exist on the third and sixth ranks
+    ASSERT_THROWS(std::invalid_argument, [] { Board::fromFEN("4k3/8/8/8/8/8/P7/4K3 w - a1"); });
+    ASSERT_THROWS(std::invalid_argument, [] { Board::fromFEN("4k3/8/8/8/8/8/P7/4K3 w - a"); });
+    ASSERT_THROWS(std::invalid_argument, [] { Board("4k3/8/8/8/8/8/P7/4K3 b - a9"); });
+    ASSERT_EQ(Board::getSquareForPosition("a3"), Board::fromFEN("4k3/8/8/8/P7/8/8/4K3 b - a3").getEnPassantSquare());
+}
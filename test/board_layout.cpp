@@ -0,0 +1,70 @@
+#include "test.h"
+#include "chess.hpp"
+
+// Plays the same random moves on both layouts and checks that every query agrees,
+// whichever layout Board itself was built with.
+TEST(board_layouts_agree) {
+    BoardLayout::PerPiece perPiece{};
+    BoardLayout::Compact compact{};
+    perPiece.clear();
+    compact.clear();
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    for (int piece = 0; piece < 12; ++piece) {
+        uint64_t bitboard = board.getBitmaskForPiece(static_cast<Board::Piece>(piece));
+        perPiece.toggle(piece, bitboard);
+        compact.toggle(piece, bitboard);
+    }
+    uint64_t seed = 12345;
+    int mismatches = 0;
+    for (int ply = 0; ply < 400; ++ply) {
+        for (int piece = 0; piece < 12; ++piece) {
+            mismatches += perPiece.piece(piece) != compact.piece(piece);
+            mismatches += perPiece.piece(piece) != board.getBitmaskForPiece(static_cast<Board::Piece>(piece));
+        }
+        for (int type = 0; type < 6; ++type) {
+            mismatches += perPiece.pieceType(type) != compact.pieceType(type);
+        }
+        mismatches += perPiece.color(true) != compact.color(true) || perPiece.color(false) != compact.color(false);
+        mismatches += perPiece.occupancy() != compact.occupancy();
+        mismatches += perPiece.occupancy() != board.getBitmaskForBoard();
+        for (int square = 0; square < 64; ++square) {
+            mismatches += perPiece.pieceAt(square) != compact.pieceAt(square);
+            mismatches += perPiece.pieceAt(square) != board.getPieceAtSquare(square);
+        }
+
+        Board::MoveList moves = board.generateMoves();
+        if (moves.size() == 0 || board.isFiftyMoveRule()) {
+            board = Board();
+        } else {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            board.makeMove(moves[static_cast<int>((seed >> 33) % moves.size())]);
+        }
+        // mirror the new position with the smallest toggles that get there
+        for (int piece = 0; piece < 12; ++piece) {
+            uint64_t target = board.getBitmaskForPiece(static_cast<Board::Piece>(piece));
+            uint64_t removed = perPiece.piece(piece) & ~target;
+            perPiece.toggle(piece, removed);
+            compact.toggle(piece, removed);
+        }
+        for (int piece = 0; piece < 12; ++piece) {
+            uint64_t added = board.getBitmaskForPiece(static_cast<Board::Piece>(piece)) & ~perPiece.piece(piece);
+            perPiece.toggle(piece, added);
+            compact.toggle(piece, added);
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+}
+TEST(board_layout_sizes) {
+    ASSERT_EQ(96u, sizeof(BoardLayout::PerPiece));
+    ASSERT_EQ(72u, sizeof(BoardLayout::Compact));
+    // the rest of a Board is the same in both builds, so the compact one is 24 bytes smaller
+    ASSERT_EQ(64u, sizeof(Board) - sizeof(BoardLayout::Selected));
+#ifdef CHESS_COMPACT_BOARD
+    ASSERT_EQ(136u, sizeof(Board));
+#else
+    ASSERT_EQ(160u, sizeof(Board));
+#endif
+    Board empty("8/8/8/8/8/8/8/8 w - -");
+    ASSERT_EQ(0u, empty.getBitmaskForBoard());
+    ASSERT_EQ(Board::EMPTY, empty.getPieceAtSquare(0));
+}
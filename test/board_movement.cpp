@@ -4,10 +4,58 @@
 // movement tests. Tests utilize getMovesForPieceAtPosition, which will 
 // implicitly test piece specific movement functions as well
 // === PAWN MOVEMENT ===
-TEST_XFAIL(pawn_initial_double_move) {
+TEST(pawn_initial_double_move) {
     Board board;
     uint64_t moves = board.getMovesForPieceAtPosition("e2");
     // e3 and e4 should be set
     uint64_t expectedMoves = (1ULL << 20) | (1ULL << 28); // e3 is bit 20, e4 is bit 28
     ASSERT_EQ(expectedMoves, moves);
 }
+TEST(knight_initial_moves) {
+    Board board;
+    uint64_t expectedMoves = (1ULL << 16) | (1ULL << 18); // a3 and c3
+    ASSERT_EQ(expectedMoves, board.getMovesForPieceAtPosition("b1"));
+}
+TEST(check_evasion_by_capture) {
+    // the rook on e1 checks the king, the bishop's only move is to take it
+    Board board("4k3/8/8/8/8/8/3B4/2K1r3 w - -");
+    ASSERT_EQ(1ULL << 4, board.getMovesForPieceAtPosition("d2"));
+}
+TEST(pinned_bishop_stays_on_pin_line) {
+    Board board("4k3/8/8/b7/8/8/3B4/4K3 w - -");
+    // only along the a5-e1 diagonal: c3, b4 and capturing on a5
+    uint64_t expectedMoves = (1ULL << 18) | (1ULL << 25) | (1ULL << 32);
+    ASSERT_EQ(expectedMoves, board.getMovesForPieceAtPosition("d2"));
+}
+TEST(castling_both_sides) {
+    Board board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq -");
+    uint64_t moves = board.getMovesForPieceAtPosition("e1");
+    ASSERT_TRUE(moves & (1ULL << 6));
+    ASSERT_TRUE(moves & (1ULL << 2));
+    // a rook on f8 covers f1, so kingside castling is off
+    Board attacked("r3kr2/8/8/8/8/8/8/R3K2R w KQq -");
+    ASSERT_FALSE(attacked.getMovesForPieceAtPosition("e1") & (1ULL << 6));
+}
+TEST(move_updates_board) {
+    Board board;
+    board.move("e2 e4");
+    ASSERT_EQ(std::string("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3"), board.generateFEN());
+    board.move("g8 f6");
+    ASSERT_EQ(Board::Piece::BLACK_KNIGHT, board.getPieceAtPosition("f6"));
+    ASSERT_TRUE(board.getTurn());
+}
+TEST(move_throws_on_illegal_move) {
+    Board board;
+    ASSERT_THROWS(std::invalid_argument, [&board]() {
+        board.move("e2 e5");
+    });
+    ASSERT_THROWS(std::invalid_argument, [&board]() {
+        board.move("e7 e5");
+    });
+}
+TEST(en_passant_capture) {
+    Board board("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6");
+    board.move("e5 d6");
+    ASSERT_EQ(Board::Piece::EMPTY, board.getPieceAtPosition("d5"));
+    ASSERT_EQ(Board::Piece::WHITE_PAWN, board.getPieceAtPosition("d6"));
+}
@@ -0,0 +1,59 @@
+#include "test.h"
+#include "chess.hpp"
+
+// SAN spec: docs/algebraic_notation.md
+static std::string san(Board& board, std::string move) {
+    return board.toSAN(Board::parseMove(move));
+}
+
+TEST(parseSAN_pawn_and_piece_moves) {
+    Board board;
+    Board::Move move = board.parseSAN("e4");
+    ASSERT_EQ(Board::getSquareForPosition("e2"), move.from);
+    ASSERT_EQ(Board::getSquareForPosition("e4"), move.to);
+    move = board.parseSAN("Nf3");
+    ASSERT_EQ(Board::getSquareForPosition("g1"), move.from);
+}
+TEST(parseSAN_disambiguation) {
+    Board board("4k3/8/8/8/8/8/4K3/R6R w - -");
+    ASSERT_EQ(Board::getSquareForPosition("a1"), board.parseSAN("Rad1").from);
+    ASSERT_THROWS(std::invalid_argument, [&board]() {
+        board.parseSAN("Rd1");
+    });
+}
+TEST(parseSAN_promotion_and_castling) {
+    Board board("4k3/1P6/8/8/8/8/8/R3K2R w KQ -");
+    ASSERT_EQ(Board::Piece::WHITE_QUEEN, board.parseSAN("b8=Q+").promotion);
+    ASSERT_EQ(Board::Piece::WHITE_KNIGHT, board.parseSAN("b8N").promotion);
+    ASSERT_EQ(Board::getSquareForPosition("g1"), board.parseSAN("O-O").to);
+    ASSERT_EQ(Board::getSquareForPosition("c1"), board.parseSAN("O-O-O").to);
+}
+TEST(parseSAN_illegal) {
+    Board board;
+    ASSERT_THROWS(std::invalid_argument, [&board]() {
+        board.parseSAN("e5");
+    });
+    ASSERT_THROWS(std::invalid_argument, [&board]() {
+        board.parseSAN("Qxf7#");
+    });
+}
+TEST(toSAN_basic_moves) {
+    Board board;
+    ASSERT_EQ(std::string("e4"), san(board, "e2 e4"));
+    ASSERT_EQ(std::string("Nf3"), san(board, "g1 f3"));
+}
+TEST(toSAN_check_and_mate_suffixes) {
+    // fool's mate: 1. f3 e5 2. g4 Qh4#
+    Board board("rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq g3");
+    ASSERT_EQ(std::string("Qh4#"), san(board, "d8 h4"));
+    Board check("4k3/8/8/8/8/8/8/R3K3 w - -");
+    ASSERT_EQ(std::string("Ra8+"), san(check, "a1 a8"));
+}
+TEST(toSAN_disambiguation_and_captures) {
+    Board board("4k3/8/8/8/8/8/4K3/R6R w - -");
+    ASSERT_EQ(std::string("Rad1"), san(board, "a1 d1"));
+    Board castling("4k3/8/8/8/8/8/8/R3K2R w KQ -");
+    ASSERT_EQ(std::string("O-O"), san(castling, "e1 g1"));
+    Board pawns("4k3/8/8/3p4/4P3/8/8/4K3 w - -");
+    ASSERT_EQ(std::string("exd5"), san(pawns, "e4 d5"));
+}
@@ -0,0 +1,42 @@
+#include "test.h"
+#include "chess.hpp"
+
+// perft node counts from https://www.chessprogramming.org/Perft_Results
+TEST(perft_initial_position) {
+    Board board;
+    ASSERT_EQ(20ULL, board.perft(1));
+    ASSERT_EQ(400ULL, board.perft(2));
+    ASSERT_EQ(8902ULL, board.perft(3));
+    ASSERT_EQ(197281ULL, board.perft(4));
+}
+TEST(perft_kiwipete) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    ASSERT_EQ(48ULL, board.perft(1));
+    ASSERT_EQ(2039ULL, board.perft(2));
+    ASSERT_EQ(97862ULL, board.perft(3));
+}
+TEST(perft_position_3) {
+    Board board("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -");
+    ASSERT_EQ(14ULL, board.perft(1));
+    ASSERT_EQ(191ULL, board.perft(2));
+    ASSERT_EQ(2812ULL, board.perft(3));
+    ASSERT_EQ(43238ULL, board.perft(4));
+}
+TEST(perft_position_4) {
+    Board board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    ASSERT_EQ(6ULL, board.perft(1));
+    ASSERT_EQ(264ULL, board.perft(2));
+    ASSERT_EQ(9467ULL, board.perft(3));
+}
+TEST(perft_position_5) {
+    Board board("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+    ASSERT_EQ(44ULL, board.perft(1));
+    ASSERT_EQ(1486ULL, board.perft(2));
+    ASSERT_EQ(62379ULL, board.perft(3));
+}
+TEST(perft_unmake_restores_position) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    std::string before = board.generateFEN();
+    board.perft(3);
+    ASSERT_EQ(before, board.generateFEN());
+}
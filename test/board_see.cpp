@@ -0,0 +1,56 @@
+#include "test.h"
+#include "chess.hpp"
+
+// static exchange evaluation tests, values are pawn 100, knight 320, bishop 330,
+// rook 500, queen 900
+TEST(see_undefended_pawn) {
+    Board board("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - -");
+    Board::Move move = Board::parseMove("e1 e5");
+    ASSERT_TRUE(board.see(move, 0));
+    ASSERT_TRUE(board.see(move, 100));
+    ASSERT_FALSE(board.see(move, 101));
+}
+TEST(see_xray_sequence) {
+    // NxP NxN then every further recapture loses more, so the result is P - N
+    Board board("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - -");
+    Board::Move move = Board::parseMove("d3 e5");
+    ASSERT_FALSE(board.see(move, 0));
+    ASSERT_TRUE(board.see(move, -220));
+    ASSERT_FALSE(board.see(move, -219));
+}
+TEST(see_quiet_move_to_attacked_square) {
+    Board board("4k3/8/8/3p4/8/2N5/8/4K3 w - -");
+    ASSERT_FALSE(board.see(Board::parseMove("c3 e4"), 0));
+    ASSERT_TRUE(board.see(Board::parseMove("c3 e2"), 0));
+}
+TEST(see_defended_by_king_only) {
+    // the king cannot recapture while the rook on a5 still defends the square
+    Board board("8/8/8/R2pk3/8/8/8/3RK3 w - -");
+    ASSERT_TRUE(board.see(Board::parseMove("d1 d5"), 100));
+    Board undefended("8/8/8/3pk3/8/8/8/3RK3 w - -");
+    ASSERT_FALSE(undefended.see(Board::parseMove("d1 d5"), 0));
+}
+TEST(see_battery_behind_capturer) {
+    // the queen behind the rook wins the exchange after RxR RxR QxR
+    Board board("3r2k1/3r4/8/8/8/8/3R4/3QK3 w - -");
+    ASSERT_TRUE(board.see(Board::parseMove("d2 d7"), 500));
+    ASSERT_FALSE(board.see(Board::parseMove("d2 d7"), 501));
+    Board withoutQueen("3r2k1/3r4/8/8/8/8/3R4/4K3 w - -");
+    ASSERT_TRUE(withoutQueen.see(Board::parseMove("d2 d7"), 0));
+    ASSERT_FALSE(withoutQueen.see(Board::parseMove("d2 d7"), 1));
+}
+TEST(parseMove_promotion) {
+    Board::Move move = Board::parseMove("e7 e8q");
+    ASSERT_EQ(52, move.from);
+    ASSERT_EQ(60, move.to);
+    ASSERT_EQ(Board::Piece::WHITE_QUEEN, move.promotion);
+    ASSERT_EQ(Board::Piece::BLACK_KNIGHT, Board::parseMove("b2 b1n").promotion);
+}
+TEST(parseMove_invalid) {
+    ASSERT_THROWS(std::invalid_argument, []() {
+        Board::parseMove("e2e4");
+    });
+    ASSERT_THROWS(std::invalid_argument, []() {
+        Board::parseMove("e7 e8x");
+    });
+}
@@ -0,0 +1,111 @@
+#include "test.h"
+#include "chess.hpp"
+#include "positions.h"
+
+// every from/to/promotion combination must be accepted exactly when it is generated
+static void checkValidation(Board& board) {
+    Board::MoveList moves = board.generateMoves();
+    int accepted = 0;
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            for (int promotion = Board::WHITE_PAWN; promotion <= Board::EMPTY; ++promotion) {
+                if (board.validateMove(from, to, static_cast<Board::Piece>(promotion)) == Board::MOVE_OK) {
+                    accepted++;
+                }
+            }
+        }
+    }
+    ASSERT_EQ(moves.size(), accepted);
+    for (const Board::Move& move : moves) {
+        ASSERT_EQ(Board::MOVE_OK, board.validateMove(move));
+    }
+}
+
+TEST(validateMove_matches_generateMoves) {
+    for (const char* fen : POSITIONS) {
+        Board board(fen);
+        forEachNode(board, 1, checkValidation);
+    }
+}
+TEST(validateMove_error_codes) {
+    Board board;
+    int e2 = Board::getSquareForPosition("e2");
+    int e4 = Board::getSquareForPosition("e4");
+    ASSERT_EQ(Board::MOVE_OFF_BOARD, board.validateMove(e2, 64));
+    ASSERT_EQ(Board::MOVE_OFF_BOARD, board.validateMove(-1, e4));
+    ASSERT_EQ(Board::MOVE_NO_PIECE, board.validateMove(e4, e2));
+    ASSERT_EQ(Board::MOVE_WRONG_SIDE, board.validateMove(Board::getSquareForPosition("e7"), Board::getSquareForPosition("e5")));
+    ASSERT_EQ(Board::MOVE_OWN_PIECE, board.validateMove(Board::getSquareForPosition("d1"), Board::getSquareForPosition("d2")));
+    ASSERT_EQ(Board::MOVE_UNREACHABLE, board.validateMove(e2, Board::getSquareForPosition("e5")));
+    ASSERT_EQ(Board::MOVE_UNREACHABLE, board.validateMove(Board::getSquareForPosition("f1"), Board::getSquareForPosition("b5")));
+    ASSERT_EQ(Board::MOVE_BAD_PROMOTION, board.validateMove(e2, e4, Board::WHITE_QUEEN));
+    ASSERT_EQ(Board::MOVE_BAD_PROMOTION, board.validateMove(e2, e4, static_cast<Board::Piece>(40)));
+    ASSERT_EQ(Board::MOVE_OK, board.validateMove(e2, e4));
+}
+TEST(validateMove_promotions_pins_and_checks) {
+    Board promotion("7k/P7/8/8/8/8/8/K7 w - -");
+    int a7 = Board::getSquareForPosition("a7");
+    int a8 = Board::getSquareForPosition("a8");
+    ASSERT_EQ(Board::MOVE_BAD_PROMOTION, promotion.validateMove(a7, a8));
+    ASSERT_EQ(Board::MOVE_BAD_PROMOTION, promotion.validateMove(a7, a8, Board::BLACK_QUEEN));
+    ASSERT_EQ(Board::MOVE_OK, promotion.validateMove(a7, a8, Board::WHITE_KNIGHT));
+
+    // the e2 knight is pinned by the rook on e8
+    Board pinned("4r1k1/8/8/8/8/8/4N3/4K3 w - -");
+    ASSERT_EQ(Board::MOVE_LEAVES_KING_IN_CHECK,
+        pinned.validateMove(Board::getSquareForPosition("e2"), Board::getSquareForPosition("c3")));
+    ASSERT_EQ(Board::MOVE_OK, pinned.validateMove(Board::getSquareForPosition("e1"), Board::getSquareForPosition("d1")));
+
+    // in check from the rook, only blocking, capturing or stepping aside helps
+    Board check("4r1k1/8/8/8/8/8/3N4/4K3 w - -");
+    ASSERT_EQ(Board::MOVE_LEAVES_KING_IN_CHECK,
+        check.validateMove(Board::getSquareForPosition("d2"), Board::getSquareForPosition("b3")));
+    ASSERT_EQ(Board::MOVE_OK, check.validateMove(Board::getSquareForPosition("d2"), Board::getSquareForPosition("e4")));
+    ASSERT_EQ(Board::MOVE_LEAVES_KING_IN_CHECK,
+        check.validateMove(Board::getSquareForPosition("e1"), Board::getSquareForPosition("e2")));
+
+    // castling through an attacked square is not available
+    Board castling("4k3/8/8/8/8/8/5r2/4K2R w K -");
+    ASSERT_EQ(Board::MOVE_UNREACHABLE,
+        castling.validateMove(Board::getSquareForPosition("e1"), Board::getSquareForPosition("g1")));
+}
+TEST(move_reports_validation_error) {
+    Board board;
+    try {
+        board.move("e2 e5");
+    } catch (const std::invalid_argument& e) {
+        ASSERT_EQ(std::string("Illegal move: piece cannot move there"), std::string(e.what()));
+        return;
+    }
+    throw std::runtime_error("move() accepted e2 e5");
+}
+TEST(tryFromFEN_accepts_legal_positions) {
+    Board board;
+    ASSERT_EQ(Board::FEN_OK, Board::tryFromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -", board));
+    ASSERT_EQ(Board::WHITE_BISHOP, board.getPieceAtSquare(Board::getSquareForPosition("e2")));
+    ASSERT_EQ(Board::FEN_OK, Board::tryFromFEN("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3", board));
+    ASSERT_EQ(Board::getSquareForPosition("e3"), board.getEnPassantSquare());
+    // the side to move may be in check, just not the other one
+    ASSERT_EQ(Board::FEN_OK, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K2r w - -", board));
+}
+TEST(tryFromFEN_rejects_impossible_positions) {
+    Board board;
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K3/q7 w - -", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/4KPPPPPPPP w - -", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/4K3 w - -", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K2 w - -", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K3", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K3 x - -", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("", board));
+    ASSERT_EQ(Board::FEN_KING_COUNT, Board::tryFromFEN("8/8/8/8/8/8/8/4K3 w - -", board));
+    ASSERT_EQ(Board::FEN_KING_COUNT, Board::tryFromFEN("4k3/8/8/8/8/8/8/3KK3 w - -", board));
+    ASSERT_EQ(Board::FEN_PAWN_ON_BACK_RANK, Board::tryFromFEN("4k3/8/8/8/8/8/8/P3K3 w - -", board));
+    ASSERT_EQ(Board::FEN_PAWN_ON_BACK_RANK, Board::tryFromFEN("p3k3/8/8/8/8/8/8/4K3 b - -", board));
+    ASSERT_EQ(Board::FEN_MALFORMED, Board::tryFromFEN("4k3/8/8/8/8/8/P7/4K3 w - a1", board));
+    // the target must be behind a pawn the side not to move just pushed
+    ASSERT_EQ(Board::FEN_BAD_EN_PASSANT, Board::tryFromFEN("4k3/8/8/8/P7/8/8/4K3 w - a3", board));
+    ASSERT_EQ(Board::FEN_BAD_EN_PASSANT, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K3 b - e3", board));
+    ASSERT_EQ(Board::FEN_BAD_EN_PASSANT, Board::tryFromFEN("4k3/8/8/8/4P3/4N3/8/4K3 b - e3", board));
+    ASSERT_EQ(Board::FEN_OPPONENT_IN_CHECK, Board::tryFromFEN("4k3/8/8/8/8/8/8/4K2r b - -", board));
+    ASSERT_EQ(std::string("pawn on back rank"), std::string(Board::describeFENError(Board::FEN_PAWN_ON_BACK_RANK)));
+}
@@ -0,0 +1,108 @@
+#include "test.h"
+#include "chess.hpp"
+#include "dedup/dedup.hpp"
+#include <filesystem>
+#include <fstream>
+
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+static std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+TEST(dedup_hashes_match_board) {
+    uint64_t hash = 0;
+    ASSERT_TRUE(Dedup::hashLine("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", hash));
+    ASSERT_EQ(Board("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3").getHash(), hash);
+    // EPD operations and move counters do not change the position
+    uint64_t epd = 0;
+    ASSERT_TRUE(Dedup::hashLine("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 bm e5; id \"x\";\r", epd));
+    ASSERT_EQ(hash, epd);
+    ASSERT_FALSE(Dedup::hashLine("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -", hash));
+    ASSERT_FALSE(Dedup::hashLine("8/8/8/8/8/8/8/8 w - -", hash));
+    ASSERT_FALSE(Dedup::hashLine("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", hash));
+
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq a3");
+    ASSERT_EQ(board.getHash(), Dedup::hashRecord(SelfPlay::Record::pack(board)));
+}
+TEST(dedup_hash_set_and_bloom_filter) {
+    Dedup::HashSet set;
+    Dedup::BloomFilter filter(1 << 16);
+    for (uint64_t key = 0; key < 20000; ++key) {
+        ASSERT_TRUE(set.insert(key * 0x9E3779B97F4A7C15ULL));
+        filter.insert(key);
+    }
+    ASSERT_FALSE(set.insert(0));
+    ASSERT_FALSE(set.insert(1234 * 0x9E3779B97F4A7C15ULL));
+    ASSERT_TRUE(set.contains(19999 * 0x9E3779B97F4A7C15ULL));
+    ASSERT_FALSE(set.contains(12345));
+    ASSERT_EQ(20000u, set.size());
+    int falsePositives = 0;
+    for (uint64_t key = 0; key < 20000; ++key) {
+        ASSERT_TRUE(filter.mayContain(key));
+        falsePositives += filter.mayContain(key + 1000000);
+    }
+    // 26 bits per key: well under one percent
+    ASSERT_LTEQ(falsePositives, 200);
+}
+TEST(dedup_external_keeps_first_occurrences) {
+    // a tiny budget forces several runs of each kind
+    Dedup::ExternalDeduplicator deduplicator(1);
+    std::vector<uint64_t> expected;
+    for (uint64_t ordinal = 0; ordinal < 10000; ++ordinal) {
+        uint64_t key = (ordinal * 7919) % 3001;
+        if (ordinal < 3001) {
+            expected.push_back(ordinal);
+        }
+        deduplicator.add(key, ordinal);
+    }
+    deduplicator.finish();
+    ASSERT_GT(deduplicator.runCount(), 4);
+    std::vector<uint64_t> kept;
+    for (uint64_t ordinal; deduplicator.nextKept(ordinal);) {
+        kept.push_back(ordinal);
+    }
+    ASSERT_TRUE(expected == kept);
+}
+TEST(dedup_strategies_agree) {
+    std::string input = tempPath("chess_dedup_input.fen");
+    std::string output = tempPath("chess_dedup_output.fen");
+    std::vector<std::string> lines = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+        "not a position",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 4 3",
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    };
+    {
+        std::ofstream out(input);
+        for (int copy = 0; copy < 3; ++copy) {
+            for (const std::string& line : lines) {
+                out << line << '\n';
+            }
+        }
+    }
+    std::vector<std::string> expected = {lines[0], lines[1], lines[5]};
+    Dedup::Config memory;
+    memory.threads = 2;
+    Dedup::Config bloom;
+    bloom.bloom = true;
+    Dedup::Config external;
+    external.externalBytes = 1;
+    for (const Dedup::Config& config : {memory, bloom, external}) {
+        Dedup::Stats stats = Dedup::deduplicate(config, input, output);
+        ASSERT_EQ(18u, stats.records);
+        ASSERT_EQ(3u, stats.unique);
+        ASSERT_EQ(3u, stats.invalid);
+        ASSERT_TRUE(expected == readLines(output));
+    }
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+}
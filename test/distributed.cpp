@@ -0,0 +1,127 @@
+#ifdef __linux__
+#include "test.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "chess.hpp"
+#include "distributed/distributed.hpp"
+
+namespace {
+    std::vector<std::string> perftJob() {
+        std::vector<std::string> positions = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - bm e2a6; id \"kiwipete\";",
+            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+            "not a position",
+            "4k3/8/8/8/8/8/8/4K3 w - -",
+        };
+        return positions;
+    }
+    std::string socketPath(const char* name) {
+        return "/tmp/chess_distributed_" + std::string(name) + "_" + std::to_string(getpid()) + ".sock";
+    }
+}
+
+TEST(distributed_analyze) {
+    Search::Searcher searcher;
+    Distributed::Job perft{Distributed::PERFT, 3};
+    ASSERT_EQ(std::string("8902"), Distributed::analyze(perftJob()[0], perft, searcher));
+    // EPD operations after the position are ignored
+    ASSERT_EQ(std::string("97862"), Distributed::analyze(perftJob()[1], perft, searcher));
+    ASSERT_EQ(0u, Distributed::analyze("not a position", perft, searcher).find("error "));
+
+    Distributed::Job search{Distributed::SEARCH, 2};
+    std::string result = Distributed::analyze("6k1/5ppp/8/8/8/8/8/R5K1 w - -", search, searcher);
+    ASSERT_EQ(0u, result.find("Ra8#\t"));
+    ASSERT_TRUE(result.find("\tdepth ") != std::string::npos);
+}
+TEST(distributed_local_workers) {
+    Distributed::CoordinatorConfig config;
+    config.job = Distributed::Job{Distributed::PERFT, 2};
+    config.unitSize = 2;
+    config.localWorkers = 2;
+    std::vector<std::string> positions = perftJob();
+    Distributed::Coordinator coordinator(positions, config);
+    coordinator.listenUnix(socketPath("local"));
+    std::vector<std::string> results = coordinator.run();
+
+    ASSERT_EQ(positions.size(), results.size());
+    Search::Searcher searcher;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        ASSERT_EQ(Distributed::analyze(positions[i], config.job, searcher), results[i]);
+    }
+    ASSERT_EQ(std::string("400"), results[0]);
+    ASSERT_EQ(4u, coordinator.progress().units);
+    ASSERT_EQ(4u, coordinator.progress().finished);
+}
+TEST(distributed_requeue_and_resume) {
+    std::string checkpoint = (std::filesystem::temp_directory_path()
+                              / ("chess_distributed_" + std::to_string(getpid()) + ".ckpt")).string();
+    std::filesystem::remove(checkpoint);
+    std::string path = socketPath("requeue");
+    Distributed::CoordinatorConfig config;
+    config.job = Distributed::Job{Distributed::PERFT, 2};
+    config.unitSize = 3;
+    config.checkpointPath = checkpoint;
+    std::vector<std::string> positions = perftJob();
+
+    std::vector<std::string> results;
+    {
+        Distributed::Coordinator coordinator(positions, config);
+        coordinator.listenTcp(0);
+        coordinator.listenUnix(path);
+        // a worker that takes a unit and dies, then one that finishes the job
+        std::thread workers([&path] {
+            Distributed::WorkerConfig workerConfig;
+            workerConfig.coordinator.unixPath = path;
+            workerConfig.retrySeconds = 5;
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strcpy(address.sun_path, path.c_str());
+            while (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            std::string ready = "ready\n";
+            ssize_t written = write(fd, ready.data(), ready.size());
+            (void)written;
+            char c;
+            while (read(fd, &c, 1) == 1 && c != '\n') {
+            }
+            close(fd);
+            Distributed::runWorker(workerConfig);
+        });
+        results = coordinator.run();
+        workers.join();
+        ASSERT_EQ(positions.size(), results.size());
+        ASSERT_EQ(3u, coordinator.progress().finished);
+        ASSERT_TRUE(coordinator.progress().requeued >= 1);
+    }
+
+    // a crash in the middle of writing a unit leaves a partial record behind
+    {
+        std::ofstream out(checkpoint, std::ios::app);
+        out << "unit 1 3\n20\n";
+    }
+    {
+        Distributed::Coordinator coordinator(positions, config);
+        ASSERT_EQ(3u, coordinator.progress().resumed);
+        coordinator.listenUnix(path);
+        std::vector<std::string> resumed = coordinator.run();
+        ASSERT_TRUE(resumed == results);
+        ASSERT_EQ(0u, coordinator.progress().finished);
+    }
+
+    // the checkpoint only resumes the job it was written for
+    config.job.depth = 3;
+    ASSERT_THROWS(std::runtime_error, [&] { Distributed::Coordinator coordinator(positions, config); });
+    std::filesystem::remove(checkpoint);
+}
+#endif
@@ -0,0 +1,37 @@
+#include "test.h"
+#include "chess.hpp"
+
+static const std::vector<std::string> EVAL_POSITIONS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -",
+    "4k3/8/8/8/8/8/8/4K2Q w - -",
+    "8/8/4k3/8/8/3K4/8/8 w - -",
+    "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - -",
+    "3r2k1/3r4/8/8/8/8/3R4/3QK3 w - -",
+};
+
+TEST(evaluate_initial_board_is_balanced) {
+    Board board;
+    ASSERT_EQ(0, Evaluation::evaluate(board));
+}
+TEST(evaluate_extra_queen) {
+    Board board("4k3/8/8/8/8/8/8/4K2Q w - -");
+    ASSERT_GT(Evaluation::evaluate(board), 800);
+    Board mirrored("4k2q/8/8/8/8/8/8/4K3 w - -");
+    ASSERT_EQ(-Evaluation::evaluate(board), Evaluation::evaluate(mirrored));
+}
+TEST(evaluateBatch_matches_scalar) {
+    // an odd count exercises both the four-wide blocks and the scalar tail
+    std::vector<Board> boards;
+    for (const std::string& fen : EVAL_POSITIONS) {
+        boards.emplace_back(fen);
+    }
+    std::vector<int32_t> scores(boards.size());
+    Evaluation::evaluateBatch(boards.data(), boards.size(), scores.data());
+    for (size_t i = 0; i < boards.size(); ++i) {
+        ASSERT_EQ(Evaluation::evaluate(boards[i]), scores[i]);
+    }
+}
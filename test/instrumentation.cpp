@@ -0,0 +1,46 @@
+#include "test.h"
+#include "chess.hpp"
+#include "util/instrumentation.hpp"
+#include <thread>
+
+static uint64_t calls(Instrumentation::Counter counter) {
+    return Instrumentation::snapshot()[counter].calls;
+}
+
+TEST(instrumentation_counts_hot_paths) {
+    Instrumentation::reset();
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    Board::MoveList moves = board.generateMoves();
+    Board::UndoInfo undo = board.makeMove(moves[0]);
+    board.unmakeMove(moves[0], undo);
+    board.generateFEN();
+
+    uint64_t expected = Instrumentation::enabled ? 1 : 0;
+    ASSERT_EQ(expected, calls(Instrumentation::FEN_PARSE));
+    ASSERT_EQ(expected, calls(Instrumentation::MOVE_GENERATION));
+    ASSERT_EQ(expected, calls(Instrumentation::MAKE_MOVE));
+    ASSERT_EQ(expected, calls(Instrumentation::UNMAKE_MOVE));
+    ASSERT_EQ(expected, calls(Instrumentation::FEN_EMIT));
+    // the validating parser is timed too
+    Board::tryFromFEN("4k3/8/8/8/8/8/8/4K3 w - -", board);
+    ASSERT_EQ(2 * expected, calls(Instrumentation::FEN_PARSE));
+}
+TEST(instrumentation_keeps_counts_of_finished_threads) {
+    Instrumentation::reset();
+    std::thread worker([]() {
+        Board board;
+        board.perft(2);
+    });
+    worker.join();
+    // perft(2) from the start position generates moves at the root and bulk-counts each of the 20 replies
+    ASSERT_EQ(Instrumentation::enabled ? 1u : 0u, calls(Instrumentation::MOVE_GENERATION));
+    ASSERT_EQ(Instrumentation::enabled ? 20u : 0u, calls(Instrumentation::MOVE_COUNT));
+    Instrumentation::reset();
+    ASSERT_EQ(0u, calls(Instrumentation::MOVE_GENERATION));
+}
+TEST(instrumentation_reports) {
+    std::string json = Instrumentation::toJson();
+    ASSERT_TRUE(json.find("\"move_generation\"") != std::string::npos);
+    ASSERT_TRUE(json.find(Instrumentation::enabled ? "\"enabled\": true" : "\"enabled\": false") != std::string::npos);
+    ASSERT_TRUE(Instrumentation::toTable().find("unmake_move") != std::string::npos);
+}
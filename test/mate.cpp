@@ -0,0 +1,49 @@
+#include "test.h"
+#include "chess.hpp"
+#include "search/mate.hpp"
+
+static std::string line(Board board, const std::vector<Board::Move>& moves) {
+    std::string san;
+    for (const Board::Move& move : moves) {
+        san += (san.empty() ? "" : " ") + board.toSAN(move);
+        board.makeMove(move);
+    }
+    return san;
+}
+
+TEST(mate_solver_mate_in_one) {
+    Mate::Solver solver;
+    Mate::Result result = solver.solve(Board("6k1/5ppp/8/8/8/8/8/R5K1 w - -"), {});
+    ASSERT_EQ(Mate::MATE, result.status);
+    ASSERT_EQ(1, result.mateIn);
+    ASSERT_EQ(std::string("Ra8#"), line(Board("6k1/5ppp/8/8/8/8/8/R5K1 w - -"), result.pv));
+}
+TEST(mate_solver_finds_shortest_mate) {
+    Mate::Solver solver;
+    Board board("r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq -");
+    Mate::Result result = solver.solve(board, {});
+    ASSERT_EQ(Mate::MATE, result.status);
+    ASSERT_EQ(2, result.mateIn);
+    ASSERT_EQ(std::string("Nf6+ gxf6 Bxf7#"), line(board, result.pv));
+    // the same mate is out of reach with only one move to play
+    ASSERT_EQ(Mate::NO_MATE, solver.solve(board, {1, 0}).status);
+}
+TEST(mate_solver_disproves_and_stops) {
+    Mate::Solver solver;
+    ASSERT_EQ(Mate::NO_MATE, solver.solve(Board("k7/8/8/8/8/8/8/K7 w - -"), {}).status);
+    // stalemate is not mate
+    ASSERT_EQ(Mate::NO_MATE, solver.solve(Board("k7/8/1Q6/8/8/8/8/K7 b - -"), {}).status);
+    Mate::Result limited = solver.solve(Board(), {15, 1000});
+    ASSERT_EQ(Mate::UNKNOWN, limited.status);
+    ASSERT_LTEQ(limited.nodes, 1000u);
+}
+TEST(mate_solver_unique_solution) {
+    Mate::Solver solver;
+    bool complete = false;
+    std::vector<Board::Move> moves = solver.matingMoves(Board("7k/8/5K2/8/8/8/8/6R1 w - -"), {3, 0}, &complete);
+    ASSERT_TRUE(complete);
+    ASSERT_EQ(1u, moves.size());
+    ASSERT_EQ(Board::getSquareForPosition("f7"), moves[0].to);
+    // two rooks mate on the back rank either way
+    ASSERT_EQ(2u, solver.matingMoves(Board("6k1/8/6K1/8/8/8/8/RR6 w - -"), {1, 0}).size());
+}
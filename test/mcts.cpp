@@ -0,0 +1,74 @@
+#include "test.h"
+#include "chess.hpp"
+#include "search/mcts.hpp"
+#include "util/arena.hpp"
+
+TEST(arena_allocates_aligned_until_full) {
+    Arena arena(256);
+    char* byte = arena.create<char>();
+    uint64_t* words = arena.create<uint64_t>(4);
+    ASSERT_TRUE(byte != nullptr && words != nullptr);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(words) % alignof(uint64_t));
+    ASSERT_EQ(0ULL, words[3]);
+    ASSERT_TRUE(arena.create<uint64_t>(64) == nullptr);
+    arena.reset();
+    ASSERT_EQ(0u, arena.used());
+    ASSERT_TRUE(arena.create<uint64_t>(16) != nullptr);
+}
+TEST(mcts_finds_mate_in_one) {
+    Mcts::Tree tree;
+    tree.setPosition(Board("6k1/5ppp/8/8/8/8/8/R5K1 w - -"));
+    Mcts::Result result = tree.search(2000);
+    ASSERT_EQ(Board::getSquareForPosition("a1"), result.move.from);
+    ASSERT_EQ(Board::getSquareForPosition("a8"), result.move.to);
+    ASSERT_GT(result.value, 0.9f);
+    ASSERT_EQ(2000u, result.playouts);
+}
+TEST(mcts_without_moves) {
+    Mcts::Tree tree;
+    tree.setPosition(Board("R5k1/5ppp/8/8/8/8/8/6K1 b - -"));
+    Mcts::Result result = tree.search(10);
+    ASSERT_EQ(-1, result.move.from);
+    ASSERT_EQ(-1.0f, result.value);
+}
+TEST(mcts_reuses_subtree) {
+    Mcts::Tree tree;
+    Mcts::Result result = tree.search(1000);
+    uint32_t kept = 0;
+    for (const Mcts::MoveStats& stats : tree.rootMoves()) {
+        if (stats.move.from == result.move.from && stats.move.to == result.move.to) {
+            kept = stats.visits;
+        }
+    }
+    ASSERT_TRUE(tree.advance(result.move));
+    ASSERT_EQ(kept, tree.rootVisits());
+    ASSERT_FALSE(tree.position().getTurn());
+    // a move without a searched subtree starts a fresh tree
+    Mcts::Tree fresh;
+    fresh.search(1);
+    ASSERT_FALSE(fresh.advance(fresh.rootMoves()[0].move));
+    ASSERT_EQ(0u, fresh.rootVisits());
+}
+TEST(mcts_parallel_playouts) {
+    Mcts::Config config;
+    config.threads = 4;
+    Mcts::Tree tree(config);
+    Mcts::Result result = tree.search(3000);
+    ASSERT_EQ(3000u, result.playouts);
+    uint32_t childVisits = 0;
+    for (const Mcts::MoveStats& stats : tree.rootMoves()) {
+        childVisits += stats.visits;
+    }
+    // every playout but the one that expanded the root passed through a child
+    ASSERT_EQ(tree.rootVisits() - 1, childVisits);
+}
+TEST(mcts_stops_when_memory_runs_out) {
+    Mcts::Config config;
+    config.memoryBytes = 64 << 10;
+    Mcts::Tree tree(config);
+    Mcts::Result result = tree.search(100000);
+    ASSERT_TRUE(result.outOfMemory);
+    ASSERT_TRUE(result.playouts < 100000u);
+    ASSERT_TRUE(result.move.from >= 0);
+    ASSERT_LTEQ(tree.memoryUsed(), size_t(32 << 10));
+}
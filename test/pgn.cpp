@@ -0,0 +1,62 @@
+#include "test.h"
+#include "chess.hpp"
+#include "pgn/pgn.hpp"
+#include <sstream>
+
+TEST(pgn_reads_tags_and_moves) {
+    std::istringstream in(
+        "[Event \"Casual\"]\n"
+        "[White \"A\"]\n"
+        "[Result \"1-0\"]\n"
+        "\n"
+        "1. e4 e5 2. Nf3 {a comment} Nc6 (2... d6 3. d4) 3. Bb5 $1 a6 1-0\n"
+        "\n"
+        "[Event \"Second\"]\n"
+        "[FEN \"4k3/8/8/8/8/8/8/R3K3 w - - 0 1\"]\n"
+        "\n"
+        "1. Ra8+ Kd7 ; rest of line ignored\n"
+        "2. Ra7+ 1/2-1/2\n");
+    Pgn::Reader reader(in);
+    Pgn::Game game;
+
+    ASSERT_TRUE(reader.next(game));
+    ASSERT_EQ(std::string("Casual"), game.tags["Event"]);
+    ASSERT_EQ(std::string("1-0"), game.result);
+    std::vector<std::string> expected = {"e4", "e5", "Nf3", "Nc6", "Bb5", "a6"};
+    ASSERT_EQ(expected.size(), game.moves.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i], game.moves[i]);
+    }
+    ASSERT_TRUE(game.startFen.empty());
+
+    ASSERT_TRUE(reader.next(game));
+    ASSERT_EQ(std::string("Second"), game.tags["Event"]);
+    ASSERT_EQ(std::string("1/2-1/2"), game.result);
+    ASSERT_EQ(3u, game.moves.size());
+    ASSERT_EQ(std::string("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"), game.startFen);
+
+    ASSERT_FALSE(reader.next(game));
+}
+TEST(pgn_keeps_moves_next_to_variations) {
+    std::istringstream in("1. e4(1. d4) e5 2. Nf3 (2. f4 (2. Nc3))Nc6 *\n");
+    Pgn::Reader reader(in);
+    Pgn::Game game;
+    ASSERT_TRUE(reader.next(game));
+    std::vector<std::string> expected = {"e4", "e5", "Nf3", "Nc6"};
+    ASSERT_EQ(expected.size(), game.moves.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i], game.moves[i]);
+    }
+}
+TEST(pgn_moves_replay_with_san) {
+    std::istringstream in("1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 4. O-O *\n");
+    Pgn::Reader reader(in);
+    Pgn::Game game;
+    ASSERT_TRUE(reader.next(game));
+    ASSERT_EQ(std::string("*"), game.result);
+    Board board;
+    for (const std::string& san : game.moves) {
+        board.makeMove(board.parseSAN(san));
+    }
+    ASSERT_EQ(std::string("r1bqkbnr/1ppp1ppp/p1n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQ1RK1 b kq -"), board.generateFEN().substr(0, 61));
+}
@@ -0,0 +1,70 @@
+#include "test.h"
+#include "chess.hpp"
+#include "eval/planes.hpp"
+
+static const std::vector<std::string> PLANE_POSITIONS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq -",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6",
+    "rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b KQkq d3",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+};
+
+// square by square, straight from the board
+static float expected(const Board& board, bool flip, int plane, int square) {
+    bool mirror = flip && !board.getTurn();
+    int source = mirror ? square ^ 56 : square;
+    if (plane < 12) {
+        int piece = mirror ? (plane + 6) % 12 : plane;
+        return (board.getBitmaskForPiece(static_cast<Board::Piece>(piece)) >> source) & 1;
+    }
+    if (plane == 12) {
+        return board.getTurn();
+    }
+    if (plane < 17) {
+        int right = plane - 13;
+        if (mirror) {
+            right ^= 2;
+        }
+        return (board.getCastlingRights() >> (3 - right)) & 1;
+    }
+    return board.getEnPassantSquare() == source;
+}
+
+TEST(planes_match_board_contents) {
+    std::vector<Board> boards;
+    for (const std::string& fen : PLANE_POSITIONS) {
+        boards.emplace_back(fen);
+    }
+    std::vector<uint8_t> bytes(boards.size() * Planes::BOARD_VALUES);
+    std::vector<float> floats(boards.size() * Planes::BOARD_VALUES);
+    for (bool flip : {false, true}) {
+        Planes::encode(boards.data(), boards.size(), bytes.data(), flip);
+        Planes::encode(boards.data(), boards.size(), floats.data(), flip);
+        for (size_t i = 0; i < boards.size(); ++i) {
+            for (int plane = 0; plane < Planes::PLANE_COUNT; ++plane) {
+                for (int square = 0; square < 64; ++square) {
+                    size_t index = i * Planes::BOARD_VALUES + plane * 64 + square;
+                    float value = expected(boards[i], flip, plane, square);
+                    ASSERT_EQ(value, static_cast<float>(bytes[index]));
+                    ASSERT_EQ(value, floats[index]);
+                }
+            }
+        }
+    }
+}
+TEST(planes_flip_mirrors_black_to_move) {
+    // after 1. e4 e5 with black to move, the flipped view looks like white's
+    Board black("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR b KQkq -");
+    Board white("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq -");
+    uint8_t flipped[Planes::BOARD_VALUES];
+    uint8_t straight[Planes::BOARD_VALUES];
+    Planes::encode(&black, 1, flipped, true);
+    Planes::encode(&white, 1, straight, true);
+    // identical apart from the side-to-move plane
+    for (int i = 0; i < 12 * 64; ++i) {
+        ASSERT_EQ(straight[i], flipped[i]);
+    }
+    ASSERT_EQ(1, straight[12 * 64]);
+    ASSERT_EQ(0, flipped[12 * 64]);
+}
@@ -0,0 +1,127 @@
+#include "test.h"
+#include "chess.hpp"
+#include "book/polyglot.hpp"
+#include <filesystem>
+#include <fstream>
+
+static std::string bookPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(polyglot_key_depends_on_position) {
+    Board start;
+    Board moved = start;
+    moved.move("e2 e4");
+    ASSERT_TRUE(Polyglot::key(start) != Polyglot::key(moved));
+    ASSERT_EQ(Polyglot::key(start), Polyglot::key(Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -")));
+    ASSERT_TRUE(Polyglot::key(start) != Polyglot::key(Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Kkq -")));
+}
+TEST(polyglot_key_ignores_uncapturable_en_passant) {
+    // after 1. e4 no black pawn can take on e3, so the square is not hashed
+    Board withSquare("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3");
+    Board without("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq -");
+    ASSERT_EQ(Polyglot::key(without), Polyglot::key(withSquare));
+    Board capturable("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3");
+    Board capturableWithout("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq -");
+    ASSERT_TRUE(Polyglot::key(capturableWithout) != Polyglot::key(capturable));
+}
+TEST(polyglot_reference_start_key) {
+    ASSERT_EQ(0x463b96181691fc9cULL, Polyglot::key(Board()));
+}
+TEST(polyglot_reference_keys) {
+    // keys listed in the Polyglot book format description
+    Board board;
+    board.move("e2 e4");
+    ASSERT_EQ(0x823c9b50fd114196ULL, Polyglot::key(board));
+    board.move("d7 d5");
+    ASSERT_EQ(0x0756b94461c50fb0ULL, Polyglot::key(board));
+    board.move("e4 e5");
+    ASSERT_EQ(0x662fafb965db29d4ULL, Polyglot::key(board));
+    board.move("f7 f5");
+    ASSERT_EQ(0x22a48b5a8e47ff78ULL, Polyglot::key(board));
+    board.move("e1 e2");
+    ASSERT_EQ(0x652a607ca3f242c1ULL, Polyglot::key(board));
+    board.move("e8 f7");
+    ASSERT_EQ(0x00fdd303c946bdd9ULL, Polyglot::key(board));
+
+    Board sideline;
+    for (const char* move : {"a2 a4", "b7 b5", "h2 h4", "b5 b4", "c2 c4"}) {
+        sideline.move(move);
+    }
+    ASSERT_EQ(0x3c8123ea7b067637ULL, Polyglot::key(sideline));
+    sideline.move("b4 c3");
+    sideline.move("a1 a3");
+    ASSERT_EQ(0x5c3f9b829b279560ULL, Polyglot::key(sideline));
+}
+TEST(polyglot_move_encoding) {
+    Board board("4k3/1P6/8/8/8/8/8/R3K2R w KQ -");
+    Board::Move castle = Board::parseMove("e1 g1");
+    uint16_t encoded = Polyglot::encodeMove(board, castle);
+    ASSERT_EQ(Board::getSquareForPosition("h1"), encoded & 63);
+    Board::Move decoded = Polyglot::decodeMove(board, encoded);
+    ASSERT_EQ(castle.to, decoded.to);
+
+    Board::Move promotion = Board::parseMove("b7 b8n");
+    decoded = Polyglot::decodeMove(board, Polyglot::encodeMove(board, promotion));
+    ASSERT_EQ(Board::Piece::WHITE_KNIGHT, decoded.promotion);
+    ASSERT_EQ(promotion.to, decoded.to);
+}
+TEST(polyglot_builder_round_trip) {
+    Polyglot::BookBuilder builder;
+    Board start;
+    std::vector<Board::Move> e4 = {start.parseSAN("e4"), Board::parseMove("e7 e5")};
+    std::vector<Board::Move> d4 = {start.parseSAN("d4")};
+    builder.addGame(start, e4, Polyglot::BookBuilder::WIN, 10);
+    builder.addGame(start, e4, Polyglot::BookBuilder::DRAW, 10);
+    builder.addGame(start, d4, Polyglot::BookBuilder::LOSS, 10);
+    builder.addGame(start, d4, Polyglot::BookBuilder::DRAW, 10);
+    std::string path = bookPath("chess_polyglot_test.bin");
+    builder.write(path);
+
+    Polyglot::Book book(path);
+    ASSERT_EQ(3u, book.size());
+    std::vector<Polyglot::Entry> entries = book.lookup(start);
+    ASSERT_EQ(2u, entries.size());
+    for (size_t i = 1; i < book.size(); ++i) {
+        ASSERT_TRUE(book.entry(i - 1).key <= book.entry(i).key);
+    }
+
+    Board::Move move;
+    ASSERT_TRUE(book.bestMove(start, move));
+    ASSERT_EQ(Board::getSquareForPosition("e4"), move.to);
+    // e4 scored 3 points and d4 1, so the low quarter of the range picks d4
+    ASSERT_TRUE(book.weightedMove(start, 0, move));
+    int first = move.to;
+    int picked[2] = {0, 0};
+    for (uint64_t random = 0; random < 0x10000 * 4 / 3; random += 97) {
+        ASSERT_TRUE(book.weightedMove(start, random, move));
+        picked[move.to == first ? 0 : 1]++;
+    }
+    ASSERT_TRUE(picked[0] > 0 && picked[1] > 0);
+
+    Board afterE4 = start;
+    afterE4.move("e2 e4");
+    ASSERT_TRUE(book.bestMove(afterE4, move));
+    ASSERT_EQ(Board::getSquareForPosition("e5"), move.to);
+    Board empty("4k3/8/8/8/8/8/8/4K3 w - -");
+    ASSERT_FALSE(book.bestMove(empty, move));
+    ASSERT_TRUE(book.lookup(empty).empty());
+}
+TEST(polyglot_min_games_filter) {
+    Polyglot::BookBuilder builder;
+    Board start;
+    builder.addGame(start, {start.parseSAN("e4")}, Polyglot::BookBuilder::WIN, 10);
+    builder.addGame(start, {start.parseSAN("e4")}, Polyglot::BookBuilder::WIN, 10);
+    builder.addGame(start, {start.parseSAN("c4")}, Polyglot::BookBuilder::WIN, 10);
+    std::string path = bookPath("chess_polyglot_filter_test.bin");
+    builder.write(path, 2);
+    Polyglot::Book book(path);
+    ASSERT_EQ(1u, book.size());
+}
+TEST(polyglot_rejects_truncated_file) {
+    std::string path = bookPath("chess_polyglot_truncated.bin");
+    std::ofstream(path, std::ios::binary) << "not a book";
+    ASSERT_THROWS(std::runtime_error, [&path]() {
+        Polyglot::Book book(path);
+    });
+}
@@ -0,0 +1,93 @@
+#include "test.h"
+#include "chess.hpp"
+#include "book/polyglot.hpp"
+#include "index/position_index.hpp"
+#include <filesystem>
+
+static std::string indexPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+static std::vector<Board::Move> line(std::vector<std::string> sans) {
+    Board board;
+    std::vector<Board::Move> moves;
+    for (const std::string& san : sans) {
+        moves.push_back(board.parseSAN(san));
+        board.makeMove(moves.back());
+    }
+    return moves;
+}
+static void writeGames(PositionIndex::Writer& writer) {
+    writer.addGame(0, Board(), line({"e4", "e5", "Nf3", "Nc6"}));
+    writer.addGame(1, Board(), line({"Nf3", "Nc6", "e4", "e5"}));
+    writer.addGame(2, Board(), line({"d4", "d5"}));
+    // repeats the start position twice, which must still count once
+    writer.addGame(700000, Board(), line({"Nf3", "Nf6", "Ng1", "Ng8"}));
+}
+
+TEST(position_index_finds_transpositions) {
+    std::string path = indexPath("chess_position_index_test.cpi");
+    PositionIndex::Writer writer(path);
+    writeGames(writer);
+    writer.finish();
+
+    PositionIndex::Index index(path);
+    Board transposed("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq -");
+    std::vector<uint32_t> games = index.games(transposed);
+    ASSERT_EQ(2u, games.size());
+    ASSERT_EQ(0u, games[0]);
+    ASSERT_EQ(1u, games[1]);
+
+    std::vector<uint32_t> start = index.games(Board());
+    ASSERT_EQ(4u, start.size());
+    ASSERT_EQ(700000u, start[3]);
+    ASSERT_EQ(4u, index.gameCount(Polyglot::key(Board())));
+    ASSERT_TRUE(index.games(Board("4k3/8/8/8/8/8/8/4K3 w - -")).empty());
+    ASSERT_EQ(0u, index.gameCount(0));
+}
+TEST(position_index_merges_spilled_runs) {
+    std::string inMemory = indexPath("chess_position_index_memory.cpi");
+    std::string spilled = indexPath("chess_position_index_spilled.cpi");
+    {
+        PositionIndex::Writer writer(inMemory);
+        writeGames(writer);
+        writer.finish();
+    }
+    {
+        // a three-entry buffer forces several runs and a merge
+        PositionIndex::Writer writer(spilled, 3);
+        writeGames(writer);
+        writer.finish();
+    }
+    ASSERT_EQ(std::filesystem::file_size(inMemory), std::filesystem::file_size(spilled));
+    PositionIndex::Index a(inMemory);
+    PositionIndex::Index b(spilled);
+    ASSERT_EQ(a.positionCount(), b.positionCount());
+    ASSERT_EQ(a.games(Board()).size(), b.games(Board()).size());
+    ASSERT_FALSE(std::filesystem::exists(spilled + ".run0"));
+}
+TEST(position_index_empty) {
+    std::string path = indexPath("chess_position_index_empty.cpi");
+    {
+        PositionIndex::Writer writer(path);
+        writer.finish();
+    }
+    ASSERT_FALSE(std::filesystem::exists(path + ".tmp"));
+    ASSERT_FALSE(std::filesystem::exists(path + ".keys"));
+
+    PositionIndex::Index index(path);
+    ASSERT_EQ(0u, index.positionCount());
+    ASSERT_TRUE(index.games(Board()).empty());
+    ASSERT_EQ(0u, index.gameCount(Polyglot::key(Board())));
+}
+TEST(position_index_rejects_other_files) {
+    std::string path = indexPath("chess_position_index_bad.cpi");
+    {
+        Polyglot::BookBuilder builder;
+        builder.addMove(Board(), Board::parseMove("e2 e4"), Polyglot::BookBuilder::WIN);
+        builder.addMove(Board(), Board::parseMove("d2 d4"), Polyglot::BookBuilder::WIN);
+        builder.write(path);
+    }
+    ASSERT_THROWS(std::runtime_error, [&path]() {
+        PositionIndex::Index index(path);
+    });
+}
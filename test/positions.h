@@ -0,0 +1,29 @@
+#ifndef TEST_POSITIONS_H
+#define TEST_POSITIONS_H
+
+#include "chess.hpp"
+
+// the standard perft positions: castling, en passant, promotions, pins and checks for both sides
+inline const char* const POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -",
+};
+
+// calls check(board) on `board` and every position up to `depth` plies below it
+template <typename Check>
+void forEachNode(Board& board, int depth, Check check) {
+    check(board);
+    if (depth == 0) {
+        return;
+    }
+    for (const Board::Move& move : board.generateMoves()) {
+        Board::UndoInfo undo = board.makeMove(move);
+        forEachNode(board, depth - 1, check);
+        board.unmakeMove(move, undo);
+    }
+}
+
+#endif
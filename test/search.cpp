@@ -0,0 +1,46 @@
+#include "test.h"
+#include "chess.hpp"
+#include "search/search.hpp"
+
+TEST(search_finds_mate_in_one) {
+    Board board("6k1/5ppp/8/8/8/8/8/R5K1 w - -");
+    Search::Searcher searcher;
+    Search::Result result = searcher.search(board, {3, 0});
+    ASSERT_EQ(Board::getSquareForPosition("a1"), result.move.from);
+    ASSERT_EQ(Board::getSquareForPosition("a8"), result.move.to);
+    ASSERT_EQ(Search::MATE_SCORE - 1, result.score);
+}
+TEST(search_takes_hanging_queen) {
+    Board board("4k3/8/8/3q4/8/8/3R4/4K3 w - -");
+    Search::Searcher searcher;
+    Search::Result result = searcher.search(board, {2, 0});
+    ASSERT_EQ(Board::getSquareForPosition("d5"), result.move.to);
+    ASSERT_GT(result.score, 300);
+}
+TEST(search_respects_node_limit) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    Search::Searcher searcher;
+    Search::Result result = searcher.search(board, {0, 500});
+    ASSERT_TRUE(result.move.from >= 0);
+    ASSERT_LTEQ(result.nodes, 501u);
+}
+TEST(search_without_moves) {
+    Search::Searcher searcher;
+    Board mated("R5k1/5ppp/8/8/8/8/8/6K1 b - -");
+    Search::Result result = searcher.search(mated, {3, 0});
+    ASSERT_EQ(-1, result.move.from);
+    ASSERT_EQ(-Search::MATE_SCORE, result.score);
+    Board stalemate("7k/5Q2/6K1/8/8/8/8/8 b - -");
+    ASSERT_EQ(0, searcher.search(stalemate, {3, 0}).score);
+    ASSERT_THROWS(std::invalid_argument, [&searcher]() {
+        searcher.search(Board(), {0, 0});
+    });
+}
+TEST(search_scores_fifty_move_draw) {
+    Search::Searcher searcher;
+    // a rook up, but every move runs out the fifty-move count
+    Board board("8/8/4k3/8/8/8/8/R3K3 w - - 99 80");
+    ASSERT_EQ(0, searcher.search(board, {2, 0}).score);
+    Board fresh("8/8/4k3/8/8/8/8/R3K3 w - - 0 80");
+    ASSERT_GT(searcher.search(fresh, {2, 0}).score, 300);
+}
@@ -0,0 +1,59 @@
+#include "test.h"
+#include "chess.hpp"
+#include "selfplay/selfplay.hpp"
+#include <filesystem>
+#include <fstream>
+
+TEST(selfplay_record_round_trip) {
+    std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -";
+    Board board(fen);
+    SelfPlay::Record record = SelfPlay::Record::pack(board);
+    ASSERT_EQ(board.generateFEN(), record.unpack().generateFEN());
+
+    Board enPassant("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b Kq e3");
+    ASSERT_EQ(enPassant.generateFEN(), SelfPlay::Record::pack(enPassant).unpack().generateFEN());
+}
+TEST(selfplay_writes_whole_games) {
+    std::string path = (std::filesystem::temp_directory_path() / "chess_selfplay_test.bin").string();
+    std::filesystem::remove(path);
+    SelfPlay::Config config;
+    config.games = 6;
+    config.threads = 3;
+    config.limits = {1, 0};
+    config.maxPlies = 12;
+    config.bufferRecords = 5;
+    config.openings = {"4k3/8/8/8/8/8/8/R3K3 w Q -", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -"};
+    SelfPlay::Stats stats = SelfPlay::generate(config, path);
+    ASSERT_EQ(6u, stats.games);
+    ASSERT_EQ(stats.games, stats.whiteWins + stats.blackWins + stats.draws);
+    ASSERT_EQ(stats.positions * sizeof(SelfPlay::Record), std::filesystem::file_size(path));
+
+    std::ifstream in(path, std::ios::binary);
+    SelfPlay::Record record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        Board board = record.unpack();
+        Board::Move move = record.unpackMove();
+        bool legal = false;
+        for (const Board::Move& candidate : board.generateMoves()) {
+            legal |= candidate.from == move.from && candidate.to == move.to && candidate.promotion == move.promotion;
+        }
+        ASSERT_TRUE(legal);
+        ASSERT_TRUE(record.result >= -1 && record.result <= 1);
+    }
+}
+TEST(selfplay_games_do_not_depend_on_threads) {
+    std::string one = (std::filesystem::temp_directory_path() / "chess_selfplay_one.bin").string();
+    std::string two = (std::filesystem::temp_directory_path() / "chess_selfplay_two.bin").string();
+    std::filesystem::remove(one);
+    std::filesystem::remove(two);
+    SelfPlay::Config config;
+    config.games = 4;
+    config.limits = {1, 0};
+    config.maxPlies = 10;
+    config.threads = 1;
+    SelfPlay::Stats a = SelfPlay::generate(config, one);
+    config.threads = 2;
+    SelfPlay::Stats b = SelfPlay::generate(config, two);
+    ASSERT_EQ(a.positions, b.positions);
+    ASSERT_EQ(a.draws, b.draws);
+}
@@ -0,0 +1,160 @@
+#ifdef __linux__
+#include "test.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "server/server.hpp"
+#include "util/spsc_queue.hpp"
+
+namespace {
+    Server::Reply send(Server::GameTable& table, Server::Command command, uint32_t gameId, const std::string& argument = "") {
+        Server::Request request{};
+        request.command = command;
+        request.gameId = gameId;
+        request.length = static_cast<uint16_t>(argument.size());
+        std::memcpy(request.argument, argument.data(), argument.size());
+        Server::Reply reply{};
+        table.handle(request, reply);
+        return reply;
+    }
+    std::string text(const Server::Reply& reply) {
+        return std::string(reply.text, reply.length);
+    }
+    std::string readLine(int fd) {
+        std::string line;
+        char c;
+        while (read(fd, &c, 1) == 1 && c != '\n') {
+            line += c;
+        }
+        return line;
+    }
+}
+
+TEST(spsc_queue_fills_and_drains_in_order) {
+    SpscQueue<int> queue(3);
+    ASSERT_EQ(4u, queue.capacity());
+    ASSERT_TRUE(queue.front() == nullptr);
+    for (int i = 0; i < 4; ++i) {
+        *queue.claim() = i;
+        queue.publish();
+    }
+    ASSERT_TRUE(queue.claim() == nullptr);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(i, *queue.front());
+        queue.pop();
+    }
+    ASSERT_TRUE(queue.front() == nullptr);
+}
+TEST(game_table_plays_moves) {
+    Server::GameTable table(8);
+    ASSERT_EQ(std::string("3 ok"), text(send(table, Server::NEW, 3)));
+    ASSERT_EQ(std::string("3 ok ongoing"), text(send(table, Server::MOVE, 3, "f2f3")));
+    ASSERT_EQ(std::string("3 error not that side's turn"), text(send(table, Server::MOVE, 3, "e2e4")));
+    send(table, Server::MOVE, 3, "e7e5");
+    send(table, Server::MOVE, 3, "g2g4");
+    ASSERT_EQ(std::string("3 ok checkmate"), text(send(table, Server::MOVE, 3, "d8h4")));
+    ASSERT_EQ(std::string("3 ok"), text(send(table, Server::MOVES, 3)));
+    std::string moves = text(send(table, Server::MOVES, 11));
+    ASSERT_EQ(std::string("11 error unknown game"), moves);
+}
+TEST(game_table_promotes_and_reports_fen) {
+    Server::GameTable table(4);
+    send(table, Server::NEW, 1, "7k/P7/8/8/8/8/8/K7 w - - 0 1");
+    std::string moves = text(send(table, Server::MOVES, 1));
+    ASSERT_TRUE(moves.find(" a7a8q") != std::string::npos);
+    ASSERT_EQ(std::string("1 ok ongoing"), text(send(table, Server::MOVE, 1, "a7a8r")));
+    ASSERT_EQ(std::string("1 ok R6k/8/8/8/8/8/8/K7 b - -"), text(send(table, Server::FEN, 1)));
+}
+TEST(game_table_rejects_closed_and_invalid_games) {
+    Server::GameTable table(4);
+    Server::Reply invalid = send(table, Server::NEW, 2, "8/8/8/8/8/8/8/8 w - -");
+    ASSERT_EQ(std::string("error invalid FEN"), text(invalid));
+    ASSERT_TRUE(invalid.freed);
+    send(table, Server::NEW, 2);
+    Server::Reply closed = send(table, Server::CLOSE, 2);
+    ASSERT_TRUE(closed.freed);
+    ASSERT_EQ(std::string("2 error unknown game"), text(send(table, Server::MOVE, 2, "e2e4")));
+    // same slot, next generation: the old id stays dead
+    send(table, Server::NEW, 6);
+    ASSERT_EQ(std::string("2 error unknown game"), text(send(table, Server::FEN, 2)));
+    ASSERT_EQ(std::string("6 ok ongoing"), text(send(table, Server::MOVE, 6, "e2e4")));
+}
+TEST(game_table_rejects_malformed_fens) {
+    Server::GameTable table(4);
+    const char* malformed[] = {
+        "4k3/8/8/8/8/8/8/4K3/q7 w - -",    // a ninth rank
+        "4k3/8/8/8/8/8/8/4KPPPPPPPP w - -", // a rank spilling into the next
+        "4k3/8/8/8/8/8/P7/4K3 w - a1",      // en passant square off rank 3 and 6
+        "4k3/8/8/8/8/8/P7/4K3 b - a3",      // en passant without the pushed pawn
+        "4k3/8/8/8/8/8/8/P3K3 w - -",       // pawn on the first rank
+        "4k3/8/8/8/8/8/8/4K2r b - -",       // white is in check with black to move
+        "4k3/8/8/8",
+    };
+    for (const char* fen : malformed) {
+        Server::Reply reply = send(table, Server::NEW, 1, fen);
+        ASSERT_EQ(std::string("error invalid FEN"), text(reply));
+        ASSERT_TRUE(reply.freed);
+        ASSERT_EQ(std::string("1 error unknown game"), text(send(table, Server::MOVES, 1)));
+    }
+    ASSERT_EQ(std::string("1 ok"), text(send(table, Server::NEW, 1, "4k3/8/8/8/8/8/P7/4K3 w - -")));
+}
+TEST(game_table_reports_threefold_repetition) {
+    Server::GameTable table(4);
+    send(table, Server::NEW, 1);
+    const char* shuffle[] = {"g1f3", "g8f6", "f3g1", "f6g8"};
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_EQ(std::string("1 ok ongoing"), text(send(table, Server::MOVE, 1, shuffle[i % 4])));
+    }
+    ASSERT_EQ(std::string("1 ok threefold"), text(send(table, Server::MOVE, 1, "f6g8")));
+    // the history is a fixed ring, so a game far longer than it still works
+    for (int i = 0; i < 600; ++i) {
+        ASSERT_EQ(std::string("1 ok threefold"), text(send(table, Server::MOVE, 1, shuffle[i % 4])));
+    }
+    // a new game in the slot starts with an empty history
+    send(table, Server::NEW, 5);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(std::string("5 ok ongoing"), text(send(table, Server::MOVE, 5, shuffle[i])));
+    }
+}
+TEST(game_table_rejects_unknown_promotions) {
+    Server::GameTable table(4);
+    send(table, Server::NEW, 1, "7k/P7/8/8/8/8/8/K7 w - -");
+    ASSERT_EQ(std::string("1 error illegal promotion"), text(send(table, Server::MOVE, 1, "a7a8x")));
+    ASSERT_EQ(std::string("1 error illegal promotion"), text(send(table, Server::MOVE, 1, "a7a8")));
+}
+TEST(session_server_over_unix_socket) {
+    Server::Config config;
+    config.maxGames = 16;
+    config.workers = 2;
+    Server::SessionServer server(config);
+    std::string path = "/tmp/chess_server_test_" + std::to_string(getpid()) + ".sock";
+    server.listenUnix(path);
+    std::thread loop([&server] { server.run(); });
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    ASSERT_EQ(0, connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+    std::string script = "new\nnew\r\nmove 0 e2e4\nmove 1 g1f3\nbogus\nclose 0\nmove 0 e7e5\nnew\n";
+    ASSERT_EQ(static_cast<ssize_t>(script.size()), write(fd, script.data(), script.size()));
+    std::string replies;
+    for (int i = 0; i < 8; ++i) {
+        replies += readLine(fd) + "|";
+    }
+    // replies for different games may interleave, so only check what is ordered
+    ASSERT_TRUE(replies.find("0 ok|") != std::string::npos);
+    ASSERT_TRUE(replies.find("1 ok|") != std::string::npos);
+    ASSERT_TRUE(replies.find("0 ok ongoing|") != std::string::npos);
+    ASSERT_TRUE(replies.find("1 ok ongoing|") != std::string::npos);
+    ASSERT_TRUE(replies.find("error unknown command|") != std::string::npos);
+    ASSERT_TRUE(replies.find("0 error unknown game|") != std::string::npos);
+    ASSERT_TRUE(replies.find("0 ok ongoing|") < replies.find("0 error unknown game|"));
+    close(fd);
+    server.stop();
+    loop.join();
+}
+#endif
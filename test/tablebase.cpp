@@ -0,0 +1,124 @@
+#include "test.h"
+#include "chess.hpp"
+#include "tablebase/tablebase.hpp"
+#include <filesystem>
+
+static std::string tablebaseDirectory() {
+    static std::string directory = []() {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "chess_tablebase_test";
+        std::filesystem::remove_all(path);
+        Tablebase::generate("KQvK", path.string(), 2);
+        return path.string();
+    }();
+    return directory;
+}
+
+// KPvK and everything it promotes or captures into, for the pawn un-moves and promotions
+static std::string pawnTablebaseDirectory() {
+    static std::string directory = []() {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "chess_tablebase_pawn_test";
+        std::filesystem::remove_all(path);
+        Tablebase::generate("KPvK", path.string(), 2);
+        return path.string();
+    }();
+    return directory;
+}
+
+TEST(tablebase_material_names) {
+    ASSERT_EQ(std::string("KQvK"), Tablebase::Material("KvKQ").name());
+    ASSERT_EQ(std::string("KRNvKP"), Tablebase::Material("KNRvKP").name());
+    ASSERT_EQ(2ULL << 18, Tablebase::Material("KQvK").size());
+    ASSERT_THROWS(std::invalid_argument, []() {
+        Tablebase::Material("KQK");
+    });
+    ASSERT_THROWS(std::invalid_argument, []() {
+        Tablebase::Material("QvK");
+    });
+    ASSERT_THROWS(std::invalid_argument, []() {
+        Tablebase::Material("KQRBNvK");
+    });
+}
+TEST(tablebase_successors) {
+    std::vector<std::string> successors = Tablebase::Material("KPvK").successors();
+    std::vector<std::string> expected = {"KBvK", "KNvK", "KQvK", "KRvK", "KvK"};
+    ASSERT_EQ(expected.size(), successors.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i], successors[i]);
+    }
+}
+TEST(tablebase_generates_files) {
+    std::string directory = tablebaseDirectory();
+    ASSERT_TRUE(std::filesystem::exists(std::filesystem::path(directory) / "KQvK.ctb"));
+    ASSERT_TRUE(std::filesystem::exists(std::filesystem::path(directory) / "KvK.ctb"));
+}
+TEST(tablebase_probe_mate_in_one) {
+    Tablebase::Tablebases tables;
+    ASSERT_EQ(2, tables.addDirectory(tablebaseDirectory()));
+    Tablebase::ProbeResult result;
+    ASSERT_TRUE(tables.probe(Board("k7/8/1K6/8/8/8/7Q/8 w - -"), result));
+    ASSERT_EQ(Tablebase::WIN, result.outcome);
+    ASSERT_EQ(1, result.pliesToMate);
+}
+TEST(tablebase_probe_checkmated) {
+    Tablebase::Tablebases tables;
+    tables.addDirectory(tablebaseDirectory());
+    Tablebase::ProbeResult result;
+    ASSERT_TRUE(tables.probe(Board("k7/1Q6/1K6/8/8/8/8/8 b - -"), result));
+    ASSERT_EQ(Tablebase::LOSS, result.outcome);
+    ASSERT_EQ(0, result.pliesToMate);
+}
+TEST(tablebase_probe_draw_by_capture) {
+    Tablebase::Tablebases tables;
+    tables.addDirectory(tablebaseDirectory());
+    Tablebase::ProbeResult result;
+    ASSERT_TRUE(tables.probe(Board("8/8/8/8/8/2k5/2Q5/7K b - -"), result));
+    ASSERT_EQ(Tablebase::DRAW, result.outcome);
+}
+TEST(tablebase_probe_colour_flipped) {
+    Tablebase::Tablebases tables;
+    tables.addDirectory(tablebaseDirectory());
+    Tablebase::ProbeResult result;
+    ASSERT_TRUE(tables.probe(Board("8/7q/8/8/8/1k6/8/K7 b - -"), result));
+    ASSERT_EQ(Tablebase::WIN, result.outcome);
+    ASSERT_EQ(1, result.pliesToMate);
+}
+TEST(tablebase_probe_longest_mate) {
+    // every KQvK position is mated within ten moves
+    Tablebase::Tablebases tables;
+    tables.addDirectory(tablebaseDirectory());
+    Tablebase::ProbeResult result;
+    ASSERT_TRUE(tables.probe(Board("8/8/8/3k4/8/8/8/KQ6 b - -"), result));
+    ASSERT_EQ(Tablebase::LOSS, result.outcome);
+    ASSERT_LTEQ(result.pliesToMate, 20);
+}
+TEST(tablebase_probe_missing_table) {
+    Tablebase::Tablebases tables;
+    tables.addDirectory(tablebaseDirectory());
+    Tablebase::ProbeResult result;
+    ASSERT_FALSE(tables.probe(Board("4k3/8/8/8/8/8/8/R3K3 w - -"), result));
+}
+TEST(tablebase_probe_pawn_ending_won) {
+    // king on the sixth in front of its pawn wins whoever is to move
+    Tablebase::Tablebases tables;
+    ASSERT_EQ(6, tables.addDirectory(pawnTablebaseDirectory()));
+    Tablebase::ProbeResult result;
+    ASSERT_TRUE(tables.probe(Board("4k3/8/4K3/4P3/8/8/8/8 w - -"), result));
+    ASSERT_EQ(Tablebase::WIN, result.outcome);
+    ASSERT_GT(result.pliesToMate, 0);
+    ASSERT_TRUE(tables.probe(Board("4k3/8/4K3/4P3/8/8/8/8 b - -"), result));
+    ASSERT_EQ(Tablebase::LOSS, result.outcome);
+    // promotion next move, with black's pieces on the other colour
+    ASSERT_TRUE(tables.probe(Board("8/8/8/8/8/8/1kp5/4K3 b - -"), result));
+    ASSERT_EQ(Tablebase::WIN, result.outcome);
+}
+TEST(tablebase_probe_pawn_ending_drawn) {
+    Tablebase::Tablebases tables;
+    tables.addDirectory(pawnTablebaseDirectory());
+    Tablebase::ProbeResult result;
+    // stalemate: the pawn covers b8 and the king covers b7
+    ASSERT_TRUE(tables.probe(Board("k7/P7/1K6/8/8/8/8/8 b - -"), result));
+    ASSERT_EQ(Tablebase::DRAW, result.outcome);
+    // the defending king sits in front of a rook pawn
+    ASSERT_TRUE(tables.probe(Board("k7/8/8/8/P7/8/8/4K3 w - -"), result));
+    ASSERT_EQ(Tablebase::DRAW, result.outcome);
+}
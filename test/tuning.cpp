@@ -0,0 +1,131 @@
+#include "test.h"
+#include <cmath>
+#include <sstream>
+#include "chess.hpp"
+#include "eval/evaluation.hpp"
+#include "eval/tuning.hpp"
+
+namespace {
+    // positions from random games, labelled with a made-up result
+    std::vector<Tuning::Position> randomPositions(int count) {
+        std::vector<Tuning::Position> positions;
+        const char* results[3] = {"1-0", "1/2-1/2", "0-1"};
+        Board board;
+        uint64_t seed = 2024;
+        while (static_cast<int>(positions.size()) < count) {
+            Board::MoveList moves = board.generateMoves();
+            if (moves.size() == 0 || board.isFiftyMoveRule()) {
+                board = Board();
+                continue;
+            }
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            board.makeMove(moves[static_cast<int>((seed >> 33) % moves.size())]);
+            Tuning::Position position;
+            if (Tuning::parseLine(board.generateFEN() + " " + results[(seed >> 20) % 3], position)) {
+                positions.push_back(position);
+            }
+        }
+        return positions;
+    }
+}
+
+TEST(tuning_parse_labels) {
+    Tuning::Position position;
+    ASSERT_TRUE(Tuning::parseLine("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 [0.5]", position));
+    ASSERT_TRUE(position.result == 0.5f);
+    ASSERT_EQ(24, static_cast<int>(position.phase));
+    ASSERT_TRUE(Tuning::parseLine("4k3/8/8/8/8/8/4P3/4K3 w - - c9 \"1-0\";", position));
+    ASSERT_TRUE(position.result == 1.0f);
+    ASSERT_EQ(0, static_cast<int>(position.phase));
+    ASSERT_EQ(1ULL << 12, position.pieces.piece(Board::WHITE_PAWN));
+    ASSERT_TRUE(Tuning::parseLine("4k3/8/8/8/8/8/4P3/4K3 b - - 3 40 0-1", position));
+    ASSERT_TRUE(position.result == 0.0f);
+
+    // move counters are not results, and neither is anything else
+    ASSERT_FALSE(Tuning::parseLine("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1", position));
+    ASSERT_FALSE(Tuning::parseLine("4k3/8/8/8/8/8/4P3/4K3 w - - draw", position));
+    ASSERT_FALSE(Tuning::parseLine("not a position 1-0", position));
+    ASSERT_FALSE(Tuning::parseLine("", position));
+
+    std::istringstream in("4k3/8/8/8/8/8/4P3/4K3 w - - 1-0\n\nbroken 1-0\r\n4k3/8/8/8/8/8/4P3/4K3 w - - 0-1\r\n");
+    size_t skipped = 0;
+    std::vector<Tuning::Position> positions = Tuning::load(in, 2, &skipped);
+    ASSERT_EQ(2u, positions.size());
+    ASSERT_EQ(1u, skipped);
+    ASSERT_TRUE(positions[0].result == 1.0f && positions[1].result == 0.0f);
+}
+TEST(tuning_defaults_match_evaluation) {
+    Tuning::Parameters parameters = Tuning::defaults();
+    ASSERT_EQ(static_cast<size_t>(Tuning::PARAMETER_COUNT), parameters.size());
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+        "2b1kb2/8/8/8/8/8/8/2B1K3 b - -",
+    };
+    for (const char* fen : fens) {
+        Tuning::Position position;
+        ASSERT_TRUE(Tuning::parseLine(std::string(fen) + " 1/2-1/2", position));
+        // the evaluator rounds the phase blend down, the tuner does not
+        double difference = Tuning::evaluate(position, parameters) - Evaluation::evaluate(Board(fen));
+        ASSERT_TRUE(std::fabs(difference) < 1);
+    }
+}
+TEST(tuning_gradient_matches_finite_differences) {
+    std::vector<Tuning::Position> positions = randomPositions(300);
+    Tuning::Config config;
+    config.threads = 3;
+    Tuning::Tuner tuner(positions, config);
+    Tuning::Parameters parameters = Tuning::defaults();
+    double scale = tuner.fitScale(parameters);
+    ASSERT_TRUE(scale > 0 && scale < 10);
+
+    Tuning::Parameters gradient;
+    double loss = tuner.gradient(parameters, gradient);
+    ASSERT_TRUE(std::fabs(loss - tuner.loss(parameters)) < 1e-12);
+    int checked[] = {Tuning::MATERIAL_OFFSET + 1, Tuning::MATERIAL_OFFSET + 4,
+                     Tuning::PIECE_SQUARE_OFFSET + 8 + 4,               // middlegame pawn on e7 / e2
+                     Tuning::PIECE_SQUARE_OFFSET + 64 * 6 + 64 + 27,    // endgame knight
+                     Tuning::BISHOP_PAIR_OFFSET, Tuning::BISHOP_PAIR_OFFSET + 1};
+    for (int index : checked) {
+        Tuning::Parameters shifted = parameters;
+        shifted[index] += 0.01;
+        double above = tuner.loss(shifted);
+        shifted[index] -= 0.02;
+        double below = tuner.loss(shifted);
+        double numeric = (above - below) / 0.02;
+        ASSERT_TRUE(std::fabs(numeric - gradient[index]) <= 1e-6 * std::fabs(gradient[index]) + 1e-12);
+    }
+
+    // the same sums whichever way the positions are split
+    config.threads = 1;
+    Tuning::Tuner single(positions, config);
+    single.setScale(scale);
+    Tuning::Parameters singleGradient;
+    single.gradient(parameters, singleGradient);
+    double largest = 0;
+    for (int i = 0; i < Tuning::PARAMETER_COUNT; ++i) {
+        largest = std::max(largest, std::fabs(singleGradient[i] - gradient[i]));
+    }
+    ASSERT_TRUE(largest < 1e-15);
+}
+TEST(tuning_lowers_the_loss) {
+    std::vector<Tuning::Position> positions = randomPositions(500);
+    Tuning::Config config;
+    config.threads = 2;
+    config.epochs = 50;
+    Tuning::Tuner tuner(positions, config);
+    Tuning::Parameters parameters = Tuning::defaults();
+    tuner.fitScale(parameters);
+    double before = tuner.loss(parameters);
+    int epochs = 0;
+    tuner.tune(parameters, [&](int, double) { epochs++; });
+    ASSERT_EQ(50, epochs);
+    ASSERT_TRUE(tuner.loss(parameters) < before);
+    ASSERT_EQ(0.0, parameters[Tuning::MATERIAL_OFFSET + 5]);
+
+    std::string source = Tuning::toSource(parameters);
+    ASSERT_TRUE(source.find("inline constexpr int PIECE_SQUARE[2][6][64] = {") != std::string::npos);
+    ASSERT_TRUE(source.find("{ // king") != std::string::npos);
+    ASSERT_THROWS(std::invalid_argument, [] { Tuning::Tuner(std::vector<Tuning::Position>(), Tuning::Config()); });
+}
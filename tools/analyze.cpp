@@ -0,0 +1,92 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "search/search.hpp"
+
+// Searches positions to a fixed depth, one FEN per line, e.g.
+// `analyze -d 8 -c analysis.cache positions.txt`. Prints each FEN with the best
+// move, score and depth. With -c, results are kept in a memory-mapped cache
+// file, so positions analysed by an earlier run, or by another process using
+// the same file at the same time, are answered without searching again.
+int main(int argc, char* argv[])
+{
+    Search::Limits limits;
+    limits.depth = 6;
+    std::string cachePath;
+    size_t cacheMegabytes = 64;
+    std::string input;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-d" && i + 1 < argc)
+        {
+            limits.depth = std::stoi(argv[++i]);
+        }
+        else if (argument == "-c" && i + 1 < argc)
+        {
+            cachePath = argv[++i];
+        }
+        else if (argument == "-m" && i + 1 < argc)
+        {
+            cacheMegabytes = std::stoull(argv[++i]);
+        }
+        else if (input.empty() && argument[0] != '-')
+        {
+            input = argument;
+        }
+        else
+        {
+            std::cerr << "usage: analyze [-d depth] [-c cache file] [-m new cache MB] [positions.txt]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ifstream file;
+    if (!input.empty())
+    {
+        file.open(input);
+        if (!file)
+        {
+            std::cerr << "analyze: cannot open " << input << std::endl;
+            return 1;
+        }
+    }
+    std::istream& positions = input.empty() ? std::cin : file;
+
+    Search::Searcher searcher;
+    std::unique_ptr<Search::AnalysisCache> cache;
+    if (!cachePath.empty())
+    {
+        try
+        {
+            cache = std::make_unique<Search::AnalysisCache>(cachePath, cacheMegabytes << 20);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "analyze: " << e.what() << std::endl;
+            return 1;
+        }
+        searcher.setCache(cache.get());
+    }
+    for (std::string fen; std::getline(positions, fen);)
+    {
+        if (fen.empty())
+        {
+            continue;
+        }
+        try
+        {
+            Board board(fen);
+            Search::Result result = searcher.search(board, limits);
+            std::cout << fen << '\t' << (result.move.from >= 0 ? board.toSAN(result.move) : "none") << '\t'
+                      << result.score << "\tdepth " << result.depth << '\n';
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "analyze: " << fen << ": " << e.what() << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "book/polyglot.hpp"
+#include "pgn/pgn.hpp"
+
+// Builds a Polyglot book from a PGN file, e.g. `bookgen -p 20 -m 3 games.pgn book.bin`.
+int main(int argc, char* argv[])
+{
+    int maxPly = 24;
+    uint32_t minGames = 1;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-p" && i + 1 < argc)
+        {
+            maxPly = std::stoi(argv[++i]);
+        }
+        else if (argument == "-m" && i + 1 < argc)
+        {
+            minGames = std::stoul(argv[++i]);
+        }
+        else
+        {
+            files.push_back(argument);
+        }
+    }
+    if (files.size() != 2)
+    {
+        std::cerr << "usage: bookgen [-p max plies] [-m min games] games.pgn book.bin" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(files[0]);
+    if (!in)
+    {
+        std::cerr << "bookgen: cannot open " << files[0] << std::endl;
+        return 1;
+    }
+    Polyglot::BookBuilder builder;
+    Pgn::Reader reader(in);
+    Pgn::Game game;
+    int games = 0;
+    int skipped = 0;
+    while (reader.next(game))
+    {
+        Polyglot::BookBuilder::Result result;
+        if (game.result == "1-0")
+        {
+            result = Polyglot::BookBuilder::WIN;
+        }
+        else if (game.result == "0-1")
+        {
+            result = Polyglot::BookBuilder::LOSS;
+        }
+        else if (game.result == "1/2-1/2")
+        {
+            result = Polyglot::BookBuilder::DRAW;
+        }
+        else
+        {
+            ++skipped;
+            continue;
+        }
+        try
+        {
+            Board start = game.startFen.empty() ? Board() : Board(game.startFen);
+            Board board = start;
+            std::vector<Board::Move> moves;
+            for (size_t ply = 0; ply < game.moves.size() && static_cast<int>(ply) < maxPly; ++ply)
+            {
+                moves.push_back(board.parseSAN(game.moves[ply]));
+                board.makeMove(moves.back());
+            }
+            builder.addGame(start, moves, result, maxPly);
+            ++games;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "bookgen: skipping game " << games + skipped + 1 << ": " << e.what() << std::endl;
+            ++skipped;
+        }
+    }
+
+    try
+    {
+        builder.write(files[1], minGames);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "bookgen: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << games << " games, " << skipped << " skipped, " << builder.size() << " distinct moves" << std::endl;
+    return 0;
+}
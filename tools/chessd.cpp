@@ -0,0 +1,79 @@
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "server/server.hpp"
+
+namespace {
+    Server::SessionServer* running = nullptr;
+    void shutdown(int) { running->stop(); }
+}
+
+// Hosts many concurrent games behind one socket, e.g.
+// `chessd -p 7000 -g 50000 -j 8` or `chessd -u /tmp/chessd.sock`. Clients send
+// one command per line; see src/server/server.hpp for the protocol. Runs until
+// interrupted.
+int main(int argc, char* argv[])
+{
+    Server::Config config;
+    int port = -1;
+    std::string address = "127.0.0.1";
+    std::string socketPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-p" && i + 1 < argc)
+        {
+            port = std::stoi(argv[++i]);
+        }
+        else if (argument == "-a" && i + 1 < argc)
+        {
+            address = argv[++i];
+        }
+        else if (argument == "-u" && i + 1 < argc)
+        {
+            socketPath = argv[++i];
+        }
+        else if (argument == "-g" && i + 1 < argc)
+        {
+            config.maxGames = std::stoul(argv[++i]);
+        }
+        else if (argument == "-j" && i + 1 < argc)
+        {
+            config.workers = std::stoi(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "usage: chessd [-p port] [-a address] [-u socket path] [-g max games] [-j workers]" << std::endl;
+            return 1;
+        }
+    }
+    if (port < 0 && socketPath.empty())
+    {
+        port = 7000;
+    }
+
+    try
+    {
+        Server::SessionServer server(config);
+        if (port >= 0)
+        {
+            std::cerr << "chessd: listening on " << address << ":" << server.listenTcp(port, address) << std::endl;
+        }
+        if (!socketPath.empty())
+        {
+            server.listenUnix(socketPath);
+            std::cerr << "chessd: listening on " << socketPath << std::endl;
+        }
+        running = &server;
+        std::signal(SIGINT, shutdown);
+        std::signal(SIGTERM, shutdown);
+        server.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "chessd: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "distributed/distributed.hpp"
+
+namespace {
+    Distributed::Coordinator* running = nullptr;
+    void shutdown(int) { running->stop(); }
+}
+
+// Splits a job file (one FEN or EPD per line) into units for worker processes,
+// e.g. `coordinator -t perft -d 5 -k job.ckpt -l 8 positions.epd results.txt`
+// or `coordinator -p 7100 -a 0.0.0.0 -d 10 positions.epd` with `worker -h host
+// -p 7100` started on each machine. -l forks local workers, sharing the search
+// cache given with -c, and restarts them if they die. With -k, finished units
+// are checkpointed and a rerun of the same command picks up where the last one
+// stopped. Prints each line with its result
+// once every unit is done.
+int main(int argc, char* argv[])
+{
+    Distributed::CoordinatorConfig config;
+    int port = -1;
+    std::string address = "127.0.0.1";
+    std::string socketPath;
+    std::string input;
+    std::string output;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-p" && i + 1 < argc)
+        {
+            port = std::stoi(argv[++i]);
+        }
+        else if (argument == "-a" && i + 1 < argc)
+        {
+            address = argv[++i];
+        }
+        else if (argument == "-u" && i + 1 < argc)
+        {
+            socketPath = argv[++i];
+        }
+        else if (argument == "-t" && i + 1 < argc)
+        {
+            std::string task = argv[++i];
+            usage |= task != "search" && task != "perft";
+            config.job.task = task == "perft" ? Distributed::PERFT : Distributed::SEARCH;
+        }
+        else if (argument == "-d" && i + 1 < argc)
+        {
+            config.job.depth = std::stoi(argv[++i]);
+        }
+        else if (argument == "-n" && i + 1 < argc)
+        {
+            config.unitSize = std::stoul(argv[++i]);
+        }
+        else if (argument == "-k" && i + 1 < argc)
+        {
+            config.checkpointPath = argv[++i];
+        }
+        else if (argument == "-c" && i + 1 < argc)
+        {
+            config.worker.cachePath = argv[++i];
+        }
+        else if (argument == "-L" && i + 1 < argc)
+        {
+            config.leaseSeconds = std::stoi(argv[++i]);
+        }
+        else if (argument == "-l" && i + 1 < argc)
+        {
+            config.localWorkers = std::stoi(argv[++i]);
+        }
+        else if (input.empty() && argument[0] != '-')
+        {
+            input = argument;
+        }
+        else if (output.empty() && argument[0] != '-')
+        {
+            output = argument;
+        }
+        else
+        {
+            usage = true;
+        }
+    }
+    if (usage || input.empty())
+    {
+        std::cerr << "usage: coordinator [-t search|perft] [-d depth] [-n positions per unit] [-k checkpoint]"
+                     " [-L lease seconds] [-l local workers [-c cache file]] [-p port] [-a address]"
+                     " [-u socket path] job.epd [output]"
+                  << std::endl;
+        return 1;
+    }
+    if (port < 0 && socketPath.empty())
+    {
+        port = 7100;
+    }
+
+    std::ifstream file(input);
+    if (!file)
+    {
+        std::cerr << "coordinator: cannot open " << input << std::endl;
+        return 1;
+    }
+    std::vector<std::string> positions;
+    for (std::string line; std::getline(file, line);)
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (!line.empty())
+        {
+            positions.push_back(line);
+        }
+    }
+
+    try
+    {
+        Distributed::Coordinator coordinator(positions, config);
+        if (port >= 0)
+        {
+            std::cerr << "coordinator: listening on " << address << ":" << coordinator.listenTcp(port, address)
+                      << std::endl;
+        }
+        if (!socketPath.empty())
+        {
+            coordinator.listenUnix(socketPath);
+            std::cerr << "coordinator: listening on " << socketPath << std::endl;
+        }
+        running = &coordinator;
+        std::signal(SIGINT, shutdown);
+        std::signal(SIGTERM, shutdown);
+        std::vector<std::string> results = coordinator.run();
+        Distributed::Progress progress = coordinator.progress();
+        std::cerr << "coordinator: " << progress.finished << " units analysed, " << progress.resumed
+                  << " resumed from the checkpoint, " << progress.requeued << " requeued, " << progress.restarts
+                  << " worker restarts" << std::endl;
+        if (results.empty() && !positions.empty())
+        {
+            std::cerr << "coordinator: stopped with " << progress.units - progress.finished - progress.resumed
+                      << " units left" << std::endl;
+            return 1;
+        }
+
+        std::ofstream outputFile;
+        if (!output.empty())
+        {
+            outputFile.open(output);
+            if (!outputFile)
+            {
+                std::cerr << "coordinator: cannot write " << output << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& out = output.empty() ? std::cout : outputFile;
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            out << positions[i] << '\t' << results[i] << '\n';
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "coordinator: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
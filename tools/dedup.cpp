@@ -0,0 +1,92 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "dedup/dedup.hpp"
+
+// Removes repeated positions from a corpus, keeping the first copy of each, e.g.
+// `dedup -f epd -j 8 positions.epd unique.epd` or `dedup -f bin -x 2048 games.bin unique.bin`.
+// -b adds a Bloom filter pre-pass so only likely duplicates are held exactly, and
+// -x MB sorts keys on disk in runs of that size for corpora larger than memory.
+int main(int argc, char* argv[])
+{
+    Dedup::Config config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string input;
+    std::string output = "-";
+    int positional = 0;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "-f" && hasValue)
+        {
+            std::string format = argv[++i];
+            if (format == "fen")
+            {
+                config.format = Dedup::FEN;
+            }
+            else if (format == "epd")
+            {
+                config.format = Dedup::EPD;
+            }
+            else if (format == "bin")
+            {
+                config.format = Dedup::PACKED;
+            }
+            else
+            {
+                usage = true;
+            }
+        }
+        else if (argument == "-j" && hasValue)
+        {
+            config.threads = std::stoi(argv[++i]);
+        }
+        else if (argument == "-b")
+        {
+            config.bloom = true;
+        }
+        else if (argument == "-m" && hasValue)
+        {
+            config.bloomBytes = std::stoull(argv[++i]) << 20;
+        }
+        else if (argument == "-x" && hasValue)
+        {
+            config.externalBytes = std::stoull(argv[++i]) << 20;
+        }
+        else if (argument == "-t" && hasValue)
+        {
+            config.tempDirectory = argv[++i];
+        }
+        else if ((argument == "-" || argument[0] != '-') && positional < 2)
+        {
+            (positional++ == 0 ? input : output) = argument;
+        }
+        else
+        {
+            usage = true;
+        }
+    }
+    if (usage || input.empty())
+    {
+        std::cerr << "usage: dedup [-f fen|epd|bin] [-j threads] [-b [-m bloom MB]] [-x run MB [-t temp dir]] input|- [output]"
+                  << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        Dedup::Stats stats = Dedup::deduplicate(config, input, output);
+        std::cerr << "dedup: " << stats.records << " records, " << stats.unique << " unique, "
+                  << stats.records - stats.unique - stats.invalid << " duplicates, " << stats.invalid << " invalid"
+                  << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "dedup: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "search/mate.hpp"
+
+// Checks positions for forced mates, one FEN per line, e.g.
+// `matesolve -m 3 -u puzzles.txt`. Prints each FEN with "mate N" and the mating
+// line, "no mate" or "unknown". -u also prints how many first moves force mate,
+// so puzzles with more than one solution can be filtered out.
+int main(int argc, char* argv[])
+{
+    Mate::Limits limits;
+    bool countSolutions = false;
+    std::string input;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-u")
+        {
+            countSolutions = true;
+        }
+        else if (argument == "-m" && i + 1 < argc)
+        {
+            limits.maxPly = 2 * std::stoi(argv[++i]) - 1;
+        }
+        else if (argument == "-n" && i + 1 < argc)
+        {
+            limits.nodes = std::stoull(argv[++i]);
+        }
+        else if (input.empty() && argument[0] != '-')
+        {
+            input = argument;
+        }
+        else
+        {
+            std::cerr << "usage: matesolve [-m max mate moves] [-n nodes] [-u] [positions.txt]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ifstream file;
+    if (!input.empty())
+    {
+        file.open(input);
+        if (!file)
+        {
+            std::cerr << "matesolve: cannot open " << input << std::endl;
+            return 1;
+        }
+    }
+    std::istream& positions = input.empty() ? std::cin : file;
+
+    Mate::Solver solver;
+    for (std::string fen; std::getline(positions, fen);)
+    {
+        if (fen.empty())
+        {
+            continue;
+        }
+        try
+        {
+            Board board(fen);
+            Mate::Result result = solver.solve(board, limits);
+            std::cout << fen << '\t';
+            if (result.status == Mate::MATE)
+            {
+                std::cout << "mate " << result.mateIn << '\t';
+                Board line = board;
+                for (const Board::Move& move : result.pv)
+                {
+                    std::cout << line.toSAN(move) << ' ';
+                    line.makeMove(move);
+                }
+                if (countSolutions)
+                {
+                    bool complete = false;
+                    size_t solutions = solver.matingMoves(board, {2 * result.mateIn - 1, limits.nodes}, &complete).size();
+                    std::cout << '\t' << solutions << (complete ? "" : "+") << " solutions";
+                }
+            }
+            else
+            {
+                std::cout << (result.status == Mate::NO_MATE ? "no mate" : "unknown");
+            }
+            std::cout << '\n';
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "matesolve: " << fen << ": " << e.what() << std::endl;
+        }
+    }
+    return 0;
+}
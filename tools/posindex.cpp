@@ -0,0 +1,71 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "index/position_index.hpp"
+#include "pgn/pgn.hpp"
+
+// Builds or queries a position index:
+//   posindex build games.pgn games.cpi   (game ids count from 0 in file order)
+//   posindex query games.cpi "<FEN>"
+int main(int argc, char* argv[])
+{
+    if (argc != 4 || (std::string(argv[1]) != "build" && std::string(argv[1]) != "query"))
+    {
+        std::cerr << "usage: posindex build games.pgn index.cpi | posindex query index.cpi FEN" << std::endl;
+        return 1;
+    }
+    try
+    {
+        if (std::string(argv[1]) == "query")
+        {
+            PositionIndex::Index index(argv[2]);
+            std::vector<uint32_t> games = index.games(Board(argv[3]));
+            for (uint32_t game : games)
+            {
+                std::cout << game << "\n";
+            }
+            std::cerr << games.size() << " games" << std::endl;
+            return 0;
+        }
+
+        std::ifstream in(argv[2]);
+        if (!in)
+        {
+            throw std::runtime_error(std::string("cannot open ") + argv[2]);
+        }
+        PositionIndex::Writer writer(argv[3]);
+        Pgn::Reader reader(in);
+        Pgn::Game game;
+        uint32_t id = 0;
+        for (; reader.next(game); ++id)
+        {
+            // a game with an unreadable move is indexed up to that move
+            Board start = game.startFen.empty() ? Board() : Board(game.startFen);
+            Board board = start;
+            std::vector<Board::Move> moves;
+            try
+            {
+                for (const std::string& san : game.moves)
+                {
+                    moves.push_back(board.parseSAN(san));
+                    board.makeMove(moves.back());
+                }
+            }
+            catch (const std::invalid_argument& e)
+            {
+                std::cerr << "posindex: game " << id << ": " << e.what() << std::endl;
+            }
+            writer.addGame(id, start, moves);
+        }
+        writer.finish();
+        std::cout << id << " games indexed" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "posindex: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
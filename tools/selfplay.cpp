@@ -0,0 +1,112 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "selfplay/selfplay.hpp"
+#include "util/instrumentation.hpp"
+
+// Plays self-play games for training data, e.g.
+// `selfplay -o games.bin -g 10000 -d 6 -b openings.txt`. -t prints hot-path timings
+// when the library is built with CHESS_INSTRUMENTATION.
+int main(int argc, char* argv[])
+{
+    SelfPlay::Config config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string output;
+    bool printStats = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-t")
+        {
+            printStats = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            output.clear();
+            break;
+        }
+        if (argument == "-o")
+        {
+            output = argv[++i];
+        }
+        else if (argument == "-g")
+        {
+            config.games = std::stoi(argv[++i]);
+        }
+        else if (argument == "-j")
+        {
+            config.threads = std::stoi(argv[++i]);
+        }
+        else if (argument == "-d")
+        {
+            config.limits = {std::stoi(argv[++i]), 0};
+        }
+        else if (argument == "-n")
+        {
+            config.limits = {0, std::stoull(argv[++i])};
+        }
+        else if (argument == "-r")
+        {
+            config.randomPlies = std::stoi(argv[++i]);
+        }
+        else if (argument == "-s")
+        {
+            config.seed = std::stoull(argv[++i]);
+        }
+        else if (argument == "-b")
+        {
+            std::ifstream openings(argv[++i]);
+            if (!openings)
+            {
+                std::cerr << "selfplay: cannot open " << argv[i] << std::endl;
+                return 1;
+            }
+            for (std::string line; std::getline(openings, line);)
+            {
+                if (!line.empty())
+                {
+                    config.openings.push_back(line);
+                }
+            }
+        }
+        else
+        {
+            output.clear();
+            break;
+        }
+    }
+    if (output.empty())
+    {
+        std::cerr << "usage: selfplay -o output.bin [-g games] [-j threads] [-d depth | -n nodes] "
+                     "[-r random plies] [-s seed] [-b openings.txt] [-t]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        auto start = std::chrono::steady_clock::now();
+        SelfPlay::Stats stats = SelfPlay::generate(config, output);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << stats.games << " games, " << stats.positions << " positions (+" << stats.whiteWins << " ="
+                  << stats.draws << " -" << stats.blackWins << ") in " << seconds << "s, "
+                  << static_cast<uint64_t>(stats.positions / std::max(seconds, 1e-9)) << " positions/s" << std::endl;
+        if (printStats)
+        {
+            if (!Instrumentation::enabled)
+            {
+                std::cerr << "selfplay: built without CHESS_INSTRUMENTATION, no timings recorded" << std::endl;
+            }
+            std::cout << Instrumentation::toTable();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "selfplay: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tablebase/tablebase.hpp"
+
+// Generates endgame tables, e.g. `tbgen -o tables KQvK KRvK KPvK`.
+int main(int argc, char* argv[])
+{
+    std::string directory = ".";
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> materials;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc)
+        {
+            directory = argv[++i];
+        }
+        else if (argument == "-j" && i + 1 < argc)
+        {
+            threads = std::stoi(argv[++i]);
+        }
+        else
+        {
+            materials.push_back(argument);
+        }
+    }
+    if (materials.empty())
+    {
+        std::cerr << "usage: tbgen [-o directory] [-j threads] MATERIAL..." << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        for (const std::string& material : materials)
+        {
+            Tablebase::generate(material, directory, threads, &std::cout);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "tbgen: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
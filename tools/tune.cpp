@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "eval/tuning.hpp"
+
+// Tunes the evaluation tables against game results, e.g.
+// `tune -j 8 -e 1000 labelled.epd tuned_tables.hpp`. Each input line is a FEN or
+// EPD followed by the result (1-0, 0-1, 1/2-1/2, or 1.0/0.5/0.0, optionally in
+// brackets or quotes). Writes the tuned MATERIAL, BISHOP_PAIR and PIECE_SQUARE
+// tables in the layout of src/eval/evaluation_tables.hpp, to paste over the
+// current ones.
+int main(int argc, char* argv[])
+{
+    Tuning::Config config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    double scale = 0;
+    std::string input;
+    std::string output;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-j" && i + 1 < argc)
+        {
+            config.threads = std::stoi(argv[++i]);
+        }
+        else if (argument == "-e" && i + 1 < argc)
+        {
+            config.epochs = std::stoi(argv[++i]);
+        }
+        else if (argument == "-r" && i + 1 < argc)
+        {
+            config.learningRate = std::stod(argv[++i]);
+        }
+        else if (argument == "-k" && i + 1 < argc)
+        {
+            scale = std::stod(argv[++i]);
+        }
+        else if (input.empty() && argument[0] != '-')
+        {
+            input = argument;
+        }
+        else if (output.empty() && argument[0] != '-')
+        {
+            output = argument;
+        }
+        else
+        {
+            std::cerr << "usage: tune [-j threads] [-e epochs] [-r learning rate] [-k scale] labelled.epd [tables.hpp]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (input.empty())
+    {
+        std::cerr << "usage: tune [-j threads] [-e epochs] [-r learning rate] [-k scale] labelled.epd [tables.hpp]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(input);
+    if (!file)
+    {
+        std::cerr << "tune: cannot open " << input << std::endl;
+        return 1;
+    }
+    try
+    {
+        auto start = std::chrono::steady_clock::now();
+        size_t skipped = 0;
+        std::vector<Tuning::Position> positions = Tuning::load(file, config.threads, &skipped);
+        std::cerr << "tune: " << positions.size() << " positions loaded, " << skipped << " lines skipped" << std::endl;
+
+        Tuning::Tuner tuner(positions, config);
+        Tuning::Parameters parameters = Tuning::defaults();
+        if (scale > 0)
+        {
+            tuner.setScale(scale);
+        }
+        else
+        {
+            std::cerr << "tune: fitted k = " << tuner.fitScale(parameters) << std::endl;
+        }
+        double before = tuner.loss(parameters);
+        tuner.tune(parameters, [&](int epoch, double loss) {
+            if (epoch % 50 == 0 || epoch == config.epochs)
+            {
+                std::cerr << "tune: epoch " << epoch << " loss " << loss << std::endl;
+            }
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "tune: loss " << before << " -> " << tuner.loss(parameters) << " in " << seconds << " s"
+                  << std::endl;
+
+        std::ofstream outputFile;
+        if (!output.empty())
+        {
+            outputFile.open(output);
+            if (!outputFile)
+            {
+                std::cerr << "tune: cannot write " << output << std::endl;
+                return 1;
+            }
+        }
+        (output.empty() ? std::cout : outputFile) << Tuning::toSource(parameters);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "tune: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
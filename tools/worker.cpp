@@ -0,0 +1,62 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "distributed/distributed.hpp"
+
+// Works on units from a coordinator until the job is done, e.g.
+// `worker -h 10.0.0.5 -p 7100` or `worker -u /tmp/job.sock -c analysis.cache`.
+// Start one per core; a worker that is killed loses only its current unit,
+// which the coordinator hands to someone else. Keeps reconnecting for -r
+// seconds if the coordinator is not up yet or goes away.
+int main(int argc, char* argv[])
+{
+    Distributed::WorkerConfig config;
+    config.coordinator.port = 7100;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "-h" && i + 1 < argc)
+        {
+            config.coordinator.address = argv[++i];
+        }
+        else if (argument == "-p" && i + 1 < argc)
+        {
+            config.coordinator.port = std::stoi(argv[++i]);
+        }
+        else if (argument == "-u" && i + 1 < argc)
+        {
+            config.coordinator.unixPath = argv[++i];
+        }
+        else if (argument == "-r" && i + 1 < argc)
+        {
+            config.retrySeconds = std::stoi(argv[++i]);
+        }
+        else if (argument == "-c" && i + 1 < argc)
+        {
+            config.cachePath = argv[++i];
+        }
+        else if (argument == "-m" && i + 1 < argc)
+        {
+            config.cacheMegabytes = std::stoull(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "usage: worker [-h host] [-p port] [-u socket path] [-r retry seconds] [-c cache file]"
+                         " [-m new cache MB]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        size_t units = Distributed::runWorker(config);
+        std::cerr << "worker: " << units << " units analysed" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "worker: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}